@@ -0,0 +1,229 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// number of queries per run
+constexpr auto queries_count = size_t{1'000'000};
+
+/**
+ * Random (src, dest, size) queries.
+ */
+struct Queries {
+  /// src NPU ID of each query
+  std::vector<DeviceId> srcs;
+
+  /// dest NPU ID of each query
+  std::vector<DeviceId> dests;
+
+  /// size of the chunk of each query
+  std::vector<ChunkSize> chunk_sizes;
+};
+
+/**
+ * Construct the BasicTopology of each dimension.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ * @param with_delay_tables false to drop the per-dimension delay tables
+ * @return BasicTopology of each dimension
+ */
+std::vector<std::unique_ptr<BasicTopology>> construct_dims(
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim,
+    const bool with_delay_tables) {
+  auto dims = std::vector<std::unique_ptr<BasicTopology>>();
+  for (auto dim = size_t{0}; dim < topologies_per_dim.size(); dim++) {
+    const auto npus_count = npus_count_per_dim[dim];
+    const Bandwidth bandwidth = 400.0 / static_cast<double>(dim + 1);
+    const Latency latency = 500.0 * static_cast<double>(dim + 1);
+    switch (topologies_per_dim[dim]) {
+      case TopologyBuildingBlock::Ring:
+        dims.push_back(std::make_unique<Ring>(npus_count, bandwidth, latency));
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        dims.push_back(
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+        break;
+      default:
+        dims.push_back(
+            std::make_unique<Switch>(npus_count, bandwidth, latency));
+        break;
+    }
+    if (!with_delay_tables) {
+      dims.back()->set_delay_table_capacity(0);
+    }
+  }
+  return dims;
+}
+
+/**
+ * Answer a query as MultiDimTopology::send() did before:
+ * vector addresses by repeated division, then a virtual send().
+ *
+ * @param dims BasicTopology of each dimension
+ * @param npus_count number of NPUs
+ * @param src src NPU ID
+ * @param dest dest NPU ID
+ * @param chunk_size size of the chunk
+ * @return time to send the chunk
+ */
+EventTime legacy_send(
+    const std::vector<std::unique_ptr<BasicTopology>>& dims,
+    const int npus_count,
+    const DeviceId src,
+    const DeviceId dest,
+    const ChunkSize chunk_size) {
+  const auto translate = [&](const DeviceId npu_id) {
+    auto address = std::vector<DeviceId>();
+    for (auto i = size_t{0}; i < dims.size(); i++) {
+      address.push_back(-1);
+    }
+    auto leftover = npu_id;
+    auto denominator = npus_count;
+    for (auto dim = static_cast<int>(dims.size()) - 1; dim >= 0; dim--) {
+      denominator /= dims[dim]->get_npus_count();
+      address[dim] = leftover / denominator;
+      leftover %= denominator;
+    }
+    return address;
+  };
+
+  const auto src_address = translate(src);
+  const auto dest_address = translate(dest);
+  auto dim = size_t{0};
+  while (src_address[dim] == dest_address[dim]) {
+    dim++;
+  }
+  return dims[dim]->send(src_address[dim], dest_address[dim], chunk_size);
+}
+
+/**
+ * Measure the cost of each query.
+ *
+ * @param queries queries to run
+ * @param send answers a query
+ * @param delays delay of each query, written back
+ * @return cost of each query in ns
+ */
+template <typename Send>
+double measure(
+    const Queries& queries,
+    const Send send,
+    std::vector<EventTime>& delays) {
+  delays.resize(queries_count);
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    delays[i] =
+        send(queries.srcs[i], queries.dests[i], queries.chunk_sizes[i]);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+      static_cast<double>(queries_count);
+}
+
+/**
+ * Compare the query cost before and after the allocation-free,
+ * devirtualized address translation.
+ *
+ * @param name name of the topology
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ */
+void run_comparison(
+    const std::string& name,
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  // legacy path on its own BasicTopology instances
+  const auto legacy_dims =
+      construct_dims(topologies_per_dim, npus_count_per_dim, false);
+
+  // translation only: no delay table at all
+  auto translated = MultiDimTopology();
+  for (auto& dim :
+       construct_dims(topologies_per_dim, npus_count_per_dim, false)) {
+    translated.append_dimension(std::move(dim));
+  }
+  const auto npus_count = translated.get_npus_count();
+
+  // random queries
+  auto queries = Queries();
+  auto generator = std::mt19937_64(0);
+  auto npu_distribution = std::uniform_int_distribution<int>(0, npus_count - 1);
+  auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 1 << 26);
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    const auto src = npu_distribution(generator);
+    auto dest = src;
+    while (dest == src) {
+      dest = npu_distribution(generator);
+    }
+    queries.srcs.push_back(src);
+    queries.dests.push_back(dest);
+    queries.chunk_sizes.push_back(size_distribution(generator));
+  }
+
+  auto legacy_delays = std::vector<EventTime>();
+  const auto legacy_ns = measure(
+      queries,
+      [&](const DeviceId src, const DeviceId dest, const ChunkSize size) {
+        return legacy_send(legacy_dims, npus_count, src, dest, size);
+      },
+      legacy_delays);
+
+  auto translated_delays = std::vector<EventTime>();
+  const auto translated_ns = measure(
+      queries,
+      [&](const DeviceId src, const DeviceId dest, const ChunkSize size) {
+        return translated.send(src, dest, size);
+      },
+      translated_delays);
+
+  std::cout << std::setw(24) << name << std::setw(8) << npus_count
+            << std::fixed << std::setprecision(1) << std::setw(14)
+            << legacy_ns << std::setw(14) << translated_ns << std::setw(11)
+            << legacy_ns / translated_ns << "x" << std::setw(8)
+            << ((legacy_delays == translated_delays) ? "yes" : "no")
+            << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "MultiDimTopology::send() without delay tables: "
+            << "vector + virtual vs. stack + dispatch" << std::endl;
+  std::cout << std::setw(24) << "topology" << std::setw(8) << "npus"
+            << std::setw(14) << "before (ns)" << std::setw(14)
+            << "after (ns)" << std::setw(12) << "speedup" << std::setw(8)
+            << "match" << std::endl;
+
+  using Block = TopologyBuildingBlock;
+  run_comparison("Ring_Ring", {Block::Ring, Block::Ring}, {32, 32});
+  run_comparison(
+      "Ring_FC_Switch",
+      {Block::Ring, Block::FullyConnected, Block::Switch},
+      {8, 8, 16});
+  run_comparison(
+      "Ring_FC_Ring_Switch",
+      {Block::Ring, Block::FullyConnected, Block::Ring, Block::Switch},
+      {4, 8, 4, 16});
+
+  return 0;
+}
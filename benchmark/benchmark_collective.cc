@@ -0,0 +1,183 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "congestion_aware/Collective.hh"
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/SimulationContext.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Measurement of a simulation run.
+ */
+struct RunResult {
+  /// wall-clock time of the simulation in ms
+  double elapsed_ms;
+
+  /// simulated completion time of the All-Reduce in ns
+  EventTime duration;
+};
+
+/**
+ * State of a hand-written Ring All-Reduce.
+ */
+struct HandWrittenRing {
+  /// topology of the simulation
+  Topology* topology;
+
+  /// number of NPUs of the Ring
+  int npus_count;
+
+  /// number of steps, 2 * (npus_count - 1)
+  int steps_count;
+
+  /// size of each chunk
+  ChunkSize chunk_size;
+};
+
+/**
+ * Heap-allocated context of a chunk of the hand-written Ring All-Reduce.
+ */
+struct StepContext {
+  /// state of the All-Reduce
+  HandWrittenRing* ring;
+
+  /// NPU sending the chunk
+  DeviceId src;
+
+  /// step of the chunk
+  int step;
+};
+
+/**
+ * Send the chunk of a step of the hand-written Ring All-Reduce,
+ * allocating its callback context.
+ *
+ * @param ring state of the All-Reduce
+ * @param src NPU sending the chunk
+ * @param step step of the chunk
+ */
+void send_step(
+    HandWrittenRing* const ring,
+    const DeviceId src,
+    const int step) {
+  const auto dest = (src + 1) % ring->npus_count;
+  auto* const context = new StepContext{ring, src, step};
+  ring->topology->send(ring->topology->make_chunk(
+      ring->chunk_size,
+      ring->topology->route(src, dest),
+      [](void* const arg) {
+        // the receiving NPU forwards the chunk in the next step
+        const auto* const context = static_cast<StepContext*>(arg);
+        const auto next_step = context->step + 1;
+        if (next_step < context->ring->steps_count) {
+          const auto dest = (context->src + 1) % context->ring->npus_count;
+          send_step(context->ring, dest, next_step);
+        }
+        delete context;
+      },
+      context));
+}
+
+/**
+ * Simulate a Ring All-Reduce with a per-chunk heap-allocated context,
+ * as written by hand before Collective.
+ *
+ * @param npus_count number of NPUs of the Ring
+ * @param collective_size size of the All-Reduce in bytes
+ * @return measurement of the run
+ */
+RunResult run_hand_written(
+    const int npus_count,
+    const ChunkSize collective_size) {
+  const auto topology = std::make_shared<Ring>(npus_count, 50.0, 500.0);
+  auto context = SimulationContext(topology);
+
+  const auto start = std::chrono::steady_clock::now();
+  auto ring = HandWrittenRing{
+      topology.get(),
+      npus_count,
+      2 * (npus_count - 1),
+      (collective_size + npus_count - 1) / npus_count};
+  for (auto src = 0; src < npus_count; src++) {
+    send_step(&ring, src, 0);
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  return {
+      std::chrono::duration<double, std::milli>(end - start).count(),
+      context.get_current_time()};
+}
+
+/**
+ * Simulate a Ring All-Reduce with Collective.
+ *
+ * @param npus_count number of NPUs of the Ring
+ * @param collective_size size of the All-Reduce in bytes
+ * @return measurement of the run
+ */
+RunResult run_collective(
+    const int npus_count,
+    const ChunkSize collective_size) {
+  const auto topology = std::make_shared<Ring>(npus_count, 50.0, 500.0);
+  auto context = SimulationContext(topology);
+
+  const auto start = std::chrono::steady_clock::now();
+  auto collective = Collective(
+      topology,
+      CollectiveType::AllReduce,
+      collective_size,
+      CollectiveAlgorithm::Ring);
+  collective.start();
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  return {
+      std::chrono::duration<double, std::milli>(end - start).count(),
+      collective.get_duration()};
+}
+
+} // namespace
+
+int main() {
+  std::cout << "Ring All-Reduce: Collective vs. hand-written chunk loop"
+            << std::endl;
+  std::cout << std::setw(6) << "npus" << std::setw(10) << "size (MB)"
+            << std::setw(16) << "duration (ns)" << std::setw(14)
+            << "hand (ms)" << std::setw(14) << "coll (ms)" << std::setw(10)
+            << "speedup" << std::setw(10) << "match" << std::endl;
+
+  for (const auto npus_count : {64, 256, 1024}) {
+    // sweep of collective sizes, 1 MB to 1 GB
+    for (auto size_mb = 1; size_mb <= 1024; size_mb *= 4) {
+      const auto collective_size = static_cast<ChunkSize>(size_mb) << 20;
+      const auto hand_written = run_hand_written(npus_count, collective_size);
+      const auto collective = run_collective(npus_count, collective_size);
+
+      std::cout << std::setw(6) << npus_count << std::setw(10) << size_mb
+                << std::setw(16) << collective.duration << std::fixed
+                << std::setprecision(2) << std::setw(14)
+                << hand_written.elapsed_ms << std::setw(14)
+                << collective.elapsed_ms << std::setprecision(1)
+                << std::setw(9)
+                << hand_written.elapsed_ms / collective.elapsed_ms << "x"
+                << std::setw(10)
+                << ((hand_written.duration == collective.duration) ? "yes"
+                                                                   : "no")
+                << std::endl;
+    }
+  }
+
+  return 0;
+}
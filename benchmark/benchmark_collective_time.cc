@@ -0,0 +1,197 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/NetworkFunction.hh"
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/**
+ * Construct a multi-dimensional topology.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ * @return constructed topology
+ */
+std::unique_ptr<MultiDimTopology> construct(
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  auto topology = std::make_unique<MultiDimTopology>();
+  for (auto dim = size_t{0}; dim < topologies_per_dim.size(); dim++) {
+    const auto npus_count = npus_count_per_dim[dim];
+    const Bandwidth bandwidth = 400.0 / static_cast<double>(dim + 1);
+    const Latency latency = 500.0 * static_cast<double>(dim + 1);
+    switch (topologies_per_dim[dim]) {
+      case TopologyBuildingBlock::Ring:
+        topology->append_dimension(
+            std::make_unique<Ring>(npus_count, bandwidth, latency));
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        topology->append_dimension(
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+        break;
+      default:
+        topology->append_dimension(
+            std::make_unique<Switch>(npus_count, bandwidth, latency));
+        break;
+    }
+  }
+  return topology;
+}
+
+/**
+ * Estimate a hierarchical All-Reduce by composing point-to-point sends:
+ * every NPU issues the send() of each step,
+ * and each step takes as long as its longest send.
+ *
+ * @param topology topology to run the All-Reduce on
+ * @param topologies_per_dim building block of each dimension
+ * @param collective_size size of the All-Reduce in bytes
+ * @return time to run the All-Reduce
+ */
+EventTime compose_sends(
+    const MultiDimTopology& topology,
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const ChunkSize collective_size) {
+  const auto npus_count = topology.get_npus_count();
+  const auto npus_count_per_dim = topology.get_npus_count_per_dim();
+  const auto dims_count = topology.get_dims_count();
+
+  // time of a step where each NPU sends a chunk to the NPU at a rank offset
+  auto stride = 1;
+  auto step_time = [&](const int dim, const int offset, const ChunkSize size) {
+    const auto p = npus_count_per_dim[dim];
+    auto time = EventTime{0};
+    for (auto src = 0; src < npus_count; src++) {
+      const auto rank = (src / stride) % p;
+      const auto dest = src + ((((rank + offset) % p) - rank) * stride);
+      time = std::max(time, topology.send(src, dest, size));
+    }
+    return time;
+  };
+
+  // Reduce-Scatter and All-Gather have the same steps in each dimension
+  auto total_time = EventTime{0};
+  auto scattered_npus_count = uint64_t{1};
+  for (auto dim = 0; dim < dims_count; dim++) {
+    const auto p = npus_count_per_dim[dim];
+    const auto chunk_size =
+        split_size(split_size(collective_size, scattered_npus_count), p);
+    if (topologies_per_dim[dim] == TopologyBuildingBlock::Ring) {
+      // Ring: p - 1 steps to the neighbor
+      for (auto step = 0; step < p - 1; step++) {
+        total_time += 2 * step_time(dim, 1, chunk_size);
+      }
+    } else {
+      // Direct: one step to every other NPU
+      auto time = EventTime{0};
+      for (auto offset = 1; offset < p; offset++) {
+        time = std::max(time, step_time(dim, offset, chunk_size));
+      }
+      total_time += 2 * time;
+    }
+    scattered_npus_count *= p;
+    stride *= p;
+  }
+  return total_time;
+}
+
+/**
+ * Compare the closed form against composing point-to-point sends.
+ *
+ * @param name name of the topology
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ */
+void run_comparison(
+    const std::string& name,
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  const auto topology = construct(topologies_per_dim, npus_count_per_dim);
+
+  // sweep of collective sizes, 1 MB to 1 GB
+  auto sizes = std::vector<ChunkSize>();
+  for (auto size_mb = ChunkSize{1}; size_mb <= 1024; size_mb *= 4) {
+    sizes.push_back(size_mb << 20);
+  }
+
+  // composed sends
+  auto composed = std::vector<EventTime>();
+  const auto composed_start = std::chrono::steady_clock::now();
+  for (const auto size : sizes) {
+    composed.push_back(compose_sends(*topology, topologies_per_dim, size));
+  }
+  const auto composed_end = std::chrono::steady_clock::now();
+
+  // closed form, repeated for a measurable wall-clock time
+  const auto repeats = 10'000;
+  auto closed_form = std::vector<EventTime>(sizes.size());
+  const auto closed_form_start = std::chrono::steady_clock::now();
+  for (auto repeat = 0; repeat < repeats; repeat++) {
+    for (auto i = size_t{0}; i < sizes.size(); i++) {
+      closed_form[i] =
+          topology->collective_time(CollectiveType::AllReduce, sizes[i]);
+    }
+  }
+  const auto closed_form_end = std::chrono::steady_clock::now();
+
+  // per-query wall-clock time in us
+  const auto queries_count = static_cast<double>(sizes.size());
+  const auto composed_us = std::chrono::duration<double, std::micro>(
+                               composed_end - composed_start)
+                               .count() /
+      queries_count;
+  const auto closed_form_us = std::chrono::duration<double, std::micro>(
+                                  closed_form_end - closed_form_start)
+                                  .count() /
+      (queries_count * repeats);
+
+  std::cout << std::setw(24) << name << std::setw(8)
+            << topology->get_npus_count() << std::fixed
+            << std::setprecision(3) << std::setw(16) << composed_us
+            << std::setw(16) << closed_form_us << std::setprecision(0)
+            << std::setw(12) << composed_us / closed_form_us << "x"
+            << std::setw(8) << ((composed == closed_form) ? "yes" : "no")
+            << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "All-Reduce time: closed form vs. composed point-to-point sends"
+            << std::endl;
+  std::cout << std::setw(24) << "topology" << std::setw(8) << "npus"
+            << std::setw(16) << "composed (us)" << std::setw(16)
+            << "closed (us)" << std::setw(13) << "speedup" << std::setw(8)
+            << "match" << std::endl;
+
+  using Block = TopologyBuildingBlock;
+  run_comparison("Ring", {Block::Ring}, {1024});
+  run_comparison("Switch", {Block::Switch}, {1024});
+  run_comparison(
+      "Ring_FC_Switch",
+      {Block::Ring, Block::FullyConnected, Block::Switch},
+      {8, 8, 16});
+  run_comparison(
+      "Ring_FC_Ring_Switch",
+      {Block::Ring, Block::FullyConnected, Block::Ring, Block::Switch},
+      {4, 8, 4, 16});
+
+  return 0;
+}
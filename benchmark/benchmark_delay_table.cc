@@ -0,0 +1,162 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// number of queries per run
+constexpr auto queries_count = size_t{1'000'000};
+
+/**
+ * Construct a multi-dimensional topology.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ * @return constructed topology
+ */
+std::unique_ptr<Topology> construct(
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  auto topology = std::make_unique<MultiDimTopology>();
+  for (auto dim = size_t{0}; dim < topologies_per_dim.size(); dim++) {
+    const auto npus_count = npus_count_per_dim[dim];
+    const Bandwidth bandwidth = 400.0 / static_cast<double>(dim + 1);
+    const Latency latency = 500.0 * static_cast<double>(dim + 1);
+    switch (topologies_per_dim[dim]) {
+      case TopologyBuildingBlock::Ring:
+        topology->append_dimension(
+            std::make_unique<Ring>(npus_count, bandwidth, latency));
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        topology->append_dimension(
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+        break;
+      default:
+        topology->append_dimension(
+            std::make_unique<Switch>(npus_count, bandwidth, latency));
+        break;
+    }
+  }
+  return topology;
+}
+
+/**
+ * Run random send() queries.
+ *
+ * @param topology topology to query
+ * @param delays delay of each query, written back
+ * @return throughput in million queries per second
+ */
+double run_queries(const Topology& topology, std::vector<EventTime>& delays) {
+  // random (src, dest, size) queries
+  const auto npus_count = topology.get_npus_count();
+  auto generator = std::mt19937_64(0);
+  auto npu_distribution = std::uniform_int_distribution<int>(0, npus_count - 1);
+  auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 1 << 26);
+  auto srcs = std::vector<DeviceId>(queries_count);
+  auto dests = std::vector<DeviceId>(queries_count);
+  auto chunk_sizes = std::vector<ChunkSize>(queries_count);
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    srcs[i] = npu_distribution(generator);
+    do {
+      dests[i] = npu_distribution(generator);
+    } while (dests[i] == srcs[i]);
+    chunk_sizes[i] = size_distribution(generator);
+  }
+
+  delays.resize(queries_count);
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    delays[i] = topology.send(srcs[i], dests[i], chunk_sizes[i]);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto elapsed_s = std::chrono::duration<double>(end - start).count();
+  return static_cast<double>(queries_count) / elapsed_s / 1e6;
+}
+
+/**
+ * Compare send() on the all-pairs table, on the per-dimension tables,
+ * and without any table.
+ *
+ * @param name name of the topology
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ */
+void run_comparison(
+    const std::string& name,
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  // construction, including the all-pairs table
+  const auto build_start = std::chrono::steady_clock::now();
+  const auto topology = construct(topologies_per_dim, npus_count_per_dim);
+  const auto build_end = std::chrono::steady_clock::now();
+  const auto build_ms =
+      std::chrono::duration<double, std::milli>(build_end - build_start)
+          .count();
+  const auto table_mb =
+      static_cast<double>(topology->get_delay_table().get_used_bytes()) /
+      (1 << 20);
+
+  auto all_pairs_delays = std::vector<EventTime>();
+  const auto all_pairs_mqps = run_queries(*topology, all_pairs_delays);
+
+  // memory-bounded: per-dimension tables only
+  topology->set_delay_table_capacity(0);
+  auto per_dim_delays = std::vector<EventTime>();
+  const auto per_dim_mqps = run_queries(*topology, per_dim_delays);
+
+  std::cout << std::setw(24) << name << std::setw(8)
+            << topology->get_npus_count() << std::fixed
+            << std::setprecision(1) << std::setw(12) << table_mb
+            << std::setw(12) << build_ms << std::setw(14) << per_dim_mqps
+            << std::setw(14) << all_pairs_mqps << std::setw(11)
+            << all_pairs_mqps / per_dim_mqps << "x" << std::setw(8)
+            << ((all_pairs_delays == per_dim_delays) ? "yes" : "no")
+            << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "1M send() queries: all-pairs vs. per-dimension delay tables"
+            << std::endl;
+  std::cout << std::setw(24) << "topology" << std::setw(8) << "npus"
+            << std::setw(12) << "table (MB)" << std::setw(12) << "build (ms)"
+            << std::setw(14) << "per-dim Mq/s" << std::setw(14)
+            << "all-pair Mq/s" << std::setw(12) << "speedup" << std::setw(8)
+            << "match" << std::endl;
+
+  using Block = TopologyBuildingBlock;
+  run_comparison("Ring", {Block::Ring}, {1024});
+  run_comparison(
+      "Ring_FC_Switch",
+      {Block::Ring, Block::FullyConnected, Block::Switch},
+      {8, 8, 16});
+  run_comparison(
+      "Ring_FC_Ring_Switch",
+      {Block::Ring, Block::FullyConnected, Block::Ring, Block::Switch},
+      {4, 8, 4, 16});
+  run_comparison(
+      "Ring_FC_Switch (large)",
+      {Block::Ring, Block::FullyConnected, Block::Switch},
+      {8, 8, 64});
+
+  return 0;
+}
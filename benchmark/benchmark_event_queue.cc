@@ -0,0 +1,222 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/EventQueue.hh"
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Shape of the scheduled event times.
+ *   - Distinct: random traffic, (almost) every event has its own time
+ *   - Clustered: collective-like, a few event times with many events each
+ */
+enum class Workload { Distinct, Clustered };
+
+/**
+ * State of the hold model:
+ * every invoked event schedules a new one at (current time + increment),
+ * so the number of outstanding events stays constant.
+ */
+template <typename Queue>
+struct HoldContext {
+  Queue* queue;
+  std::mt19937_64 rng;
+  std::uniform_int_distribution<EventTime> increment;
+  EventTime granularity;
+  size_t invoked_count;
+
+  EventTime next_increment() {
+    return increment(rng) * granularity;
+  }
+};
+
+template <typename Queue>
+void hold_callback(void* const arg) {
+  auto* const context = static_cast<HoldContext<Queue>*>(arg);
+  context->invoked_count++;
+
+  // keep the number of outstanding events constant
+  const auto current_time = context->queue->get_current_time();
+  const auto event_time = current_time + context->next_increment();
+  context->queue->schedule_event(event_time, hold_callback<Queue>, arg);
+}
+
+/**
+ * Measurement of a hold model run.
+ */
+struct HoldResult {
+  /// average time per hold operation in ns
+  double hold_ns;
+
+  /// peak bytes in use by the event queue arena
+  size_t peak_used_bytes;
+
+  /// system allocations of the arena during the measured holds
+  size_t system_allocations_count;
+};
+
+/**
+ * Run the hold model and measure the average time per hold operation.
+ *
+ * @param workload shape of the scheduled event times
+ * @param outstanding_count number of outstanding events
+ * @param holds_count number of hold operations to measure
+ * @return measurement of the run
+ */
+template <typename Queue>
+HoldResult run_hold_model(
+    const Workload workload,
+    const size_t outstanding_count,
+    const size_t holds_count) {
+  // distinct: increments in [1, 2N] ns
+  // clustered: increments in {1, ..., 4} x 1000 ns
+  const auto distinct = (workload == Workload::Distinct);
+  const auto max_increment =
+      distinct ? static_cast<EventTime>(2 * outstanding_count) : 4;
+  const auto granularity = distinct ? EventTime{1} : EventTime{1'000};
+
+  auto queue = Queue();
+  auto context = HoldContext<Queue>{
+      &queue,
+      std::mt19937_64(42),
+      std::uniform_int_distribution<EventTime>(1, max_increment),
+      granularity,
+      0};
+
+  // prefill in descending time order (best case for the sorted list)
+  auto event_times = std::vector<EventTime>();
+  for (size_t i = 0; i < outstanding_count; i++) {
+    event_times.push_back(context.next_increment());
+  }
+  std::sort(event_times.begin(), event_times.end(), std::greater<>());
+  for (const auto event_time : event_times) {
+    queue.schedule_event(event_time, hold_callback<Queue>, &context);
+  }
+
+  // measure hold operations
+  const auto& arena = queue.get_arena();
+  const auto system_allocations_count = arena.get_system_allocations_count();
+  const auto start = std::chrono::steady_clock::now();
+  while (context.invoked_count < holds_count) {
+    queue.proceed();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto elapsed_ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  return {
+      elapsed_ns / static_cast<double>(context.invoked_count),
+      arena.get_peak_used_bytes(),
+      arena.get_system_allocations_count() - system_allocations_count};
+}
+
+/**
+ * Print the average time per hold operation of every policy.
+ *
+ * @param workload shape of the scheduled event times
+ * @param outstanding_count number of outstanding events
+ */
+void run_policies(const Workload workload, const size_t outstanding_count) {
+  // hold operations measured per configuration
+  const size_t holds_count = 1'000'000;
+
+  // limit the sorted list to ~2 * 10^8 visited list nodes
+  const auto sorted_list_holds_count = std::clamp(
+      size_t{200'000'000} / outstanding_count, size_t{100}, holds_count);
+  const auto sorted_list =
+      (workload == Workload::Distinct)
+      ? run_hold_model<GenericEventQueue<SortedListQueue>>(
+            workload, outstanding_count, sorted_list_holds_count)
+      : run_hold_model<GenericEventQueue<SortedListQueue>>(
+            workload, outstanding_count, holds_count);
+
+  const auto calendar = run_hold_model<GenericEventQueue<CalendarQueue>>(
+      workload, outstanding_count, holds_count);
+  const auto radix = run_hold_model<GenericEventQueue<RadixHeapQueue>>(
+      workload, outstanding_count, holds_count);
+  const auto binary = run_hold_model<GenericEventQueue<BinaryHeapQueue>>(
+      workload, outstanding_count, holds_count);
+  const auto pairing = run_hold_model<GenericEventQueue<PairingHeapQueue>>(
+      workload, outstanding_count, holds_count);
+
+  const auto workload_name =
+      (workload == Workload::Distinct) ? "distinct" : "clustered";
+  std::cout << std::setw(10) << workload_name << std::setw(12)
+            << outstanding_count << std::fixed << std::setprecision(1)
+            << std::setw(14) << sorted_list.hold_ns << std::setw(12)
+            << calendar.hold_ns << std::setw(12) << radix.hold_ns
+            << std::setw(12) << binary.hold_ns << std::setw(12)
+            << pairing.hold_ns << std::endl;
+}
+
+/**
+ * Print the arena usage of a policy.
+ *
+ * @param policy_name name of the policy
+ * @param result measurement of the policy
+ */
+void print_arena_usage(const char* const policy_name, const HoldResult& result) {
+  const auto peak_used_mib =
+      static_cast<double>(result.peak_used_bytes) / (1024.0 * 1024.0);
+  std::cout << std::setw(14) << policy_name << std::fixed
+            << std::setprecision(1) << std::setw(16) << peak_used_mib
+            << std::setw(20) << result.system_allocations_count << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "average time per hold operation (ns)" << std::endl;
+  std::cout << std::setw(10) << "workload" << std::setw(12) << "outstanding"
+            << std::setw(14) << "SortedList" << std::setw(12) << "Calendar"
+            << std::setw(12) << "RadixHeap" << std::setw(12) << "BinaryHeap"
+            << std::setw(12) << "PairingHeap" << std::endl;
+
+  for (const auto workload : {Workload::Distinct, Workload::Clustered}) {
+    for (const size_t outstanding_count :
+         {10'000, 100'000, 1'000'000, 2'000'000}) {
+      run_policies(workload, outstanding_count);
+    }
+  }
+
+  // arena usage at 10^6 outstanding events with distinct times
+  const auto workload = Workload::Distinct;
+  const size_t outstanding_count = 1'000'000;
+  const size_t holds_count = 1'000'000;
+  std::cout << std::endl
+            << "arena usage (distinct, " << outstanding_count
+            << " outstanding)" << std::endl;
+  std::cout << std::setw(14) << "policy" << std::setw(16) << "peak used (MiB)"
+            << std::setw(20) << "system allocations" << std::endl;
+  print_arena_usage(
+      "Calendar",
+      run_hold_model<GenericEventQueue<CalendarQueue>>(
+          workload, outstanding_count, holds_count));
+  print_arena_usage(
+      "RadixHeap",
+      run_hold_model<GenericEventQueue<RadixHeapQueue>>(
+          workload, outstanding_count, holds_count));
+  print_arena_usage(
+      "BinaryHeap",
+      run_hold_model<GenericEventQueue<BinaryHeapQueue>>(
+          workload, outstanding_count, holds_count));
+  print_arena_usage(
+      "PairingHeap",
+      run_hold_model<GenericEventQueue<PairingHeapQueue>>(
+          workload, outstanding_count, holds_count));
+
+  return 0;
+}
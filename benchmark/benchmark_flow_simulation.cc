@@ -0,0 +1,165 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "congestion_aware/FlowSimulation.hh"
+#include "congestion_aware/FullyConnected.hh"
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/SimulationContext.hh"
+#include "congestion_aware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Measurement of an All-to-All run.
+ */
+struct AllToAllResult {
+  /// wall-clock time of the simulation in ms
+  double elapsed_ms;
+
+  /// simulated finish time in ns
+  EventTime finish_time;
+};
+
+/**
+ * Run an All-to-All with the packet engine,
+ * splitting each message into chunks.
+ *
+ * @param topology topology to simulate
+ * @param message_size size of each message
+ * @param chunks_count number of chunks per message
+ * @return measurement of the run
+ */
+AllToAllResult run_packet(
+    const std::shared_ptr<Topology>& topology,
+    const ChunkSize message_size,
+    const int chunks_count) {
+  const auto npus_count = topology->get_npus_count();
+  auto context = SimulationContext(topology);
+
+  // every NPU sends a message to every other NPU
+  const auto start = std::chrono::steady_clock::now();
+  const auto chunk_size = message_size / chunks_count;
+  const auto callback = [](void* const) {};
+  for (auto i = 0; i < npus_count; i++) {
+    for (auto j = 0; j < npus_count; j++) {
+      if (i == j) {
+        continue;
+      }
+      const auto route = topology->route(i, j);
+      for (auto c = 0; c < chunks_count; c++) {
+        topology->send(
+            topology->make_chunk(chunk_size, route, callback, nullptr));
+      }
+    }
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto elapsed_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  return {elapsed_ms, context.get_current_time()};
+}
+
+/**
+ * Run an All-to-All with the flow engine, one flow per message.
+ *
+ * @param topology topology to simulate
+ * @param message_size size of each message
+ * @return measurement of the run
+ */
+AllToAllResult run_flow(
+    const std::shared_ptr<Topology>& topology,
+    const ChunkSize message_size) {
+  const auto npus_count = topology->get_npus_count();
+  auto context = SimulationContext(topology);
+  auto simulation = FlowSimulation(topology);
+
+  // every NPU sends a message to every other NPU
+  const auto start = std::chrono::steady_clock::now();
+  const auto callback = [](void* const) {};
+  for (auto i = 0; i < npus_count; i++) {
+    for (auto j = 0; j < npus_count; j++) {
+      if (i != j) {
+        simulation.send(
+            message_size, topology->route(i, j), callback, nullptr);
+      }
+    }
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto elapsed_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  return {elapsed_ms, context.get_current_time()};
+}
+
+/**
+ * Compare the flow engine against the packet engine on a topology.
+ *
+ * @param name name of the topology
+ * @param make_topology function constructing a fresh topology
+ */
+void run_comparison(
+    const char* const name,
+    const std::function<std::shared_ptr<Topology>()>& make_topology) {
+  const ChunkSize message_size = 1'048'576;
+
+  // packet engine at decreasing chunk sizes, then the flow engine
+  for (const auto chunks_count : {1, 4, 16}) {
+    const auto packet =
+        run_packet(make_topology(), message_size, chunks_count);
+    std::cout << std::setw(14) << name << std::setw(10) << "packet"
+              << std::setw(8) << chunks_count << std::fixed
+              << std::setprecision(1) << std::setw(14) << packet.elapsed_ms
+              << std::setw(14) << packet.finish_time << std::endl;
+  }
+
+  // the packet engine with the finest chunks is the reference
+  const auto reference = run_packet(make_topology(), message_size, 16);
+  const auto flow = run_flow(make_topology(), message_size);
+  const auto error = 100.0 *
+      (static_cast<double>(flow.finish_time) -
+       static_cast<double>(reference.finish_time)) /
+      static_cast<double>(reference.finish_time);
+  std::cout << std::setw(14) << name << std::setw(10) << "flow"
+            << std::setw(8) << "-" << std::fixed << std::setprecision(1)
+            << std::setw(14) << flow.elapsed_ms << std::setw(14)
+            << flow.finish_time << std::setw(11) << std::setprecision(2)
+            << error << " %" << std::setw(10) << std::setprecision(1)
+            << reference.elapsed_ms / flow.elapsed_ms << "x" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "All-to-All of 1 MB messages, flow vs. packet engine"
+            << std::endl;
+  std::cout << std::setw(14) << "topology" << std::setw(10) << "engine"
+            << std::setw(8) << "chunks" << std::setw(14) << "elapsed (ms)"
+            << std::setw(14) << "finish (ns)" << std::setw(13) << "error"
+            << std::setw(11) << "speedup" << std::endl;
+
+  run_comparison("Ring-64", []() {
+    return std::make_shared<Ring>(64, 50.0, 500.0);
+  });
+  run_comparison("FC-64", []() {
+    return std::make_shared<FullyConnected>(64, 50.0, 500.0);
+  });
+  run_comparison("Switch-256", []() {
+    return std::make_shared<Switch>(256, 50.0, 500.0);
+  });
+
+  return 0;
+}
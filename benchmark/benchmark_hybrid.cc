@@ -0,0 +1,212 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/SimulationContext.hh"
+#include "congestion_aware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// number of chunks per run
+constexpr auto chunks_count = size_t{50'000};
+
+/// size of each chunk
+constexpr auto chunk_size = ChunkSize{65'536};
+
+/**
+ * Chunk injected into the network at a given time.
+ */
+struct Injection {
+  /// time the chunk is sent
+  EventTime time;
+
+  /// src NPU id
+  DeviceId src;
+
+  /// dest NPU id
+  DeviceId dest;
+};
+
+/**
+ * Measurement of a simulation run.
+ */
+struct RunResult {
+  /// wall-clock time of the simulation in ms
+  double elapsed_ms;
+
+  /// number of events scheduled into the event queue
+  uint64_t events_count;
+
+  /// arrival time of each chunk in ns
+  std::vector<EventTime> arrival_times;
+};
+
+/**
+ * State of a run, shared by the injection and arrival callbacks.
+ */
+struct RunState {
+  /// topology to send the chunks over
+  Topology* topology;
+
+  /// event queue of the simulation
+  EventQueue* event_queue;
+
+  /// chunks to inject
+  const std::vector<Injection>* injections;
+
+  /// arrival time of each chunk
+  EventTime* arrival_times;
+};
+
+/**
+ * Generate chunks between random NPU pairs, injected at random intervals.
+ *
+ * @param npus_count number of NPUs
+ * @param mean_interval mean time between two injections in ns
+ * @return chunks to inject, ordered by time
+ */
+std::vector<Injection> generate_traffic(
+    const int npus_count,
+    const double mean_interval) {
+  auto generator = std::mt19937_64(0);
+  auto npu_distribution = std::uniform_int_distribution<int>(0, npus_count - 1);
+  auto interval_distribution =
+      std::exponential_distribution<double>(1.0 / mean_interval);
+
+  auto injections = std::vector<Injection>();
+  auto time = 0.0;
+  for (auto i = size_t{0}; i < chunks_count; i++) {
+    time += interval_distribution(generator);
+    const auto src = npu_distribution(generator);
+    auto dest = src;
+    while (dest == src) {
+      dest = npu_distribution(generator);
+    }
+    injections.push_back({static_cast<EventTime>(time), src, dest});
+  }
+  return injections;
+}
+
+/**
+ * Simulate the injections on a topology.
+ *
+ * @param topology topology to simulate, not simulated before
+ * @param injections chunks to inject
+ * @param congestion_model congestion model of the topology
+ * @return measurement of the run
+ */
+RunResult run(
+    const std::shared_ptr<Topology>& topology,
+    const std::vector<Injection>& injections,
+    const CongestionModel congestion_model) {
+  topology->set_congestion_model(congestion_model);
+  auto context = SimulationContext(topology);
+  const auto event_queue = context.get_event_queue();
+
+  auto result =
+      RunResult{0.0, 0, std::vector<EventTime>(injections.size(), 0)};
+  auto state = RunState{
+      topology.get(),
+      event_queue.get(),
+      &injections,
+      result.arrival_times.data()};
+  auto* const state_ptr = &state;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = size_t{0}; i < injections.size(); i++) {
+    event_queue->schedule_event(injections[i].time, [state_ptr, i]() {
+      const auto& injection = (*state_ptr->injections)[i];
+      auto* const topology = state_ptr->topology;
+      topology->send(topology->make_chunk(
+          chunk_size,
+          topology->route(injection.src, injection.dest),
+          [state_ptr, i]() {
+            state_ptr->arrival_times[i] =
+                state_ptr->event_queue->get_current_time();
+          }));
+    });
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  result.elapsed_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  result.events_count = event_queue->get_scheduled_events_count();
+  return result;
+}
+
+/**
+ * Compare the hybrid model against the hop-by-hop model.
+ *
+ * @param name name of the topology
+ * @param make_topology callable constructing a fresh topology
+ * @param mean_interval mean time between two injections in ns
+ */
+template <typename MakeTopology>
+void run_comparison(
+    const char* const name,
+    const MakeTopology make_topology,
+    const double mean_interval) {
+  const auto topology = make_topology();
+  const auto injections =
+      generate_traffic(topology->get_npus_count(), mean_interval);
+  const auto hop_by_hop =
+      run(topology, injections, CongestionModel::HopByHop);
+  const auto hybrid =
+      run(make_topology(), injections, CongestionModel::Hybrid);
+
+  auto identical_count = size_t{0};
+  for (auto i = size_t{0}; i < injections.size(); i++) {
+    identical_count +=
+        (hybrid.arrival_times[i] == hop_by_hop.arrival_times[i]) ? 1 : 0;
+  }
+
+  std::cout << std::setw(12) << name << std::setw(10)
+            << static_cast<int>(mean_interval) << std::setw(12)
+            << hop_by_hop.events_count << std::setw(12) << hybrid.events_count
+            << std::fixed << std::setprecision(1) << std::setw(12)
+            << hop_by_hop.elapsed_ms << std::setw(12) << hybrid.elapsed_ms
+            << std::setw(9) << hop_by_hop.elapsed_ms / hybrid.elapsed_ms
+            << "x" << std::setw(10)
+            << 100.0 * static_cast<double>(identical_count) /
+                   static_cast<double>(injections.size())
+            << " %" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "Hybrid vs. hop-by-hop congestion model, "
+            << "random chunks injected at random intervals" << std::endl;
+  std::cout << std::setw(12) << "topology" << std::setw(10) << "interval"
+            << std::setw(12) << "events hop" << std::setw(12) << "events hyb"
+            << std::setw(12) << "hop (ms)" << std::setw(12) << "hyb (ms)"
+            << std::setw(10) << "speedup" << std::setw(12) << "identical"
+            << std::endl;
+
+  // sparse, then denser traffic
+  for (const auto mean_interval : {20'000.0, 2'000.0, 200.0}) {
+    run_comparison(
+        "Ring(128)",
+        []() { return std::make_shared<Ring>(128, 50.0, 500.0); },
+        mean_interval);
+    run_comparison(
+        "Switch(128)",
+        []() { return std::make_shared<Switch>(128, 50.0, 500.0); },
+        mean_interval);
+  }
+
+  return 0;
+}
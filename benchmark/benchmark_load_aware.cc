@@ -0,0 +1,167 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// number of queries per run
+constexpr auto queries_count = size_t{1'000'000};
+
+/// time window the all-to-all traffic is offered over, in ns
+constexpr auto traffic_duration = EventTime{100'000'000};
+
+/**
+ * Construct a multi-dimensional topology.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ * @return constructed topology
+ */
+std::unique_ptr<Topology> construct(
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  auto topology = std::make_unique<MultiDimTopology>();
+  for (auto dim = size_t{0}; dim < topologies_per_dim.size(); dim++) {
+    const auto npus_count = npus_count_per_dim[dim];
+    const Bandwidth bandwidth = 400.0 / static_cast<double>(dim + 1);
+    const Latency latency = 500.0 * static_cast<double>(dim + 1);
+    switch (topologies_per_dim[dim]) {
+      case TopologyBuildingBlock::Ring:
+        topology->append_dimension(
+            std::make_unique<Ring>(npus_count, bandwidth, latency));
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        topology->append_dimension(
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+        break;
+      default:
+        topology->append_dimension(
+            std::make_unique<Switch>(npus_count, bandwidth, latency));
+        break;
+    }
+  }
+  return topology;
+}
+
+/**
+ * Run random send_batch() queries.
+ *
+ * @param topology topology to query
+ * @return throughput in million queries per second
+ */
+double run_queries(const Topology& topology) {
+  // random (src, dest, size) queries
+  const auto npus_count = topology.get_npus_count();
+  auto generator = std::mt19937_64(0);
+  auto npu_distribution = std::uniform_int_distribution<int>(0, npus_count - 1);
+  auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 1 << 26);
+  auto srcs = std::vector<DeviceId>(queries_count);
+  auto dests = std::vector<DeviceId>(queries_count);
+  auto chunk_sizes = std::vector<ChunkSize>(queries_count);
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    srcs[i] = npu_distribution(generator);
+    do {
+      dests[i] = npu_distribution(generator);
+    } while (dests[i] == srcs[i]);
+    chunk_sizes[i] = size_distribution(generator);
+  }
+
+  auto delays = std::vector<EventTime>(queries_count);
+  const auto start = std::chrono::steady_clock::now();
+  topology.send_batch(
+      srcs.data(),
+      dests.data(),
+      chunk_sizes.data(),
+      delays.data(),
+      queries_count);
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto elapsed_s = std::chrono::duration<double>(end - start).count();
+  return static_cast<double>(queries_count) / elapsed_s / 1e6;
+}
+
+/**
+ * Compare the congestion-unaware and load-aware query throughput,
+ * loading the topology with a random all-to-all traffic matrix.
+ *
+ * @param name name of the topology
+ * @param topology topology to query
+ */
+void run_comparison(const std::string& name, Topology& topology) {
+  const auto unaware_mqps = run_queries(topology);
+
+  // random all-to-all traffic matrix
+  const auto npus_count = topology.get_npus_count();
+  auto generator = std::mt19937_64(1);
+  auto size_distribution = std::uniform_int_distribution<ChunkSize>(0, 1 << 20);
+  auto traffic_matrix =
+      std::vector<ChunkSize>(static_cast<size_t>(npus_count) * npus_count);
+  for (auto& chunk_size : traffic_matrix) {
+    chunk_size = size_distribution(generator);
+  }
+
+  const auto register_start = std::chrono::steady_clock::now();
+  topology.set_traffic_matrix(traffic_matrix.data(), traffic_duration);
+  const auto register_end = std::chrono::steady_clock::now();
+  const auto register_ms =
+      std::chrono::duration<double, std::milli>(register_end - register_start)
+          .count();
+
+  const auto load_aware_mqps = run_queries(topology);
+
+  auto max_utilization = 0.0;
+  for (const auto utilization : topology.get_utilization_per_dim()) {
+    max_utilization = std::max(max_utilization, utilization);
+  }
+
+  std::cout << std::setw(24) << name << std::setw(8) << npus_count
+            << std::fixed << std::setprecision(2) << std::setw(10)
+            << max_utilization << std::setprecision(1) << std::setw(14)
+            << register_ms << std::setw(16) << unaware_mqps << std::setw(16)
+            << load_aware_mqps << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "1M send_batch() queries: congestion-unaware vs. load-aware"
+            << std::endl;
+  std::cout << std::setw(24) << "topology" << std::setw(8) << "npus"
+            << std::setw(10) << "max util" << std::setw(14)
+            << "register (ms)" << std::setw(16) << "unaware Mq/s"
+            << std::setw(16) << "loaded Mq/s" << std::endl;
+
+  using Block = TopologyBuildingBlock;
+  auto ring = Ring(1024, 50.0, 500.0);
+  run_comparison("Ring", ring);
+  auto switch_topology = Switch(1024, 50.0, 500.0);
+  run_comparison("Switch", switch_topology);
+  run_comparison(
+      "Ring_FC_Switch",
+      *construct(
+          {Block::Ring, Block::FullyConnected, Block::Switch}, {8, 8, 16}));
+  run_comparison(
+      "Ring_FC_Ring_Switch",
+      *construct(
+          {Block::Ring, Block::FullyConnected, Block::Ring, Block::Switch},
+          {4, 8, 4, 16}));
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "common/NetworkFunction.hh"
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/SimulationContext.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Measurement of a simulation run.
+ */
+struct RunResult {
+  /// wall-clock time of the simulation in ms
+  double elapsed_ms;
+
+  /// simulated time the last message arrived in ns
+  EventTime finish_time;
+};
+
+/**
+ * Heap-allocated context of a chunk split by hand.
+ */
+struct ChunkContext {
+  /// number of chunks of the message not arrived yet
+  int* pending_chunks_count;
+
+  /// number of messages not arrived yet
+  int* pending_messages_count;
+};
+
+/// number of NPUs of the Ring
+constexpr auto npus_count = 64;
+
+/// size of each message
+constexpr auto message_size = ChunkSize{64} << 20;
+
+/**
+ * Send a message from every NPU to the NPU half the Ring away,
+ * splitting the messages into chunks by hand,
+ * with a heap-allocated context per chunk.
+ *
+ * @param chunks_count number of chunks per message
+ * @return measurement of the run
+ */
+RunResult run_hand_split(const int chunks_count) {
+  const auto topology = std::make_shared<Ring>(npus_count, 50.0, 500.0);
+  auto context = SimulationContext(topology);
+
+  const auto start = std::chrono::steady_clock::now();
+  auto pending_chunks_count = std::vector<int>(npus_count, chunks_count);
+  auto pending_messages_count = npus_count;
+  const auto chunk_size = split_size(message_size, chunks_count);
+  for (auto src = 0; src < npus_count; src++) {
+    const auto dest = (src + (npus_count / 2)) % npus_count;
+    for (auto i = 0; i < chunks_count; i++) {
+      auto* const chunk_context = new ChunkContext{
+          &pending_chunks_count[src], &pending_messages_count};
+      topology->send(topology->make_chunk(
+          chunk_size,
+          topology->route(src, dest),
+          [](void* const arg) {
+            // the message arrived with its last chunk
+            auto* const chunk_context = static_cast<ChunkContext*>(arg);
+            if (--(*chunk_context->pending_chunks_count) == 0) {
+              (*chunk_context->pending_messages_count)--;
+            }
+            delete chunk_context;
+          },
+          chunk_context));
+    }
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  return {
+      std::chrono::duration<double, std::milli>(end - start).count(),
+      context.get_current_time()};
+}
+
+/**
+ * Send a message from every NPU to the NPU half the Ring away,
+ * with Topology::send_message_in_chunks().
+ *
+ * @param chunks_count number of chunks per message
+ * @return measurement of the run
+ */
+RunResult run_message(const int chunks_count) {
+  const auto topology = std::make_shared<Ring>(npus_count, 50.0, 500.0);
+  auto context = SimulationContext(topology);
+
+  const auto start = std::chrono::steady_clock::now();
+  auto pending_messages_count = npus_count;
+  auto* const pending_messages_count_ptr = &pending_messages_count;
+  for (auto src = 0; src < npus_count; src++) {
+    const auto dest = (src + (npus_count / 2)) % npus_count;
+    topology->send_message_in_chunks(
+        src,
+        dest,
+        message_size,
+        chunks_count,
+        [pending_messages_count_ptr]() { (*pending_messages_count_ptr)--; });
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  return {
+      std::chrono::duration<double, std::milli>(end - start).count(),
+      context.get_current_time()};
+}
+
+} // namespace
+
+int main() {
+  std::cout << "64 MB messages on a 64-NPU Ring: "
+            << "send_message vs. hand-split chunks" << std::endl;
+  std::cout << std::setw(8) << "chunks" << std::setw(18) << "finish (ns)"
+            << std::setw(14) << "hand (ms)" << std::setw(14) << "msg (ms)"
+            << std::setw(10) << "speedup" << std::setw(10) << "match"
+            << std::endl;
+
+  // sweep of pipelining granularity
+  for (auto chunks_count = 1; chunks_count <= 4096; chunks_count *= 4) {
+    const auto hand_split = run_hand_split(chunks_count);
+    const auto message = run_message(chunks_count);
+
+    std::cout << std::setw(8) << chunks_count << std::setw(18)
+              << message.finish_time << std::fixed << std::setprecision(2)
+              << std::setw(14) << hand_split.elapsed_ms << std::setw(14)
+              << message.elapsed_ms << std::setprecision(1) << std::setw(9)
+              << hand_split.elapsed_ms / message.elapsed_ms << "x"
+              << std::setw(10)
+              << ((hand_split.finish_time == message.finish_time) ? "yes"
+                                                                  : "no")
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "congestion_aware/Chunk.hh"
+#include "congestion_aware/ParallelSimulation.hh"
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Measurement of a parallel All-to-All run.
+ */
+struct AllToAllResult {
+  /// wall-clock time of the simulation in ms
+  double elapsed_ms;
+
+  /// simulated finish time in ns
+  EventTime finish_time;
+};
+
+/**
+ * Run an All-to-All on a topology with the parallel simulation.
+ *
+ * @param topology topology to simulate
+ * @param threads_count number of worker threads
+ * @param chunk_size size of each chunk
+ * @return measurement of the run
+ */
+AllToAllResult run_all_to_all(
+    const std::shared_ptr<Topology>& topology,
+    const int threads_count,
+    const ChunkSize chunk_size) {
+  const auto npus_count = topology->get_npus_count();
+  auto simulation = ParallelSimulation(topology, threads_count);
+
+  // every NPU sends a chunk to every other NPU
+  const auto callback = [](void* const) {};
+  for (auto i = 0; i < npus_count; i++) {
+    for (auto j = 0; j < npus_count; j++) {
+      if (i != j) {
+        topology->send(std::make_unique<Chunk>(
+            chunk_size, topology->route(i, j), callback, nullptr));
+      }
+    }
+  }
+
+  // measure the simulation
+  const auto start = std::chrono::steady_clock::now();
+  simulation.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto elapsed_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  return {elapsed_ms, simulation.get_current_time()};
+}
+
+/**
+ * Print the scaling of the parallel simulation over the number of threads.
+ *
+ * @param name name of the topology
+ * @param max_threads_count max number of worker threads
+ * @param make_topology function constructing a fresh topology
+ */
+template <typename MakeTopology>
+void run_scaling(
+    const char* const name,
+    const int max_threads_count,
+    const MakeTopology& make_topology) {
+  const ChunkSize chunk_size = 65'536;
+
+  // thread counts: powers of two up to max_threads_count
+  auto threads_counts = std::vector<int>{1};
+  while (threads_counts.back() * 2 <= max_threads_count) {
+    threads_counts.push_back(threads_counts.back() * 2);
+  }
+
+  auto sequential_ms = 0.0;
+  auto sequential_finish_time = EventTime{0};
+  for (const auto threads_count : threads_counts) {
+    const auto result =
+        run_all_to_all(make_topology(), threads_count, chunk_size);
+    if (threads_count == 1) {
+      sequential_ms = result.elapsed_ms;
+      sequential_finish_time = result.finish_time;
+    }
+
+    const auto identical = (result.finish_time == sequential_finish_time);
+    std::cout << std::setw(12) << name << std::setw(10) << threads_count
+              << std::fixed << std::setprecision(1) << std::setw(14)
+              << result.elapsed_ms << std::setprecision(2) << std::setw(10)
+              << sequential_ms / result.elapsed_ms << std::setw(16)
+              << result.finish_time << std::setw(12)
+              << (identical ? "yes" : "NO") << std::endl;
+  }
+}
+
+} // namespace
+
+int main(const int argc, const char* const argv[]) {
+  // max number of threads: the number of cores, unless given
+  auto max_threads_count =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  if (argc > 1) {
+    max_threads_count = std::max(1, std::stoi(argv[1]));
+  }
+
+  std::cout << "All-to-All, parallel simulation scaling" << std::endl;
+  std::cout << std::setw(12) << "topology" << std::setw(10) << "threads"
+            << std::setw(14) << "elapsed (ms)" << std::setw(10) << "speedup"
+            << std::setw(16) << "finish (ns)" << std::setw(12) << "identical"
+            << std::endl;
+
+  run_scaling("Ring-256", max_threads_count, []() {
+    return std::make_shared<Ring>(256, 50.0, 500.0);
+  });
+  run_scaling("Switch-1024", max_threads_count, []() {
+    return std::make_shared<Switch>(1'024, 50.0, 500.0);
+  });
+
+  return 0;
+}
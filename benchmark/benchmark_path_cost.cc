@@ -0,0 +1,148 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// number of traffic matrices per run
+constexpr auto matrices_count = 20;
+
+/**
+ * Construct a multi-dimensional topology.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ * @return constructed topology
+ */
+std::unique_ptr<MultiDimTopology> construct(
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  auto topology = std::make_unique<MultiDimTopology>();
+  for (auto dim = size_t{0}; dim < topologies_per_dim.size(); dim++) {
+    const auto npus_count = npus_count_per_dim[dim];
+    const Bandwidth bandwidth = 400.0 / static_cast<double>(dim + 1);
+    const Latency latency = 500.0 * static_cast<double>(dim + 1);
+    switch (topologies_per_dim[dim]) {
+      case TopologyBuildingBlock::Ring:
+        topology->append_dimension(
+            std::make_unique<Ring>(npus_count, bandwidth, latency));
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        topology->append_dimension(
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+        break;
+      default:
+        topology->append_dimension(
+            std::make_unique<Switch>(npus_count, bandwidth, latency));
+        break;
+    }
+  }
+  return topology;
+}
+
+/**
+ * Compare one send() per pair against one send_traffic_matrix()
+ * for every path cost model.
+ *
+ * @param name name of the topology
+ * @param topology topology to query
+ */
+void run_comparison(const std::string& name, MultiDimTopology& topology) {
+  // random all-to-all traffic matrix
+  const auto npus_count = topology.get_npus_count();
+  const auto pairs_count = static_cast<size_t>(npus_count) * npus_count;
+  auto generator = std::mt19937_64(0);
+  auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 1 << 26);
+  auto chunk_sizes = std::vector<ChunkSize>(pairs_count);
+  for (auto& chunk_size : chunk_sizes) {
+    chunk_size = size_distribution(generator);
+  }
+
+  for (const auto& [model_name, path_cost_model] :
+       {std::make_pair("FirstDim", PathCostModel::FirstDim),
+        std::make_pair("StoreAndForward", PathCostModel::StoreAndForward),
+        std::make_pair("Pipelined", PathCostModel::Pipelined)}) {
+    topology.set_path_cost_model(path_cost_model);
+
+    // one virtual send() per pair
+    auto pair_delays = std::vector<EventTime>(pairs_count);
+    const auto pair_start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < matrices_count; i++) {
+      for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+          const auto pair = (static_cast<size_t>(src) * npus_count) + dest;
+          pair_delays[pair] = (src == dest)
+              ? 0
+              : topology.send(src, dest, chunk_sizes[pair]);
+        }
+      }
+    }
+    const auto pair_end = std::chrono::steady_clock::now();
+
+    // one send_traffic_matrix() per matrix
+    auto matrix_delays = std::vector<EventTime>(pairs_count);
+    const auto matrix_start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < matrices_count; i++) {
+      topology.send_traffic_matrix(chunk_sizes.data(), matrix_delays.data());
+    }
+    const auto matrix_end = std::chrono::steady_clock::now();
+
+    // cost of each pair in ns
+    const auto queries_count =
+        static_cast<double>(pairs_count) * matrices_count;
+    const auto pair_ns =
+        std::chrono::duration<double, std::nano>(pair_end - pair_start)
+            .count() /
+        queries_count;
+    const auto matrix_ns =
+        std::chrono::duration<double, std::nano>(matrix_end - matrix_start)
+            .count() /
+        queries_count;
+
+    std::cout << std::setw(24) << name << std::setw(8) << npus_count
+              << std::setw(18) << model_name << std::fixed
+              << std::setprecision(1) << std::setw(14) << pair_ns
+              << std::setw(14) << matrix_ns << std::setw(8)
+              << ((pair_delays == matrix_delays) ? "yes" : "no") << std::endl;
+  }
+}
+
+} // namespace
+
+int main() {
+  std::cout << "All-to-all traffic matrices: send() vs. send_traffic_matrix()"
+            << std::endl;
+  std::cout << std::setw(24) << "topology" << std::setw(8) << "npus"
+            << std::setw(18) << "path cost" << std::setw(14) << "send (ns)"
+            << std::setw(14) << "matrix (ns)" << std::setw(8) << "match"
+            << std::endl;
+
+  using Block = TopologyBuildingBlock;
+  run_comparison(
+      "Ring_FC_Switch",
+      *construct(
+          {Block::Ring, Block::FullyConnected, Block::Switch}, {8, 8, 16}));
+  run_comparison(
+      "Ring_FC_Ring_Switch",
+      *construct(
+          {Block::Ring, Block::FullyConnected, Block::Ring, Block::Switch},
+          {4, 8, 4, 16}));
+
+  return 0;
+}
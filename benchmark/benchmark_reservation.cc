@@ -0,0 +1,186 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/SimulationContext.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Measurement of a simulation run.
+ */
+struct RunResult {
+  /// wall-clock time of the simulation in ms
+  double elapsed_ms;
+
+  /// number of events scheduled into the event queue
+  uint64_t events_count;
+
+  /// simulated finish time in ns
+  EventTime finish_time;
+
+  /// arrival time of each chunk in ns
+  std::vector<EventTime> arrival_times;
+};
+
+/**
+ * Chunk whose arrival time is recorded.
+ */
+struct ArrivalRecord {
+  /// event queue of the simulation
+  EventQueue* event_queue;
+
+  /// where to record the arrival time
+  EventTime* arrival_time;
+};
+
+/// (src, dest) pairs of the chunks to send
+using Traffic = std::vector<std::pair<DeviceId, DeviceId>>;
+
+/**
+ * Simulate the given traffic on a bidirectional Ring.
+ *
+ * @param npus_count number of NPUs of the Ring
+ * @param traffic (src, dest) pairs of the chunks to send
+ * @param congestion_model congestion model of the topology
+ * @return measurement of the run
+ */
+RunResult run(
+    const int npus_count,
+    const Traffic& traffic,
+    const CongestionModel congestion_model) {
+  const ChunkSize chunk_size = 65'536;
+  const auto topology = std::make_shared<Ring>(npus_count, 50.0, 500.0);
+  topology->set_congestion_model(congestion_model);
+  auto context = SimulationContext(topology);
+  const auto event_queue = context.get_event_queue();
+
+  // records of the arrival times, never reallocated
+  const auto chunks_count = traffic.size();
+  auto result = RunResult{0.0, 0, 0, std::vector<EventTime>(chunks_count)};
+  auto records = std::vector<ArrivalRecord>(chunks_count);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = size_t{0}; i < chunks_count; i++) {
+    const auto [src, dest] = traffic[i];
+    records[i] = {event_queue.get(), &result.arrival_times[i]};
+    topology->send(topology->make_chunk(
+        chunk_size,
+        topology->route(src, dest),
+        [](void* const arg) {
+          const auto* const record = static_cast<ArrivalRecord*>(arg);
+          *record->arrival_time = record->event_queue->get_current_time();
+        },
+        &records[i]));
+  }
+  context.run();
+  const auto end = std::chrono::steady_clock::now();
+
+  result.elapsed_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  result.events_count = event_queue->get_scheduled_events_count();
+  result.finish_time = context.get_current_time();
+  return result;
+}
+
+/**
+ * Compare the reservation model against the hop-by-hop model.
+ *
+ * @param name name of the traffic pattern
+ * @param npus_count number of NPUs of the Ring
+ * @param traffic (src, dest) pairs of the chunks to send
+ */
+void run_comparison(
+    const char* const name,
+    const int npus_count,
+    const Traffic& traffic) {
+  const auto hop_by_hop = run(npus_count, traffic, CongestionModel::HopByHop);
+  const auto reservation =
+      run(npus_count, traffic, CongestionModel::Reservation);
+
+  // timing deltas of the reservation model
+  const auto finish_delta = 100.0 *
+      (static_cast<double>(reservation.finish_time) -
+       static_cast<double>(hop_by_hop.finish_time)) /
+      static_cast<double>(hop_by_hop.finish_time);
+  auto mean_delta = 0.0;
+  auto identical_count = size_t{0};
+  const auto chunks_count = hop_by_hop.arrival_times.size();
+  for (auto i = size_t{0}; i < chunks_count; i++) {
+    const auto expected = hop_by_hop.arrival_times[i];
+    const auto actual = reservation.arrival_times[i];
+    const auto delta =
+        static_cast<double>(actual) - static_cast<double>(expected);
+    mean_delta += delta / static_cast<double>(expected);
+    identical_count += (actual == expected) ? 1 : 0;
+  }
+  mean_delta = 100.0 * mean_delta / static_cast<double>(chunks_count);
+
+  std::cout << std::setw(18) << name << std::setw(6) << npus_count
+            << std::setw(12) << hop_by_hop.events_count << std::setw(12)
+            << reservation.events_count << std::fixed << std::setprecision(1)
+            << std::setw(10)
+            << static_cast<double>(hop_by_hop.events_count) /
+                   static_cast<double>(reservation.events_count)
+            << "x" << std::setw(12) << hop_by_hop.elapsed_ms << std::setw(12)
+            << reservation.elapsed_ms << std::setprecision(2) << std::setw(11)
+            << finish_delta << " %" << std::setw(9) << mean_delta << " %"
+            << std::setw(10) << std::setprecision(1)
+            << 100.0 * static_cast<double>(identical_count) /
+                   static_cast<double>(chunks_count)
+            << " %" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "Reservation vs. hop-by-hop congestion model on Ring"
+            << std::endl;
+  std::cout << std::setw(18) << "traffic" << std::setw(6) << "npus"
+            << std::setw(12) << "events hop" << std::setw(12) << "events res"
+            << std::setw(11) << "reduction" << std::setw(12) << "hop (ms)"
+            << std::setw(12) << "res (ms)" << std::setw(13) << "finish diff"
+            << std::setw(11) << "mean diff" << std::setw(12) << "identical"
+            << std::endl;
+
+  for (const auto npus_count : {128, 256}) {
+    // uncontended: every 16th NPU sends over 15 disjoint hops
+    auto disjoint = Traffic();
+    for (auto src = 0; src < npus_count; src += 16) {
+      disjoint.emplace_back(src, src + 15);
+    }
+    run_comparison("disjoint 15-hop", npus_count, disjoint);
+
+    // contended: every NPU sends to the NPU half the ring away
+    auto shift = Traffic();
+    for (auto src = 0; src < npus_count; src++) {
+      shift.emplace_back(src, (src + npus_count / 2) % npus_count);
+    }
+    run_comparison("half-ring shift", npus_count, shift);
+
+    // contended: every NPU sends to every other NPU
+    auto all_to_all = Traffic();
+    for (auto src = 0; src < npus_count; src++) {
+      for (auto dest = 0; dest < npus_count; dest++) {
+        if (src != dest) {
+          all_to_all.emplace_back(src, dest);
+        }
+      }
+    }
+    run_comparison("all-to-all", npus_count, all_to_all);
+  }
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// number of queries per run
+constexpr auto queries_count = size_t{1'000'000};
+
+/**
+ * Construct a multi-dimensional topology.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_count_per_dim number of NPUs of each dimension
+ * @return constructed topology
+ */
+std::unique_ptr<Topology> construct(
+    const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+    const std::vector<int>& npus_count_per_dim) {
+  auto topology = std::make_unique<MultiDimTopology>();
+  for (auto dim = size_t{0}; dim < topologies_per_dim.size(); dim++) {
+    const auto npus_count = npus_count_per_dim[dim];
+    const Bandwidth bandwidth = 400.0 / static_cast<double>(dim + 1);
+    const Latency latency = 500.0 * static_cast<double>(dim + 1);
+    switch (topologies_per_dim[dim]) {
+      case TopologyBuildingBlock::Ring:
+        topology->append_dimension(
+            std::make_unique<Ring>(npus_count, bandwidth, latency));
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        topology->append_dimension(
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+        break;
+      default:
+        topology->append_dimension(
+            std::make_unique<Switch>(npus_count, bandwidth, latency));
+        break;
+    }
+  }
+  return topology;
+}
+
+/**
+ * Compare one send() per query against one send_batch() for all queries.
+ *
+ * @param name name of the topology
+ * @param topology topology to query
+ */
+void run_comparison(const std::string& name, const Topology& topology) {
+  // random (src, dest, size) queries
+  const auto npus_count = topology.get_npus_count();
+  auto generator = std::mt19937_64(0);
+  auto npu_distribution = std::uniform_int_distribution<int>(0, npus_count - 1);
+  auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 1 << 26);
+  auto srcs = std::vector<DeviceId>(queries_count);
+  auto dests = std::vector<DeviceId>(queries_count);
+  auto chunk_sizes = std::vector<ChunkSize>(queries_count);
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    srcs[i] = npu_distribution(generator);
+    do {
+      dests[i] = npu_distribution(generator);
+    } while (dests[i] == srcs[i]);
+    chunk_sizes[i] = size_distribution(generator);
+  }
+
+  // one virtual send() per query
+  auto scalar_delays = std::vector<EventTime>(queries_count);
+  const auto scalar_start = std::chrono::steady_clock::now();
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    scalar_delays[i] = topology.send(srcs[i], dests[i], chunk_sizes[i]);
+  }
+  const auto scalar_end = std::chrono::steady_clock::now();
+
+  // one send_batch() for every query
+  auto batch_delays = std::vector<EventTime>(queries_count);
+  const auto batch_start = std::chrono::steady_clock::now();
+  topology.send_batch(
+      srcs.data(),
+      dests.data(),
+      chunk_sizes.data(),
+      batch_delays.data(),
+      queries_count);
+  const auto batch_end = std::chrono::steady_clock::now();
+
+  // throughput in million queries per second
+  const auto scalar_s =
+      std::chrono::duration<double>(scalar_end - scalar_start).count();
+  const auto batch_s =
+      std::chrono::duration<double>(batch_end - batch_start).count();
+  const auto scalar_mqps = static_cast<double>(queries_count) / scalar_s / 1e6;
+  const auto batch_mqps = static_cast<double>(queries_count) / batch_s / 1e6;
+
+  std::cout << std::setw(24) << name << std::setw(8) << npus_count
+            << std::fixed << std::setprecision(1) << std::setw(16)
+            << scalar_mqps << std::setw(16) << batch_mqps << std::setw(11)
+            << batch_mqps / scalar_mqps << "x" << std::setw(8)
+            << ((scalar_delays == batch_delays) ? "yes" : "no") << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "1M congestion-unaware queries: send_batch vs. send"
+            << std::endl;
+  std::cout << std::setw(24) << "topology" << std::setw(8) << "npus"
+            << std::setw(16) << "send (Mq/s)" << std::setw(16)
+            << "batch (Mq/s)" << std::setw(12) << "speedup" << std::setw(8)
+            << "match" << std::endl;
+
+  using Block = TopologyBuildingBlock;
+  run_comparison("Ring", Ring(1024, 50.0, 500.0));
+  run_comparison("Switch", Switch(1024, 50.0, 500.0));
+  run_comparison(
+      "Ring_FC_Switch",
+      *construct(
+          {Block::Ring, Block::FullyConnected, Block::Switch}, {8, 8, 16}));
+  run_comparison(
+      "Ring_FC_Ring_Switch",
+      *construct(
+          {Block::Ring, Block::FullyConnected, Block::Ring, Block::Switch},
+          {4, 8, 4, 16}));
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "congestion_aware/Chunk.hh"
+#include "congestion_aware/FullyConnected.hh"
+#include "congestion_aware/Ring.hh"
+#include "congestion_aware/SimulationContext.hh"
+#include "congestion_aware/Switch.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * A design point of the sweep.
+ */
+struct DesignPoint {
+  /// topology building block
+  TopologyBuildingBlock topology_type;
+
+  /// number of NPUs
+  int npus_count;
+
+  /// link bandwidth in GB/s
+  Bandwidth bandwidth;
+};
+
+/**
+ * Simulate an All-to-All on a design point, on its own SimulationContext.
+ *
+ * @param design_point design point to simulate
+ * @return simulated finish time in ns
+ */
+EventTime simulate(const DesignPoint& design_point) {
+  const auto npus_count = design_point.npus_count;
+  const auto bandwidth = design_point.bandwidth;
+  const Latency latency = 500;
+
+  // construct the topology
+  auto topology = std::shared_ptr<Topology>();
+  switch (design_point.topology_type) {
+    case TopologyBuildingBlock::Ring:
+      topology = std::make_shared<Ring>(npus_count, bandwidth, latency);
+      break;
+    case TopologyBuildingBlock::Switch:
+      topology = std::make_shared<Switch>(npus_count, bandwidth, latency);
+      break;
+    default:
+      topology =
+          std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+      break;
+  }
+  auto context = SimulationContext(topology);
+
+  // every NPU sends a chunk to every other NPU
+  const ChunkSize chunk_size = 262'144;
+  const auto callback = [](void* const) {};
+  for (auto i = 0; i < npus_count; i++) {
+    for (auto j = 0; j < npus_count; j++) {
+      if (i != j) {
+        topology->send(std::make_unique<Chunk>(
+            chunk_size, topology->route(i, j), callback, nullptr));
+      }
+    }
+  }
+
+  context.run();
+  return context.get_current_time();
+}
+
+/**
+ * Simulate every design point with the given number of threads.
+ *
+ * @param design_points design points to simulate
+ * @param threads_count number of threads
+ * @return simulated finish time of each design point
+ */
+std::vector<EventTime> run_sweep(
+    const std::vector<DesignPoint>& design_points,
+    const int threads_count) {
+  auto finish_times = std::vector<EventTime>(design_points.size(), 0);
+  auto next_index = std::atomic<size_t>(0);
+
+  // each thread repeatedly takes the next design point
+  const auto worker = [&]() {
+    while (true) {
+      const auto index = next_index.fetch_add(1);
+      if (index >= design_points.size()) {
+        return;
+      }
+      finish_times[index] = simulate(design_points[index]);
+    }
+  };
+
+  auto threads = std::vector<std::thread>();
+  for (auto i = 0; i < threads_count; i++) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return finish_times;
+}
+
+} // namespace
+
+int main(const int argc, const char* const argv[]) {
+  // max number of threads: the number of cores, unless given
+  auto max_threads_count =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  if (argc > 1) {
+    max_threads_count = std::max(1, std::stoi(argv[1]));
+  }
+
+  // design points: topology x NPUs count x bandwidth
+  auto design_points = std::vector<DesignPoint>();
+  for (const auto topology_type :
+       {TopologyBuildingBlock::Ring,
+        TopologyBuildingBlock::Switch,
+        TopologyBuildingBlock::FullyConnected}) {
+    for (const auto npus_count : {64, 128}) {
+      for (const auto bandwidth : {25.0, 50.0, 100.0, 200.0}) {
+        design_points.push_back({topology_type, npus_count, bandwidth});
+      }
+    }
+  }
+
+  std::cout << "design-space sweep, " << design_points.size()
+            << " independent simulations" << std::endl;
+  std::cout << std::setw(10) << "threads" << std::setw(14) << "elapsed (ms)"
+            << std::setw(12) << "sims/s" << std::setw(10) << "speedup"
+            << std::setw(12) << "identical" << std::endl;
+
+  auto reference = std::vector<EventTime>();
+  auto sequential_ms = 0.0;
+  for (auto threads_count = 1; threads_count <= max_threads_count;
+       threads_count *= 2) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto finish_times = run_sweep(design_points, threads_count);
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto elapsed_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    if (threads_count == 1) {
+      reference = finish_times;
+      sequential_ms = elapsed_ms;
+    }
+
+    const auto throughput =
+        static_cast<double>(design_points.size()) / (elapsed_ms / 1'000.0);
+    const auto identical = (finish_times == reference);
+    std::cout << std::setw(10) << threads_count << std::fixed
+              << std::setprecision(1) << std::setw(14) << elapsed_ms
+              << std::setw(12) << throughput << std::setprecision(2)
+              << std::setw(10) << sequential_ms / elapsed_ms << std::setw(12)
+              << (identical ? "yes" : "NO") << std::endl;
+  }
+
+  return 0;
+}
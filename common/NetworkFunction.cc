@@ -15,3 +15,21 @@ Bandwidth NetworkAnalytical::bw_GBps_to_Bpns(const Bandwidth bw_GBps) noexcept {
   // 1 s is 10^9 ns
   return bw_GBps * (1 << 30) / (1'000'000'000); // GB/s to B/ns
 }
+
+Bandwidth NetworkAnalytical::bw_Bpns_to_GBps(const Bandwidth bw_Bpns) noexcept {
+  assert(bw_Bpns >= 0);
+
+  // 1 GB is 2^30 B
+  // 1 s is 10^9 ns
+  return bw_Bpns * (1'000'000'000) / (1 << 30); // B/ns to GB/s
+}
+
+ChunkSize NetworkAnalytical::split_size(
+    const ChunkSize size,
+    const uint64_t chunks_count) noexcept {
+  assert(chunks_count > 0);
+
+  // round up, so the chunks cover the data
+  const auto chunk_size = (size + chunks_count - 1) / chunks_count;
+  return (chunk_size > 0) ? chunk_size : 1;
+}
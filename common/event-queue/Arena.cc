@@ -0,0 +1,163 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Arena.hh"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+Arena::Arena() noexcept
+    : slab_cursor(nullptr),
+      slab_remaining_bytes(0),
+      used_bytes(0),
+      peak_used_bytes(0),
+      reserved_bytes(0),
+      system_allocations_count(0) {
+  // initialize empty free lists
+  free_lists.fill(nullptr);
+  large_free_lists.fill(nullptr);
+  slabs = std::vector<void*>();
+}
+
+Arena::~Arena() noexcept {
+  // every block should be released before the arena
+  assert(used_bytes == 0);
+
+  // return large blocks to the system, all of them are in the free lists
+  for (auto* free_list : large_free_lists) {
+    while (free_list != nullptr) {
+      auto* const block = free_list;
+      free_list = block->next;
+      ::operator delete(block);
+    }
+  }
+
+  // return slabs to the system
+  for (auto* const slab : slabs) {
+    ::operator delete(slab);
+  }
+}
+
+void* Arena::allocate(const size_t size) noexcept {
+  assert(size > 0);
+
+  // large block: account the rounded-up size
+  if (size > max_block_size) {
+    const auto block_class = large_size_class(size);
+    const auto block_size = size_t{1} << block_class;
+    used_bytes += block_size;
+    peak_used_bytes = std::max(peak_used_bytes, used_bytes);
+
+    // reuse a freed block if one exists
+    auto*& free_list = large_free_lists[block_class];
+    if (free_list != nullptr) {
+      auto* const block = free_list;
+      free_list = block->next;
+      return block;
+    }
+
+    // otherwise, forward to the system allocator
+    reserved_bytes += block_size;
+    system_allocations_count++;
+    return ::operator new(block_size);
+  }
+
+  // small block: account the rounded-up size
+  const auto block_class = size_class(size);
+  const auto block_size = (block_class + 1) * block_alignment;
+  used_bytes += block_size;
+  peak_used_bytes = std::max(peak_used_bytes, used_bytes);
+
+  // reuse a freed block if one exists
+  auto*& free_list = free_lists[block_class];
+  if (free_list != nullptr) {
+    auto* const block = free_list;
+    free_list = block->next;
+    return block;
+  }
+
+  // otherwise, carve a new block out of the current slab
+  if (slab_remaining_bytes < block_size) {
+    allocate_slab();
+  }
+  auto* const block = slab_cursor;
+  slab_cursor += block_size;
+  slab_remaining_bytes -= block_size;
+  return block;
+}
+
+void Arena::deallocate(void* const block, const size_t size) noexcept {
+  assert(block != nullptr);
+  assert(size > 0);
+
+  // large block: push into the free list of its power-of-two class
+  if (size > max_block_size) {
+    const auto block_class = large_size_class(size);
+    const auto block_size = size_t{1} << block_class;
+    assert(used_bytes >= block_size);
+    used_bytes -= block_size;
+
+    auto* const free_block = static_cast<FreeBlock*>(block);
+    free_block->next = large_free_lists[block_class];
+    large_free_lists[block_class] = free_block;
+    return;
+  }
+
+  // small block: push into the free list of its size class
+  const auto block_class = size_class(size);
+  const auto block_size = (block_class + 1) * block_alignment;
+  assert(used_bytes >= block_size);
+  used_bytes -= block_size;
+
+  auto* const free_block = static_cast<FreeBlock*>(block);
+  free_block->next = free_lists[block_class];
+  free_lists[block_class] = free_block;
+}
+
+size_t Arena::get_used_bytes() const noexcept {
+  return used_bytes;
+}
+
+size_t Arena::get_peak_used_bytes() const noexcept {
+  return peak_used_bytes;
+}
+
+size_t Arena::get_reserved_bytes() const noexcept {
+  return reserved_bytes;
+}
+
+size_t Arena::get_system_allocations_count() const noexcept {
+  return system_allocations_count;
+}
+
+size_t Arena::size_class(const size_t size) noexcept {
+  assert(0 < size && size <= max_block_size);
+
+  // size classes are multiples of block_alignment
+  return (size - 1) / block_alignment;
+}
+
+size_t Arena::large_size_class(const size_t size) noexcept {
+  assert(size > max_block_size);
+
+  // smallest power of two not less than size
+  auto block_class = size_t{0};
+  while ((size_t{1} << block_class) < size) {
+    block_class++;
+  }
+  assert(block_class < large_size_classes_count);
+  return block_class;
+}
+
+void Arena::allocate_slab() noexcept {
+  // the leftover of the current slab is abandoned
+  auto* const slab = ::operator new(slab_size);
+  slabs.push_back(slab);
+  slab_cursor = static_cast<char*>(slab);
+  slab_remaining_bytes = slab_size;
+  reserved_bytes += slab_size;
+  system_allocations_count++;
+}
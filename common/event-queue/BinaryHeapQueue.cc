@@ -0,0 +1,56 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/BinaryHeapQueue.hh"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+BinaryHeapQueue::BinaryHeapQueue(Arena& arena) noexcept
+    : heap(ArenaAllocator<Entry>(&arena)), next_sequence(0) {}
+
+bool BinaryHeapQueue::empty() const noexcept {
+  // check whether the heap is empty
+  return heap.empty();
+}
+
+EventTime BinaryHeapQueue::get_min_event_time() const noexcept {
+  assert(!empty());
+
+  // earliest entry sits at the top of the heap
+  return heap.front().event_time;
+}
+
+void BinaryHeapQueue::push(
+    const EventTime event_time,
+    Event event) noexcept {
+  // append the entry and restore the heap property
+  heap.push_back({event_time, next_sequence, std::move(event)});
+  std::push_heap(heap.begin(), heap.end(), later);
+
+  // increment registration order
+  next_sequence++;
+}
+
+Event BinaryHeapQueue::pop() noexcept {
+  assert(!empty());
+
+  // move the earliest entry to the back and drop it
+  std::pop_heap(heap.begin(), heap.end(), later);
+  auto event = std::move(heap.back().event);
+  heap.pop_back();
+
+  return event;
+}
+
+bool BinaryHeapQueue::later(const Entry& lhs, const Entry& rhs) noexcept {
+  // compare event time first, then the registration order
+  if (lhs.event_time != rhs.event_time) {
+    return lhs.event_time > rhs.event_time;
+  }
+  return lhs.sequence > rhs.sequence;
+}
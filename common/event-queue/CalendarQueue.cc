@@ -0,0 +1,245 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/CalendarQueue.hh"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+CalendarQueue::CalendarQueue(Arena& arena) noexcept
+    : arena(&arena),
+      bucket_width(1),
+      event_lists_count(0),
+      min_bucket(0),
+      last_time(0) {
+  // create empty buckets
+  buckets = make_buckets(min_buckets_count);
+}
+
+bool CalendarQueue::empty() const noexcept {
+  // check whether any event list is registered
+  return event_lists_count == 0;
+}
+
+EventTime CalendarQueue::get_min_event_time() const noexcept {
+  // earliest event should exist
+  assert(!empty());
+  assert(!buckets[min_bucket].empty());
+
+  // earliest event list sits in front of the min bucket
+  return buckets[min_bucket].front().get_event_time();
+}
+
+void CalendarQueue::push(
+    const EventTime event_time,
+    Event event) noexcept {
+  // event time should not precede the already popped events
+  assert(event_time >= last_time);
+
+  // find the entry to insert event, scanning from the back of the bucket
+  // as newly scheduled events are usually the latest ones
+  const auto index = bucket_index(event_time);
+  auto& bucket = buckets[index];
+  auto event_list_it = bucket.end();
+  while (event_list_it != bucket.begin() &&
+         std::prev(event_list_it)->get_event_time() >= event_time) {
+    event_list_it--;
+  }
+
+  // if there's no event list matching with event_time, create a new one
+  if (event_list_it == bucket.end() ||
+      event_list_it->get_event_time() != event_time) {
+    // check whether this event becomes the earliest one
+    if (empty() || event_time < get_min_event_time()) {
+      min_bucket = index;
+    }
+
+    event_list_it = bucket.emplace(event_list_it, event_time, *arena);
+    event_lists_count++;
+  }
+
+  // add event to event_list
+  event_list_it->add_event(std::move(event));
+
+  // grow the calendar if the buckets become too crowded
+  if (event_lists_count > 2 * buckets.size()) {
+    resize(2 * buckets.size());
+  }
+}
+
+Event CalendarQueue::pop() noexcept {
+  // to pop, an event should exist
+  assert(!empty());
+
+  // earliest event is in front of the earliest event list
+  auto& bucket = buckets[min_bucket];
+  auto& event_list = bucket.front();
+  last_time = event_list.get_event_time();
+  auto event = event_list.pop_event();
+
+  // event list still holds events at the same time
+  if (!event_list.empty()) {
+    return event;
+  }
+
+  // drop the drained event list
+  bucket.pop_front();
+  event_lists_count--;
+
+  // shrink the calendar if the buckets become too sparse,
+  // otherwise find the next earliest event list
+  if (buckets.size() > min_buckets_count &&
+      event_lists_count < buckets.size() / 2) {
+    resize(buckets.size() / 2);
+  } else if (!empty()) {
+    locate_min_bucket();
+  }
+
+  return event;
+}
+
+size_t CalendarQueue::bucket_index(const EventTime event_time) const noexcept {
+  assert(bucket_width > 0);
+
+  // buckets count is a power of 2, so masking computes the modulo
+  return static_cast<size_t>(event_time / bucket_width) & (buckets.size() - 1);
+}
+
+std::vector<CalendarQueue::Bucket> CalendarQueue::make_buckets(
+    const size_t buckets_count) const noexcept {
+  auto new_buckets = std::vector<Bucket>();
+  new_buckets.reserve(buckets_count);
+  for (size_t i = 0; i < buckets_count; i++) {
+    new_buckets.emplace_back(ArenaAllocator<EventList>(arena));
+  }
+  return new_buckets;
+}
+
+void CalendarQueue::splice_sorted(
+    Bucket& bucket,
+    Bucket& source,
+    const Bucket::iterator event_list_it) noexcept {
+  const auto event_time = event_list_it->get_event_time();
+
+  // find the position to keep the bucket sorted
+  auto position = bucket.end();
+  while (position != bucket.begin() &&
+         std::prev(position)->get_event_time() > event_time) {
+    position--;
+  }
+
+  // move the node without reallocating the event list
+  bucket.splice(position, source, event_list_it);
+}
+
+void CalendarQueue::locate_min_bucket() noexcept {
+  assert(!empty());
+
+  // scan a year of buckets starting from the day of last_time
+  auto index = bucket_index(last_time);
+  auto bucket_top = (last_time / bucket_width + 1) * bucket_width;
+  for (size_t i = 0; i < buckets.size(); i++) {
+    const auto& bucket = buckets[index];
+    if (!bucket.empty() && bucket.front().get_event_time() < bucket_top) {
+      // found the earliest event list within this year
+      min_bucket = index;
+      return;
+    }
+
+    // move to the next day
+    index = (index + 1) & (buckets.size() - 1);
+    bucket_top += bucket_width;
+  }
+
+  // no event list within a year: directly search the earliest one
+  auto found = false;
+  for (size_t i = 0; i < buckets.size(); i++) {
+    if (buckets[i].empty()) {
+      continue;
+    }
+
+    if (!found ||
+        buckets[i].front().get_event_time() <
+            buckets[min_bucket].front().get_event_time()) {
+      min_bucket = i;
+      found = true;
+    }
+  }
+  assert(found);
+}
+
+EventTime CalendarQueue::compute_bucket_width() const noexcept {
+  // not enough samples: keep the current width
+  if (event_lists_count < 2) {
+    return bucket_width;
+  }
+
+  // collect registered event times
+  auto event_times = std::vector<EventTime>();
+  event_times.reserve(event_lists_count);
+  for (const auto& bucket : buckets) {
+    for (const auto& event_list : bucket) {
+      event_times.push_back(event_list.get_event_time());
+    }
+  }
+
+  // sort the earliest event times
+  const auto samples_count =
+      std::min(event_times.size(), bucket_width_samples_count);
+  std::partial_sort(
+      event_times.begin(),
+      event_times.begin() + static_cast<std::ptrdiff_t>(samples_count),
+      event_times.end());
+
+  // average separation between the earliest event times
+  const auto total_separation = event_times[samples_count - 1] - event_times[0];
+  const auto average_separation =
+      static_cast<double>(total_separation) / (samples_count - 1);
+
+  // recompute the average, ignoring unusually large separations
+  auto trimmed_separation = 0.0;
+  auto trimmed_count = 0;
+  for (size_t i = 1; i < samples_count; i++) {
+    const auto separation =
+        static_cast<double>(event_times[i] - event_times[i - 1]);
+    if (separation <= 2 * average_separation) {
+      trimmed_separation += separation;
+      trimmed_count++;
+    }
+  }
+
+  // bucket width is three times the average separation
+  const auto width = 3 * trimmed_separation / trimmed_count;
+  return std::max(static_cast<EventTime>(width), EventTime{1});
+}
+
+void CalendarQueue::resize(const size_t new_buckets_count) noexcept {
+  assert(new_buckets_count >= min_buckets_count);
+  assert((new_buckets_count & (new_buckets_count - 1)) == 0);
+
+  // compute the new bucket width using the current calendar
+  const auto new_bucket_width = compute_bucket_width();
+
+  // swap in the new calendar
+  auto old_buckets = make_buckets(new_buckets_count);
+  std::swap(buckets, old_buckets);
+  bucket_width = new_bucket_width;
+
+  // move every event list into the new calendar
+  for (auto& old_bucket : old_buckets) {
+    while (!old_bucket.empty()) {
+      const auto event_list_it = old_bucket.begin();
+      auto& bucket = buckets[bucket_index(event_list_it->get_event_time())];
+      splice_sorted(bucket, old_bucket, event_list_it);
+    }
+  }
+
+  // earliest event list may have moved
+  if (!empty()) {
+    locate_min_bucket();
+  }
+}
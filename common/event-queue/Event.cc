@@ -5,25 +5,61 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Event.hh"
 #include <cassert>
+#include <utility>
 
 using namespace NetworkAnalytical;
 
 Event::Event(const Callback callback, const CallbackArg callback_arg) noexcept
-    : callback(callback), callback_arg(callback_arg) {
+    : kind(EventKind::Callback),
+      schedule_time(0),
+      handler{callback, callback_arg} {
   assert(callback != nullptr);
 }
 
-void Event::invoke_event() noexcept {
-  // check the validity of the event
-  assert(callback != nullptr);
+Event::Event(InlineCallback closure) noexcept
+    : kind(EventKind::Closure), schedule_time(0), closure(std::move(closure)) {
+  assert(this->closure);
+}
 
-  // invoke the callback function
-  (*callback)(callback_arg);
+Event::Event(const EventKind kind, void* const target) noexcept
+    : Event(kind, target, {0, -1, 0}) {}
+
+Event::Event(
+    const EventKind kind,
+    void* const target,
+    const EventKey& key) noexcept
+    : kind(kind), schedule_time(0), builtin{target, key} {
+  assert(kind != EventKind::Callback && kind != EventKind::Closure);
+  assert(target != nullptr);
+}
+
+EventKind Event::get_kind() const noexcept {
+  return kind;
+}
+
+void Event::invoke_event(const EventDispatcher dispatcher) noexcept {
+  switch (kind) {
+    case EventKind::Callback:
+      // invoke the callback function
+      assert(handler.callback != nullptr);
+      (*handler.callback)(handler.callback_arg);
+      break;
+    case EventKind::Closure:
+      // invoke the inline callable
+      closure();
+      break;
+    default:
+      // built-in event, handled by the network backend
+      assert(dispatcher != nullptr);
+      (*dispatcher)(kind, builtin.target);
+      break;
+  }
 }
 
 std::pair<Callback, CallbackArg> Event::get_handler_arg() const noexcept {
   // check the validity of the event
-  assert(callback != nullptr);
+  assert(kind == EventKind::Callback);
+  assert(handler.callback != nullptr);
 
-  return {callback, callback_arg};
+  return {handler.callback, handler.callback_arg};
 }
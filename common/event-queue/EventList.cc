@@ -5,34 +5,44 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/EventList.hh"
 #include <cassert>
+#include <utility>
 
 using namespace NetworkAnalytical;
 
-EventList::EventList(const EventTime event_time) noexcept
-    : event_time(event_time) {
+EventList::EventList(const EventTime event_time, Arena& arena) noexcept
+    : event_time(event_time), events(ArenaAllocator<Event>(&arena)) {
   assert(event_time >= 0);
-
-  // create an empty event list
-  events = std::list<Event>();
 }
 
 EventTime EventList::get_event_time() const noexcept {
   return event_time;
 }
 
-void EventList::add_event(
-    const Callback callback,
-    const CallbackArg callback_arg) noexcept {
-  assert(callback != nullptr);
-
+void EventList::add_event(Event event) noexcept {
   // add the event to the event list
-  events.emplace_back(callback, callback_arg);
+  events.push_back(std::move(event));
+}
+
+bool EventList::empty() const noexcept {
+  // check whether events list is empty
+  return events.empty();
+}
+
+Event EventList::pop_event() noexcept {
+  // to pop, an event should exist
+  assert(!events.empty());
+
+  // dequeue the first event
+  auto event = std::move(events.front());
+  events.pop_front();
+
+  return event;
 }
 
-void EventList::invoke_events() noexcept {
+void EventList::invoke_events(const EventDispatcher dispatcher) noexcept {
   // invoke all events in the event list
   while (!events.empty()) {
-    events.front().invoke_event();
+    events.front().invoke_event(dispatcher);
     events.pop_front();
   }
 }
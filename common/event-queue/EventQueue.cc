@@ -4,71 +4,238 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/EventQueue.hh"
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
 using namespace NetworkAnalytical;
 
-EventQueue::EventQueue() noexcept : current_time(0) {
-  // create empty event queue
-  event_queue = std::list<EventList>();
-}
+template <typename Scheduler>
+GenericEventQueue<Scheduler>::GenericEventQueue() noexcept
+    : current_time(0),
+      arena(),
+      event_queue(arena),
+      keyed_events(ArenaAllocator<Event>(&arena)),
+      keyed_events_sorted(true),
+      keyed_order(false),
+      event_dispatcher(nullptr),
+      scheduled_events_count(0) {}
 
-EventTime EventQueue::get_current_time() const noexcept {
+template <typename Scheduler>
+EventTime GenericEventQueue<Scheduler>::get_current_time() const noexcept {
   return current_time;
 }
 
-bool EventQueue::finished() const noexcept {
+template <typename Scheduler>
+bool GenericEventQueue<Scheduler>::finished() const noexcept {
   // check whether event queue is empty
   return event_queue.empty();
 }
 
-void EventQueue::proceed() noexcept {
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::proceed() noexcept {
   // to proceed, next event should exist
   assert(!finished());
 
-  // proceed to the next event time
-  auto& current_event_list = event_queue.front();
+  // check the validity and update current time;
+  // events may be scheduled at the current time between two proceed() calls
+  // (e.g., at time 0 before the simulation starts)
+  const auto next_event_time = event_queue.get_min_event_time();
+  assert(next_event_time >= current_time);
+  current_time = next_event_time;
+
+  // invoke events registered at the current time,
+  // including the ones newly scheduled at the current time while invoking
+  while (true) {
+    // unkeyed events are invoked in FIFO order,
+    // keyed ones are held back to be ordered by their keys
+    while (!event_queue.empty() &&
+           event_queue.get_min_event_time() == current_time) {
+      auto event = event_queue.pop();
+      if (!event.has_key()) {
+        // keyed events count as scheduled at the schedule time of their keys
+        invoke_keyed_events(event.get_schedule_time());
+        event.invoke_event(event_dispatcher);
+        continue;
+      }
+
+      // a lone keyed event has nothing to be ordered against
+      if (keyed_events.empty() &&
+          (event_queue.empty() ||
+           event_queue.get_min_event_time() != current_time)) {
+        event.invoke_event(event_dispatcher);
+        continue;
+      }
+
+      keyed_events.push_back(std::move(event));
+      keyed_events_sorted = false;
+    }
 
-  // check the validity and update current time
-  assert(current_event_list.get_event_time() > current_time);
-  current_time = current_event_list.get_event_time();
+    if (keyed_events.empty()) {
+      break;
+    }
 
-  // invoke events
-  current_event_list.invoke_events();
+    // sorting the whole batch at once is much cheaper than a heap operation
+    // per event; events invoked at the current time rarely schedule
+    // more keyed events at the current time, which are merged by resorting
+    if (!keyed_events_sorted) {
+      std::sort(keyed_events.begin(), keyed_events.end(), later);
+      keyed_events_sorted = true;
+    }
 
-  // drop processed event list
-  event_queue.pop_front();
+    // invoke the keyed event with the smallest key,
+    // which may schedule more events at the current time
+    auto event = std::move(keyed_events.back());
+    keyed_events.pop_back();
+    event.invoke_event(event_dispatcher);
+  }
 }
 
-void EventQueue::schedule_event(
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::schedule_event(
     const EventTime event_time,
     const Callback callback,
     const CallbackArg callback_arg) noexcept {
   // time should be at least larger than current time
   assert(event_time >= current_time);
 
-  // find the entry to insert event
-  auto event_list_it = event_queue.begin();
-  while (event_list_it != event_queue.end() &&
-         event_list_it->get_event_time() < event_time) {
-    event_list_it++;
+  // register the event to the scheduler
+  push_event(event_time, Event(callback, callback_arg));
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::schedule_event(
+    const EventTime event_time,
+    InlineCallback closure) noexcept {
+  // time should be at least larger than current time
+  assert(event_time >= current_time);
+
+  // register the event to the scheduler
+  push_event(event_time, Event(std::move(closure)));
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::schedule_event(
+    const EventTime event_time,
+    const EventKind kind,
+    void* const target) noexcept {
+  // time should be at least larger than current time
+  assert(event_time >= current_time);
+
+  // built-in events require a dispatcher
+  assert(event_dispatcher != nullptr);
+
+  // register the event to the scheduler
+  push_event(event_time, Event(kind, target));
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::schedule_event(
+    const EventTime event_time,
+    const EventKind kind,
+    void* const target,
+    const EventKey& key) noexcept {
+  // time should be at least larger than current time
+  assert(event_time >= current_time);
+  assert(key.origin_id >= 0);
+
+  // key is scheduled between now and the event
+  assert(current_time <= key.schedule_time);
+  assert(key.schedule_time <= event_time);
+
+  // built-in events require a dispatcher
+  assert(event_dispatcher != nullptr);
+
+  // keyed as of now: nothing to order against unless ordered by keys
+  if (!keyed_order && key.schedule_time == current_time) {
+    push_event(event_time, Event(kind, target));
+    return;
   }
 
-  // There can be three scenarios:
-  // (1) event list matching with event_time is found
-  // (2) there's no event list matching with event_time
-  //   (2-1) the event_time requested is
-  //   larger than the largest event time scheduled
-  //   (2-2) the event_time requested is
-  //   smaller than the largest event time scheduled
-  // for both (2-1) or (2-2), a new event should be created
-  if (event_list_it == event_queue.end() ||
-      event_time < event_list_it->get_event_time()) {
-    // insert new event_list
-    event_list_it = event_queue.insert(event_list_it, EventList(event_time));
+  // register the event to the scheduler
+  push_event(event_time, Event(kind, target, key));
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::schedule_events(
+    const EventKind kind,
+    const EventTime* const event_times,
+    void* const* const targets,
+    const size_t events_count) noexcept {
+  assert(events_count == 0 || (event_times != nullptr && targets != nullptr));
+
+  // built-in events require a dispatcher
+  assert(event_dispatcher != nullptr);
+
+  // register the events to the scheduler
+  for (auto i = size_t{0}; i < events_count; i++) {
+    // time should be at least larger than current time
+    assert(event_times[i] >= current_time);
+
+    push_event(event_times[i], Event(kind, targets[i]));
   }
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::set_keyed_order(
+    const bool keyed_order) noexcept {
+  this->keyed_order = keyed_order;
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::set_event_dispatcher(
+    const EventDispatcher dispatcher) noexcept {
+  assert(dispatcher != nullptr);
+
+  event_dispatcher = dispatcher;
+}
+
+template <typename Scheduler>
+const Arena& GenericEventQueue<Scheduler>::get_arena() const noexcept {
+  return arena;
+}
 
-  // now, whether (1) or (2), the entry to insert the event is found
-  // add event to event_list
-  event_list_it->add_event(callback, callback_arg);
+template <typename Scheduler>
+uint64_t GenericEventQueue<Scheduler>::get_scheduled_events_count()
+    const noexcept {
+  return scheduled_events_count;
 }
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::push_event(
+    const EventTime event_time,
+    Event event) noexcept {
+  // stamp the event to order it against the keyed events
+  event.set_schedule_time(current_time);
+
+  scheduled_events_count++;
+  event_queue.push(event_time, std::move(event));
+}
+
+template <typename Scheduler>
+void GenericEventQueue<Scheduler>::invoke_keyed_events(
+    const EventTime schedule_time) noexcept {
+  if (keyed_events.empty()) {
+    return;
+  }
+
+  if (!keyed_events_sorted) {
+    std::sort(keyed_events.begin(), keyed_events.end(), later);
+    keyed_events_sorted = true;
+  }
+
+  // events invoked here only schedule keyed events of later keys
+  while (!keyed_events.empty() &&
+         keyed_events.back().get_key().schedule_time < schedule_time) {
+    auto event = std::move(keyed_events.back());
+    keyed_events.pop_back();
+    event.invoke_event(event_dispatcher);
+  }
+}
+
+// explicitly instantiate supported policies
+template class NetworkAnalytical::GenericEventQueue<CalendarQueue>;
+template class NetworkAnalytical::GenericEventQueue<RadixHeapQueue>;
+template class NetworkAnalytical::GenericEventQueue<BinaryHeapQueue>;
+template class NetworkAnalytical::GenericEventQueue<PairingHeapQueue>;
+template class NetworkAnalytical::GenericEventQueue<SortedListQueue>;
@@ -0,0 +1,31 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/InlineCallback.hh"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+InlineCallback::InlineCallback() noexcept
+    : invoker(nullptr), relocator(nullptr), storage() {}
+
+InlineCallback::InlineCallback(
+    const Callback callback,
+    const CallbackArg callback_arg) noexcept
+    : InlineCallback([callback, callback_arg]() { (*callback)(callback_arg); }) {
+  assert(callback != nullptr);
+}
+
+void InlineCallback::operator()() noexcept {
+  // check the validity of the callback
+  assert(invoker != nullptr);
+
+  // invoke the stored callable
+  (*invoker)(storage);
+}
+
+InlineCallback::operator bool() const noexcept {
+  return invoker != nullptr;
+}
@@ -0,0 +1,134 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/PairingHeapQueue.hh"
+#include <cassert>
+#include <new>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+PairingHeapQueue::PairingHeapQueue(Arena& arena) noexcept
+    : arena(&arena),
+      root(nullptr),
+      next_sequence(0),
+      pairing_buffer(ArenaAllocator<Node*>(&arena)) {}
+
+PairingHeapQueue::~PairingHeapQueue() noexcept {
+  // release every remaining node
+  auto pending_nodes = std::vector<Node*>();
+  if (root != nullptr) {
+    pending_nodes.push_back(root);
+  }
+  while (!pending_nodes.empty()) {
+    auto* const node = pending_nodes.back();
+    pending_nodes.pop_back();
+    if (node->child != nullptr) {
+      pending_nodes.push_back(node->child);
+    }
+    if (node->sibling != nullptr) {
+      pending_nodes.push_back(node->sibling);
+    }
+    node->~Node();
+    arena->deallocate(node, sizeof(Node));
+  }
+}
+
+bool PairingHeapQueue::empty() const noexcept {
+  // check whether the heap has a root
+  return root == nullptr;
+}
+
+EventTime PairingHeapQueue::get_min_event_time() const noexcept {
+  assert(!empty());
+
+  // earliest event is at the root
+  return root->event_time;
+}
+
+void PairingHeapQueue::push(
+    const EventTime event_time,
+    Event event) noexcept {
+  // create a single-node heap and meld it
+  auto* const node = new (arena->allocate(sizeof(Node))) Node{
+      event_time,
+      next_sequence,
+      std::move(event),
+      nullptr,
+      nullptr};
+  root = meld(root, node);
+
+  // increment registration order
+  next_sequence++;
+}
+
+Event PairingHeapQueue::pop() noexcept {
+  assert(!empty());
+
+  // detach the root and meld its children
+  auto* const popped_root = root;
+  root = merge_pairs(popped_root->child);
+
+  // release the popped root
+  auto event = std::move(popped_root->event);
+  popped_root->~Node();
+  arena->deallocate(popped_root, sizeof(Node));
+
+  return event;
+}
+
+bool PairingHeapQueue::precedes(
+    const Node* const lhs,
+    const Node* const rhs) noexcept {
+  // compare event time first, then the registration order
+  if (lhs->event_time != rhs->event_time) {
+    return lhs->event_time < rhs->event_time;
+  }
+  return lhs->sequence < rhs->sequence;
+}
+
+PairingHeapQueue::Node* PairingHeapQueue::meld(
+    Node* const lhs,
+    Node* const rhs) noexcept {
+  if (lhs == nullptr) {
+    return rhs;
+  }
+  if (rhs == nullptr) {
+    return lhs;
+  }
+
+  // the later root becomes the leftmost child of the earlier root
+  auto* const parent = precedes(lhs, rhs) ? lhs : rhs;
+  auto* const child = (parent == lhs) ? rhs : lhs;
+  child->sibling = parent->child;
+  parent->child = child;
+  parent->sibling = nullptr;
+  return parent;
+}
+
+PairingHeapQueue::Node* PairingHeapQueue::merge_pairs(
+    Node* const first_child) noexcept {
+  // first pass: meld children pairwise from left to right
+  pairing_buffer.clear();
+  auto* node = first_child;
+  while (node != nullptr) {
+    auto* const first = node;
+    auto* const second = first->sibling;
+    node = (second != nullptr) ? second->sibling : nullptr;
+    first->sibling = nullptr;
+    if (second != nullptr) {
+      second->sibling = nullptr;
+    }
+    pairing_buffer.push_back(meld(first, second));
+  }
+
+  // second pass: meld the pairs from right to left
+  auto* merged = static_cast<Node*>(nullptr);
+  while (!pairing_buffer.empty()) {
+    merged = meld(pairing_buffer.back(), merged);
+    pairing_buffer.pop_back();
+  }
+  return merged;
+}
@@ -0,0 +1,134 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/RadixHeapQueue.hh"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+RadixHeapQueue::RadixHeapQueue(Arena& arena) noexcept
+    : front_index(0), entries_count(0), last_time(0) {
+  // allocate buckets from the arena
+  for (auto& bucket : buckets) {
+    bucket = Bucket(ArenaAllocator<Entry>(&arena));
+  }
+}
+
+bool RadixHeapQueue::empty() const noexcept {
+  // check whether any entry is registered
+  return entries_count == 0;
+}
+
+EventTime RadixHeapQueue::get_min_event_time() const noexcept {
+  assert(!empty());
+
+  // bucket 0 holds the events at the last popped time
+  if (front_index < buckets[0].size()) {
+    return last_time;
+  }
+
+  // otherwise, the earliest event is in the first non-empty bucket
+  const auto& bucket = buckets[first_non_empty_bucket()];
+  const auto min_entry = std::min_element(
+      bucket.begin(), bucket.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.event_time < rhs.event_time;
+      });
+  return min_entry->event_time;
+}
+
+void RadixHeapQueue::push(
+    const EventTime event_time,
+    Event event) noexcept {
+  // radix heap requires monotone event times
+  assert(event_time >= last_time);
+
+  // append the entry to its bucket
+  buckets[bucket_index(event_time)].push_back(
+      {event_time, std::move(event)});
+  entries_count++;
+}
+
+Event RadixHeapQueue::pop() noexcept {
+  assert(!empty());
+
+  // bucket 0 drained: bring the earliest events into bucket 0
+  if (front_index == buckets[0].size()) {
+    refill();
+  }
+
+  // dequeue the first entry of bucket 0
+  auto& bucket = buckets[0];
+  auto event = std::move(bucket[front_index].event);
+  front_index++;
+  entries_count--;
+
+  // reset the drained bucket, keeping its capacity
+  if (front_index == bucket.size()) {
+    bucket.clear();
+    front_index = 0;
+  }
+
+  return event;
+}
+
+size_t RadixHeapQueue::bucket_index(const EventTime event_time) const noexcept {
+  // events at the last popped time go to bucket 0
+  if (event_time == last_time) {
+    return 0;
+  }
+
+  // otherwise, index is the bit width of (event_time XOR last_time)
+  auto difference = event_time ^ last_time;
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(64 - __builtin_clzll(difference));
+#else
+  auto index = size_t{0};
+  while (difference != 0) {
+    difference >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+size_t RadixHeapQueue::first_non_empty_bucket() const noexcept {
+  for (size_t i = 1; i < buckets_count; i++) {
+    if (!buckets[i].empty()) {
+      return i;
+    }
+  }
+
+  // shouldn't reach here
+  assert(false);
+  return 0;
+}
+
+void RadixHeapQueue::refill() noexcept {
+  // bucket 0 should be drained
+  assert(front_index == 0 && buckets[0].empty());
+
+  // find the earliest event time
+  const auto index = first_non_empty_bucket();
+  auto& bucket = buckets[index];
+  auto min_time = bucket.front().event_time;
+  for (const auto& entry : bucket) {
+    min_time = std::min(min_time, entry.event_time);
+  }
+
+  // redistribute the bucket relative to the earliest event time,
+  // which preserves the registration order of the same event time
+  last_time = min_time;
+  for (auto& entry : bucket) {
+    const auto new_index = bucket_index(entry.event_time);
+    assert(new_index < index);
+    buckets[new_index].push_back(std::move(entry));
+  }
+
+  // return the buffer to the arena, so that capacity circulates
+  // between buckets instead of accumulating in each of them
+  Bucket(bucket.get_allocator()).swap(bucket);
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/SortedListQueue.hh"
+#include <cassert>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+SortedListQueue::SortedListQueue(Arena& arena) noexcept
+    : arena(&arena), event_lists(ArenaAllocator<EventList>(&arena)) {}
+
+bool SortedListQueue::empty() const noexcept {
+  // check whether the list is empty
+  return event_lists.empty();
+}
+
+EventTime SortedListQueue::get_min_event_time() const noexcept {
+  assert(!empty());
+
+  // earliest event list is the front one
+  return event_lists.front().get_event_time();
+}
+
+void SortedListQueue::push(
+    const EventTime event_time,
+    Event event) noexcept {
+  // find the entry to insert event
+  auto event_list_it = event_lists.begin();
+  while (event_list_it != event_lists.end() &&
+         event_list_it->get_event_time() < event_time) {
+    event_list_it++;
+  }
+
+  // There can be three scenarios:
+  // (1) event list matching with event_time is found
+  // (2) there's no event list matching with event_time
+  //   (2-1) the event_time requested is
+  //   larger than the largest event time scheduled
+  //   (2-2) the event_time requested is
+  //   smaller than the largest event time scheduled
+  // for both (2-1) or (2-2), a new event should be created
+  if (event_list_it == event_lists.end() ||
+      event_time < event_list_it->get_event_time()) {
+    // insert new event_list
+    event_list_it = event_lists.emplace(event_list_it, event_time, *arena);
+  }
+
+  // now, whether (1) or (2), the entry to insert the event is found
+  // add event to event_list
+  event_list_it->add_event(std::move(event));
+}
+
+Event SortedListQueue::pop() noexcept {
+  assert(!empty());
+
+  // dequeue the first event of the earliest event list
+  auto& event_list = event_lists.front();
+  auto event = event_list.pop_event();
+
+  // drop the drained event list
+  if (event_list.empty()) {
+    event_lists.pop_front();
+  }
+
+  return event;
+}
@@ -28,19 +28,23 @@ FullyConnected::FullyConnected(
       }
     }
   }
+
+  // construct the links
+  build_adjacency();
 }
 
-Route FullyConnected::route(const DeviceId src, const DeviceId dest)
-    const noexcept {
+Route FullyConnected::construct_route(
+    const DeviceId src,
+    const DeviceId dest) const noexcept {
   // assert npus are in valid range
   assert(0 <= src && src < npus_count);
   assert(0 <= dest && dest < npus_count);
 
   // construct route
   // directly connected
-  auto route = Route();
-  route.push_back(devices[src]);
-  route.push_back(devices[dest]);
+  auto route = Route(devices.data());
+  route.push_back(src);
+  route.push_back(dest);
 
   return route;
 }
@@ -23,16 +23,23 @@ Ring::Ring(
   for (auto i = 0; i < npus_count - 1; i++) {
     connect(i, i + 1, bandwidth, latency, bidirectional);
   }
-  connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+
+  // close the ring, unless the two NPUs are already connected both ways
+  if (npus_count > 2 || !bidirectional) {
+    connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+  }
+
+  // construct the links
+  build_adjacency();
 }
 
-Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
+Route Ring::construct_route(DeviceId src, DeviceId dest) const noexcept {
   // assert npus are in valid range
   assert(0 <= src && src < npus_count);
   assert(0 <= dest && dest < npus_count);
 
   // construct empty route
-  auto route = Route();
+  auto route = Route(devices.data());
 
   auto step = 1; // default direction: clockwise
   if (bidirectional) {
@@ -53,7 +60,7 @@ Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
   auto current = src;
   while (current != dest) {
     // traverse the ring until reaches dest
-    route.push_back(devices[current]);
+    route.push_back(current);
     current = (current + step);
 
     // wrap around
@@ -65,7 +72,7 @@ Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
   }
 
   // arrives at dest
-  route.push_back(devices[dest]);
+  route.push_back(dest);
 
   // return the constructed route
   return route;
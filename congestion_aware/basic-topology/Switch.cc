@@ -26,19 +26,22 @@ Switch::Switch(
   for (auto i = 0; i < npus_count; i++) {
     connect(i, switch_id, bandwidth, latency, true);
   }
+
+  // construct the links
+  build_adjacency();
 }
 
-Route Switch::route(DeviceId src, DeviceId dest) const noexcept {
+Route Switch::construct_route(DeviceId src, DeviceId dest) const noexcept {
   // assert npus are in valid range
   assert(0 <= src && src < npus_count);
   assert(0 <= dest && dest < npus_count);
 
   // construct route
   // start at source, and go to switch, then go to destination
-  auto route = Route();
-  route.push_back(devices[src]);
-  route.push_back(devices[switch_id]);
-  route.push_back(devices[dest]);
+  auto route = Route(devices.data());
+  route.push_back(src);
+  route.push_back(switch_id);
+  route.push_back(dest);
 
   return route;
 }
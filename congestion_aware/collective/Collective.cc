@@ -0,0 +1,509 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Collective.hh"
+#include <cassert>
+#include <cstdint>
+#include "common/NetworkFunction.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Get the base-2 logarithm of a power of 2.
+ *
+ * @param value power of 2
+ * @return log2(value)
+ */
+int log2_exact(const int value) noexcept {
+  assert(value > 0 && (value & (value - 1)) == 0);
+
+  auto exponent = 0;
+  while ((1 << exponent) < value) {
+    exponent++;
+  }
+  return exponent;
+}
+
+} // namespace
+
+Collective::Collective(
+    std::shared_ptr<Topology> topology,
+    const CollectiveType type,
+    const ChunkSize collective_size,
+    std::vector<CollectiveAlgorithm> algorithm_per_dim,
+    const DeviceId root) noexcept
+    : topology(std::move(topology)),
+      steps_count(0),
+      pending_transfers_count(0),
+      start_time(0),
+      finish_time(0) {
+  assert(this->topology != nullptr);
+  assert(collective_size > 0);
+
+  event_queue = this->topology->get_event_queue();
+  assert(event_queue != nullptr);
+
+  // topology shape
+  npus_count = this->topology->get_npus_count();
+  npus_count_per_dim = this->topology->get_npus_count_per_dim();
+  const auto dims_count = this->topology->get_dims_count();
+  assert(algorithm_per_dim.size() == static_cast<size_t>(dims_count));
+  assert(0 <= root && root < npus_count);
+
+  // NPU ids are mixed-radix, with dimension 0 varying the fastest
+  auto stride = 1;
+  for (const auto npus_count_of_dim : npus_count_per_dim) {
+    stride_per_dim.push_back(stride);
+    stride *= npus_count_of_dim;
+  }
+  assert(stride == npus_count);
+
+  // size of the data of each NPU before the phase of each dimension,
+  // as scattered by the Reduce-Scatter phases of the previous dimensions
+  auto scattered_size_per_dim = std::vector<ChunkSize>();
+  auto scattered_npus_count = uint64_t{1};
+  for (auto dim = 0; dim < dims_count; dim++) {
+    scattered_size_per_dim.push_back(
+        split_size(collective_size, scattered_npus_count));
+    scattered_npus_count *= npus_count_per_dim[dim];
+  }
+
+  // compile the phases
+  switch (type) {
+    case CollectiveType::AllReduce:
+      for (auto dim = 0; dim < dims_count; dim++) {
+        add_reduce_scatter(
+            dim, algorithm_per_dim[dim], scattered_size_per_dim[dim]);
+      }
+      for (auto dim = dims_count - 1; dim >= 0; dim--) {
+        add_all_gather(
+            dim, algorithm_per_dim[dim], scattered_size_per_dim[dim]);
+      }
+      break;
+    case CollectiveType::ReduceScatter:
+      for (auto dim = 0; dim < dims_count; dim++) {
+        add_reduce_scatter(
+            dim, algorithm_per_dim[dim], scattered_size_per_dim[dim]);
+      }
+      break;
+    case CollectiveType::AllGather:
+      for (auto dim = dims_count - 1; dim >= 0; dim--) {
+        add_all_gather(
+            dim, algorithm_per_dim[dim], scattered_size_per_dim[dim]);
+      }
+      break;
+    case CollectiveType::AllToAll:
+      for (auto dim = 0; dim < dims_count; dim++) {
+        add_all_to_all(dim, algorithm_per_dim[dim], collective_size);
+      }
+      break;
+    case CollectiveType::Broadcast:
+      for (auto dim = 0; dim < dims_count; dim++) {
+        add_broadcast(dim, algorithm_per_dim[dim], collective_size, root);
+      }
+      break;
+    default:
+      // shouldn't reach here
+      assert(false);
+  }
+
+  build_steps();
+}
+
+Collective::Collective(
+    std::shared_ptr<Topology> topology,
+    const CollectiveType type,
+    const ChunkSize collective_size,
+    const CollectiveAlgorithm algorithm,
+    const DeviceId root) noexcept
+    : Collective(
+          topology,
+          type,
+          collective_size,
+          std::vector<CollectiveAlgorithm>(
+              topology->get_dims_count(), algorithm),
+          root) {}
+
+void Collective::start(InlineCallback callback) noexcept {
+  // a collective runs once at a time
+  assert(finished());
+
+  // reset the dependencies
+  pending_receives = receives_count;
+  next_step.assign(npus_count, 0);
+  pending_transfers_count = static_cast<int>(transfers.size());
+  start_time = event_queue->get_current_time();
+  finish_time = start_time;
+  this->callback = std::move(callback);
+
+  // nothing to send, e.g., on a single NPU
+  if (pending_transfers_count == 0) {
+    if (this->callback) {
+      this->callback();
+    }
+    return;
+  }
+
+  // issue the steps without dependencies
+  for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+    advance(npu_id);
+  }
+}
+
+bool Collective::finished() const noexcept {
+  return pending_transfers_count == 0;
+}
+
+EventTime Collective::get_start_time() const noexcept {
+  return start_time;
+}
+
+EventTime Collective::get_finish_time() const noexcept {
+  return finish_time;
+}
+
+EventTime Collective::get_duration() const noexcept {
+  return finish_time - start_time;
+}
+
+int Collective::get_steps_count() const noexcept {
+  return steps_count;
+}
+
+int Collective::get_transfers_count() const noexcept {
+  return static_cast<int>(transfers.size());
+}
+
+DeviceId Collective::peer(
+    const DeviceId npu_id,
+    const int dim,
+    const int rank) const noexcept {
+  assert(0 <= rank && rank < npus_count_per_dim[dim]);
+
+  // replace the coordinate of the dimension
+  return npu_id + ((rank - this->rank(npu_id, dim)) * stride_per_dim[dim]);
+}
+
+int Collective::rank(const DeviceId npu_id, const int dim) const noexcept {
+  assert(0 <= npu_id && npu_id < npus_count);
+  assert(0 <= dim && static_cast<size_t>(dim) < npus_count_per_dim.size());
+
+  return (npu_id / stride_per_dim[dim]) % npus_count_per_dim[dim];
+}
+
+int Collective::slot(const DeviceId npu_id, const int step) const noexcept {
+  assert(0 <= npu_id && npu_id < npus_count);
+  assert(0 <= step && step < steps_count);
+
+  // NPUs progress at a similar pace, so their slots of a step are adjacent
+  return (step * npus_count) + npu_id;
+}
+
+void Collective::add_reduce_scatter(
+    const int dim,
+    const CollectiveAlgorithm algorithm,
+    const ChunkSize size) noexcept {
+  const auto p = npus_count_per_dim[dim];
+  if (p == 1) {
+    return;
+  }
+
+  const auto first_step = steps_count;
+  switch (algorithm) {
+    case CollectiveAlgorithm::Ring:
+      // pass a 1/p of the data to the next NPU, reducing it at each step
+      for (auto step = 0; step < p - 1; step++) {
+        for (auto src = 0; src < npus_count; src++) {
+          const auto dest = peer(src, dim, (rank(src, dim) + 1) % p);
+          add_transfer(src, first_step + step, dest, split_size(size, p));
+        }
+      }
+      steps_count += p - 1;
+      break;
+    case CollectiveAlgorithm::Direct:
+      // send the 1/p of the data reduced by each other NPU,
+      // in a rotated order so no NPU receives from every other NPU at once
+      for (auto src = 0; src < npus_count; src++) {
+        for (auto offset = 1; offset < p; offset++) {
+          const auto dest = peer(src, dim, (rank(src, dim) + offset) % p);
+          add_transfer(src, first_step, dest, split_size(size, p));
+        }
+      }
+      steps_count += 1;
+      break;
+    case CollectiveAlgorithm::HalvingDoubling: {
+      // recursive halving: exchange half of the data at halving distances
+      const auto steps = log2_exact(p);
+      for (auto step = 0; step < steps; step++) {
+        for (auto src = 0; src < npus_count; src++) {
+          const auto distance = p >> (step + 1);
+          const auto dest = peer(src, dim, rank(src, dim) ^ distance);
+          const auto chunk_size = split_size(size, uint64_t{2} << step);
+          add_transfer(src, first_step + step, dest, chunk_size);
+        }
+      }
+      steps_count += steps;
+      break;
+    }
+    default:
+      // shouldn't reach here
+      assert(false);
+  }
+}
+
+void Collective::add_all_gather(
+    const int dim,
+    const CollectiveAlgorithm algorithm,
+    const ChunkSize size) noexcept {
+  const auto p = npus_count_per_dim[dim];
+  if (p == 1) {
+    return;
+  }
+
+  const auto first_step = steps_count;
+  switch (algorithm) {
+    case CollectiveAlgorithm::Ring:
+      // forward a 1/p of the data to the next NPU at each step
+      for (auto step = 0; step < p - 1; step++) {
+        for (auto src = 0; src < npus_count; src++) {
+          const auto dest = peer(src, dim, (rank(src, dim) + 1) % p);
+          add_transfer(src, first_step + step, dest, split_size(size, p));
+        }
+      }
+      steps_count += p - 1;
+      break;
+    case CollectiveAlgorithm::Direct:
+      // send the own 1/p of the data to each other NPU
+      for (auto src = 0; src < npus_count; src++) {
+        for (auto offset = 1; offset < p; offset++) {
+          const auto dest = peer(src, dim, (rank(src, dim) + offset) % p);
+          add_transfer(src, first_step, dest, split_size(size, p));
+        }
+      }
+      steps_count += 1;
+      break;
+    case CollectiveAlgorithm::HalvingDoubling: {
+      // recursive doubling: exchange the gathered data at doubling distances
+      const auto steps = log2_exact(p);
+      for (auto step = 0; step < steps; step++) {
+        for (auto src = 0; src < npus_count; src++) {
+          const auto distance = 1 << step;
+          const auto dest = peer(src, dim, rank(src, dim) ^ distance);
+          add_transfer(
+              src, first_step + step, dest, split_size(size, p >> step));
+        }
+      }
+      steps_count += steps;
+      break;
+    }
+    default:
+      // shouldn't reach here
+      assert(false);
+  }
+}
+
+void Collective::add_all_to_all(
+    const int dim,
+    const CollectiveAlgorithm algorithm,
+    const ChunkSize size) noexcept {
+  const auto p = npus_count_per_dim[dim];
+  if (p == 1) {
+    return;
+  }
+
+  const auto first_step = steps_count;
+  switch (algorithm) {
+    case CollectiveAlgorithm::Ring:
+      // pairwise exchange: send to the NPU (step + 1) away at each step
+      for (auto step = 0; step < p - 1; step++) {
+        for (auto src = 0; src < npus_count; src++) {
+          const auto dest = peer(src, dim, (rank(src, dim) + step + 1) % p);
+          add_transfer(src, first_step + step, dest, split_size(size, p));
+        }
+      }
+      steps_count += p - 1;
+      break;
+    case CollectiveAlgorithm::Direct:
+      // send the 1/p of the data of each other NPU at once
+      for (auto src = 0; src < npus_count; src++) {
+        for (auto offset = 1; offset < p; offset++) {
+          const auto dest = peer(src, dim, (rank(src, dim) + offset) % p);
+          add_transfer(src, first_step, dest, split_size(size, p));
+        }
+      }
+      steps_count += 1;
+      break;
+    default:
+      // HalvingDoubling isn't supported for All-to-All
+      assert(false);
+  }
+}
+
+void Collective::add_broadcast(
+    const int dim,
+    const CollectiveAlgorithm algorithm,
+    const ChunkSize size,
+    const DeviceId root) noexcept {
+  const auto p = npus_count_per_dim[dim];
+  if (p == 1) {
+    return;
+  }
+
+  // the lines holding the data: those of the root in the later dimensions
+  const auto root_rank = rank(root, dim);
+  const auto line_stride = stride_per_dim[dim] * p;
+  auto line_roots = std::vector<DeviceId>();
+  for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+    if (rank(npu_id, dim) == root_rank &&
+        npu_id / line_stride == root / line_stride) {
+      line_roots.push_back(npu_id);
+    }
+  }
+
+  const auto first_step = steps_count;
+  switch (algorithm) {
+    case CollectiveAlgorithm::Ring:
+      // pass the data along the ring, starting from the root
+      for (const auto line_root : line_roots) {
+        for (auto step = 0; step < p - 1; step++) {
+          const auto src = peer(line_root, dim, (root_rank + step) % p);
+          const auto dest = peer(line_root, dim, (root_rank + step + 1) % p);
+          add_transfer(src, first_step + step, dest, size);
+        }
+      }
+      steps_count += p - 1;
+      break;
+    case CollectiveAlgorithm::Direct:
+      // the root sends the data to every other NPU
+      for (const auto line_root : line_roots) {
+        for (auto r = 0; r < p; r++) {
+          if (r != root_rank) {
+            add_transfer(line_root, first_step, peer(line_root, dim, r), size);
+          }
+        }
+      }
+      steps_count += 1;
+      break;
+    case CollectiveAlgorithm::HalvingDoubling: {
+      // binomial tree: the NPUs holding the data double at each step
+      auto step = 0;
+      for (; (1 << step) < p; step++) {
+        const auto distance = 1 << step;
+        for (const auto line_root : line_roots) {
+          for (auto offset = 0; offset < distance && offset + distance < p;
+               offset++) {
+            const auto src = peer(line_root, dim, (root_rank + offset) % p);
+            const auto dest =
+                peer(line_root, dim, (root_rank + offset + distance) % p);
+            add_transfer(src, first_step + step, dest, size);
+          }
+        }
+      }
+      steps_count += step;
+      break;
+    }
+    default:
+      // shouldn't reach here
+      assert(false);
+  }
+}
+
+void Collective::add_transfer(
+    const DeviceId src,
+    const int step,
+    const DeviceId dest,
+    const ChunkSize size) noexcept {
+  assert(0 <= src && src < npus_count);
+  assert(0 <= dest && dest < npus_count);
+  assert(src != dest);
+  assert(step >= 0);
+
+  step_transfers.push_back({step, {src, dest, size, 0}});
+}
+
+void Collective::build_steps() noexcept {
+  // count the transfers of each (step, src) and (step, dest)
+  const auto slots_count = npus_count * steps_count;
+  offsets.assign(slots_count + 1, 0);
+  receives_count.assign(slots_count, 0);
+  for (const auto& step_transfer : step_transfers) {
+    const auto step = step_transfer.step;
+    offsets[slot(step_transfer.transfer.src, step) + 1]++;
+    receives_count[slot(step_transfer.transfer.dest, step)]++;
+  }
+  for (auto i = 0; i < slots_count; i++) {
+    offsets[i + 1] += offsets[i];
+  }
+
+  // place the transfers, keeping their compiled order within a slot,
+  // tagged with the slot of their (dest, step)
+  transfers.resize(step_transfers.size());
+  auto next_index = std::vector<int>(offsets.begin(), offsets.end() - 1);
+  for (const auto& step_transfer : step_transfers) {
+    const auto step = step_transfer.step;
+    const auto index = slot(step_transfer.transfer.src, step);
+    auto& transfer = transfers[next_index[index]];
+    transfer = step_transfer.transfer;
+    transfer.tag = static_cast<uint64_t>(slot(transfer.dest, step));
+    next_index[index]++;
+  }
+
+  // the compiled transfers are no longer needed
+  step_transfers.clear();
+  step_transfers.shrink_to_fit();
+}
+
+void Collective::advance(const DeviceId npu_id) noexcept {
+  auto& step = next_step[npu_id];
+
+  while (step < steps_count) {
+    // wait until every transfer of the previous step arrived
+    if (step > 0 && pending_receives[slot(npu_id, step - 1)] > 0) {
+      return;
+    }
+
+    // issue the transfers of the step at once
+    const auto index = slot(npu_id, step);
+    topology->send_batch(
+        transfers.data() + offsets[index],
+        offsets[index + 1] - offsets[index],
+        chunk_arrived,
+        this);
+    step++;
+  }
+}
+
+void Collective::chunk_arrived(
+    void* const collective_ptr,
+    const uint64_t tag) noexcept {
+  assert(collective_ptr != nullptr);
+
+  auto* const collective = static_cast<Collective*>(collective_ptr);
+  collective->transfer_arrived(static_cast<int>(tag));
+}
+
+void Collective::transfer_arrived(const int receive_slot) noexcept {
+  assert(0 <= receive_slot);
+  assert(static_cast<size_t>(receive_slot) < pending_receives.size());
+  assert(pending_transfers_count > 0);
+
+  pending_receives[receive_slot]--;
+  pending_transfers_count--;
+
+  // the NPU may proceed to its next steps
+  advance(receive_slot % npus_count); // dest of the slot
+
+  // every transfer arrived
+  if (pending_transfers_count == 0) {
+    finish_time = event_queue->get_current_time();
+    if (callback) {
+      auto finished_callback = std::move(callback);
+      finished_callback();
+    }
+  }
+}
@@ -0,0 +1,274 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/FlowSimulation.hh"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "common/NetworkFunction.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// relative tolerance of fair shares saturated in the same round
+constexpr double share_tolerance = 1e-9;
+
+} // namespace
+
+FlowSimulation::FlowSimulation(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)),
+      next_flow_id(0),
+      last_update_time(0),
+      epoch(0),
+      update_pending(false),
+      rate_updates_count(0) {
+  assert(this->topology != nullptr);
+
+  event_queue = this->topology->get_event_queue();
+  assert(event_queue != nullptr);
+  last_update_time = event_queue->get_current_time();
+
+  // capacity of every link of the topology
+  const auto links_count = this->topology->get_links_count();
+  link_capacities.resize(links_count);
+  for (auto i = 0; i < this->topology->get_devices_count(); i++) {
+    const auto device = this->topology->get_device(i);
+    for (auto j = 0; j < device->get_links_count(); j++) {
+      const auto bandwidth = device->get_link_at(j)->get_bandwidth();
+      const auto link_id = this->topology->get_link_id(i, j);
+      link_capacities[link_id] = bw_GBps_to_Bpns(bandwidth);
+    }
+  }
+
+  // scratch of the progressive filling
+  residual_capacities.resize(links_count, 0.0);
+  unassigned_counts.resize(links_count, 0);
+  link_flows.resize(links_count);
+}
+
+void FlowSimulation::send(
+    const ChunkSize message_size,
+    const Route& route,
+    const Callback callback,
+    const CallbackArg callback_arg) noexcept {
+  send(message_size, route, InlineCallback(callback, callback_arg));
+}
+
+void FlowSimulation::send(
+    const ChunkSize message_size,
+    const Route& route,
+    InlineCallback callback) noexcept {
+  // a flow crosses at least one link
+  assert(route.size() >= 2);
+
+  // the active flows transmitted at their old rates until now
+  advance();
+
+  // take a free slot, keeping the link buffer of its previous flow
+  auto slot = 0;
+  if (free_slots.empty()) {
+    slot = static_cast<int>(flows.size());
+    flows.emplace_back();
+  } else {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  }
+
+  // resolve the links of the route
+  auto& flow = flows[slot];
+  flow.flow_id = next_flow_id++;
+  flow.link_ids.clear();
+  auto latency = 0.0;
+  for (auto hop = 0; hop < route.size() - 1; hop++) {
+    const auto link_index = route.link_index(hop);
+    assert(link_index >= 0);
+    flow.link_ids.push_back(topology->get_link_id(route[hop], link_index));
+    latency += route.device(hop)->get_link_at(link_index)->get_latency();
+  }
+  flow.remaining_bytes = static_cast<double>(message_size);
+  flow.rate = 0.0;
+  flow.latency = static_cast<EventTime>(latency);
+  flow.callback = std::move(callback);
+  active_slots.push_back(slot);
+
+  // flows started at the same time share one rate update
+  if (!update_pending) {
+    update_pending = true;
+    event_queue->schedule_event(event_queue->get_current_time(), [this]() {
+      update_pending = false;
+      advance();
+      update_rates();
+    });
+  }
+}
+
+int FlowSimulation::get_active_flows_count() const noexcept {
+  return static_cast<int>(active_slots.size());
+}
+
+Bandwidth FlowSimulation::get_flow_rate(const uint64_t flow_id) const noexcept {
+  for (const auto slot : active_slots) {
+    const auto& flow = flows[slot];
+    if (flow.flow_id == flow_id) {
+      return bw_Bpns_to_GBps(std::max(flow.rate, 0.0));
+    }
+  }
+
+  // not active
+  return 0.0;
+}
+
+uint64_t FlowSimulation::get_rate_updates_count() const noexcept {
+  return rate_updates_count;
+}
+
+void FlowSimulation::advance() noexcept {
+  const auto current_time = event_queue->get_current_time();
+  assert(current_time >= last_update_time);
+
+  const auto elapsed = static_cast<double>(current_time - last_update_time);
+  if (elapsed > 0) {
+    for (const auto slot : active_slots) {
+      auto& flow = flows[slot];
+      flow.remaining_bytes -= flow.rate * elapsed;
+    }
+  }
+
+  last_update_time = current_time;
+}
+
+void FlowSimulation::update_rates() noexcept {
+  // invalidate the drain event scheduled with the old rates
+  epoch++;
+
+  if (active_slots.empty()) {
+    return;
+  }
+
+  assign_rates();
+  rate_updates_count++;
+  schedule_drain();
+}
+
+void FlowSimulation::assign_rates() noexcept {
+  // register every active flow to the links it crosses
+  used_links.clear();
+  for (const auto slot : active_slots) {
+    auto& flow = flows[slot];
+    flow.rate = -1.0;
+    for (const auto link_id : flow.link_ids) {
+      if (unassigned_counts[link_id] == 0) {
+        used_links.push_back(link_id);
+        residual_capacities[link_id] = link_capacities[link_id];
+        link_flows[link_id].clear();
+      }
+      unassigned_counts[link_id]++;
+      link_flows[link_id].push_back(slot);
+    }
+  }
+
+  // progressive filling
+  auto unassigned_flows_count = active_slots.size();
+  while (unassigned_flows_count > 0) {
+    // smallest fair share among the links with unassigned flows,
+    // dropping the links whose flows are all assigned
+    auto fair_share = std::numeric_limits<double>::infinity();
+    auto kept_links_count = size_t{0};
+    for (const auto link_id : used_links) {
+      const auto count = unassigned_counts[link_id];
+      if (count > 0) {
+        const auto share = residual_capacities[link_id] / count;
+        fair_share = std::min(fair_share, share);
+        used_links[kept_links_count] = link_id;
+        kept_links_count++;
+      }
+    }
+    used_links.resize(kept_links_count);
+    assert(!used_links.empty());
+    fair_share = std::max(fair_share, 0.0);
+
+    // saturate every bottleneck link (i.e., with the smallest fair share):
+    // its unassigned flows get the fair share,
+    // which is taken from the other links they cross
+    const auto threshold = fair_share * (1 + share_tolerance);
+    for (const auto bottleneck : used_links) {
+      const auto count = unassigned_counts[bottleneck];
+      if (count == 0 || residual_capacities[bottleneck] > threshold * count) {
+        continue;
+      }
+
+      for (const auto slot : link_flows[bottleneck]) {
+        auto& flow = flows[slot];
+        if (flow.rate >= 0) {
+          continue;
+        }
+
+        flow.rate = fair_share;
+        unassigned_flows_count--;
+        for (const auto link_id : flow.link_ids) {
+          residual_capacities[link_id] -= fair_share;
+          unassigned_counts[link_id]--;
+        }
+      }
+    }
+  }
+
+  // every count is back to 0 for the next assignment
+}
+
+void FlowSimulation::schedule_drain() noexcept {
+  // earliest drain under the current rates
+  auto min_time = std::numeric_limits<double>::infinity();
+  for (const auto slot : active_slots) {
+    const auto& flow = flows[slot];
+    assert(flow.rate > 0);
+    min_time = std::min(min_time, flow.remaining_bytes / flow.rate);
+  }
+
+  // round up, so the earliest flow is fully transmitted at the event
+  const auto delay =
+      static_cast<EventTime>(std::ceil(std::max(min_time, 0.0)));
+  const auto drain_time = event_queue->get_current_time() + delay;
+  const auto scheduled_epoch = epoch;
+  event_queue->schedule_event(drain_time, [this, scheduled_epoch]() {
+    drain(scheduled_epoch);
+  });
+}
+
+void FlowSimulation::drain(const uint64_t epoch) noexcept {
+  // the rates changed since the event was scheduled
+  if (epoch != this->epoch) {
+    return;
+  }
+
+  advance();
+
+  // finish the flows transmitted up to the current time, i.e.,
+  // with less than half a ns of transmission left (time resolution is 1 ns)
+  const auto current_time = event_queue->get_current_time();
+  auto i = size_t{0};
+  while (i < active_slots.size()) {
+    const auto slot = active_slots[i];
+    auto& flow = flows[slot];
+    if (flow.remaining_bytes > flow.rate * 0.5) {
+      i++;
+      continue;
+    }
+
+    // the message arrives dest after the latency of the route
+    event_queue->schedule_event(
+        current_time + flow.latency, std::move(flow.callback));
+
+    // release the slot
+    active_slots[i] = active_slots.back();
+    active_slots.pop_back();
+    free_slots.push_back(slot);
+  }
+
+  update_rates();
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/MultiDimTopology.hh"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+MultiDimTopology::MultiDimTopology(
+    std::vector<std::unique_ptr<BasicTopology>> topology_per_dim) noexcept
+    : Topology(), topology_per_dim(std::move(topology_per_dim)) {
+  assert(!this->topology_per_dim.empty());
+
+  // initialize topology shape
+  npus_count = 1;
+  dims_count = static_cast<int>(this->topology_per_dim.size());
+  for (const auto& topology : this->topology_per_dim) {
+    const auto topology_size = topology->get_npus_count();
+    stride_per_dim.push_back(npus_count);
+    npus_count *= topology_size;
+    npus_count_per_dim.push_back(topology_size);
+    bandwidth_per_dim.push_back(topology->get_bandwidth_per_dim()[0]);
+  }
+
+  // non-NPU devices of each line follow the NPUs, dimension by dimension
+  devices_count = npus_count;
+  for (const auto& topology : this->topology_per_dim) {
+    const auto topology_size = topology->get_npus_count();
+    const auto lines_count = npus_count / topology_size;
+    const auto extra_devices_count =
+        topology->get_devices_count() - topology_size;
+    first_device_id_per_dim.push_back(devices_count);
+    devices_count += lines_count * extra_devices_count;
+  }
+
+  // instantiate devices
+  instantiate_devices();
+
+  // connect every line of each dimension
+  for (auto dim = 0; dim < dims_count; dim++) {
+    connect_dimension(dim);
+  }
+
+  // construct the links
+  build_adjacency();
+}
+
+Route MultiDimTopology::construct_route(
+    const DeviceId src,
+    const DeviceId dest) const noexcept {
+  // assert npus are in valid range
+  assert(0 <= src && src < npus_count);
+  assert(0 <= dest && dest < npus_count);
+
+  // translate src and dest to multi-dim address
+  const auto src_address = translate_address(src);
+  const auto dest_address = translate_address(dest);
+
+  // construct the route
+  auto route = Route(devices.data());
+  route.push_back(src);
+
+  // dimension-order routing:
+  // move along each dimension where the addresses differ
+  auto current = src;
+  for (auto dim = 0; dim < dims_count; dim++) {
+    if (src_address[dim] == dest_address[dim]) {
+      continue;
+    }
+
+    // route within the line of the current NPU
+    const auto& topology = topology_per_dim[dim];
+    const auto local_route =
+        topology->construct_route(src_address[dim], dest_address[dim]);
+    for (auto hop = 1; hop < local_route.size(); hop++) {
+      route.push_back(translate_device_id(local_route[hop], current, dim));
+    }
+
+    // arrives at the dest coordinate of this dimension
+    current = translate_device_id(dest_address[dim], current, dim);
+  }
+
+  // arrives at dest
+  assert(current == dest);
+
+  // return the constructed route
+  return route;
+}
+
+MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(
+    const DeviceId npu_id) const noexcept {
+  // If units-count if [2, 8, 4], and the given id is 47, then the id should be
+  // 47 // 16 = 2, leftover = 47 % 16 = 15
+  // 15 // 2 = 7, leftover = 15 % 2 = 1
+  // 1 // 1 = 1, leftover = 0
+  // therefore the address is [1, 7, 2]
+
+  // create empty address
+  auto multi_dim_address = MultiDimAddress(dims_count, -1);
+
+  auto leftover = npu_id;
+  auto denominator = npus_count;
+
+  for (auto dim = dims_count - 1; dim >= 0; dim--) {
+    // change denominator
+    denominator /= npus_count_per_dim[dim];
+
+    // get and update address
+    const auto quotient = leftover / denominator;
+    leftover %= denominator;
+
+    // update address
+    multi_dim_address[dim] = quotient;
+  }
+
+  // check address translation
+  for (auto i = 0; i < dims_count; i++) {
+    assert(0 <= multi_dim_address[i]);
+    assert(multi_dim_address[i] < npus_count_per_dim[i]);
+  }
+
+  // return retrieved address
+  return multi_dim_address;
+}
+
+int MultiDimTopology::line_index(
+    const DeviceId npu_id,
+    const int dim) const noexcept {
+  assert(0 <= npu_id && npu_id < npus_count);
+  assert(0 <= dim && dim < dims_count);
+
+  // drop the coordinate of the dimension from the NPU id
+  const auto stride = stride_per_dim[dim];
+  const auto lower = npu_id % stride;
+  const auto upper = npu_id / (stride * npus_count_per_dim[dim]);
+  return lower + (upper * stride);
+}
+
+DeviceId MultiDimTopology::translate_device_id(
+    const DeviceId local_id,
+    const DeviceId npu_id,
+    const int dim) const noexcept {
+  assert(0 <= npu_id && npu_id < npus_count);
+  assert(0 <= dim && dim < dims_count);
+  assert(local_id >= 0);
+
+  // NPU: replace the coordinate of the dimension
+  const auto topology_size = npus_count_per_dim[dim];
+  const auto stride = stride_per_dim[dim];
+  if (local_id < topology_size) {
+    const auto coordinate = (npu_id / stride) % topology_size;
+    return npu_id + ((local_id - coordinate) * stride);
+  }
+
+  // non-NPU device: owned by the line
+  const auto extra_devices_count =
+      topology_per_dim[dim]->get_devices_count() - topology_size;
+  const auto line_offset = line_index(npu_id, dim) * extra_devices_count;
+  return first_device_id_per_dim[dim] + line_offset +
+      (local_id - topology_size);
+}
+
+void MultiDimTopology::connect_dimension(const int dim) noexcept {
+  assert(0 <= dim && dim < dims_count);
+
+  const auto& topology = topology_per_dim[dim];
+  const auto bandwidth = bandwidth_per_dim[dim];
+  const auto local_devices_count = topology->get_devices_count();
+
+  // every line replicates the links of the BasicTopology
+  const auto stride = stride_per_dim[dim];
+  const auto lines_count = npus_count / npus_count_per_dim[dim];
+  for (auto line = 0; line < lines_count; line++) {
+    // first NPU of the line, i.e., its coordinate of the dimension is 0
+    const auto lower = line % stride;
+    const auto upper = line / stride;
+    const auto npu_id = lower + (upper * stride * npus_count_per_dim[dim]);
+
+    for (auto local_src = 0; local_src < local_devices_count; local_src++) {
+      const auto device = topology->get_device(local_src);
+      const auto src = translate_device_id(local_src, npu_id, dim);
+      for (auto i = 0; i < device->get_links_count(); i++) {
+        const auto local_dest = device->get_link_dest(i);
+        const auto latency = device->get_link_at(i)->get_latency();
+        const auto dest = translate_device_id(local_dest, npu_id, dim);
+        connect(src, dest, bandwidth, latency, false);
+      }
+    }
+  }
+}
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Chunk.hh"
 #include <cassert>
+#include "congestion_aware/ChunkPool.hh"
 #include "congestion_aware/Device.hh"
 #include "congestion_aware/Link.hh"
 
@@ -25,40 +26,92 @@ void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     chunk->invoke_callback();
   } else {
     // send this chunk to next dest
-    const auto current_node = chunk->current_device();
+    auto* const current_node = chunk->current_device();
     current_node->send(std::move(chunk)); // send chunk to next des
   }
 }
 
+void* Chunk::operator new(const size_t size) noexcept {
+  return ChunkPool::allocate_unpooled(size);
+}
+
+void Chunk::operator delete(void* const chunk_ptr) noexcept {
+  ChunkPool::deallocate(chunk_ptr);
+}
+
 Chunk::Chunk(
     const ChunkSize chunk_size,
     Route route,
     const Callback callback,
     const CallbackArg callback_arg) noexcept
+    : Chunk(
+          chunk_size,
+          std::move(route),
+          InlineCallback(callback, callback_arg)) {}
+
+Chunk::Chunk(
+    const ChunkSize chunk_size,
+    Route route,
+    InlineCallback callback) noexcept
     : chunk_size(chunk_size),
       route(std::move(route)),
-      callback(callback),
-      callback_arg(callback_arg) {
+      hop(0),
+      callback(std::move(callback)) {
   assert(chunk_size > 0);
   assert(!this->route.empty());
-  assert(callback != nullptr);
+  assert(this->callback);
 }
 
-std::shared_ptr<Device> Chunk::current_device() const noexcept {
-  // assert the route is not empty
-  assert(!route.empty());
+Device* Chunk::current_device() const noexcept {
+  // assert the cursor is within the route
+  assert(0 <= hop && hop < route.size());
 
-  // return the first npu in route
-  return route.front();
+  // return the device at the cursor
+  return route.device(hop);
 }
 
-std::shared_ptr<Device> Chunk::next_device() const noexcept {
+Device* Chunk::next_device() const noexcept {
   // assert the chunk has next dest
   assert(!arrived_dest());
 
   // return next dest
-  const auto next_dest = std::next(route.begin(), 1);
-  return *next_dest;
+  return route.device(hop + 1);
+}
+
+bool Chunk::next_device_is_dest() const noexcept {
+  // assert the chunk has next dest
+  assert(!arrived_dest());
+
+  // only the current and the dest device are left
+  return hop + 2 == route.size();
+}
+
+Device* Chunk::device_after_next() const noexcept {
+  // assert the chunk has a device after the next one
+  assert(!arrived_dest() && !next_device_is_dest());
+
+  // return the device after next dest
+  return route.device(hop + 2);
+}
+
+int Chunk::next_link_index() const noexcept {
+  // assert the chunk has next dest
+  assert(!arrived_dest());
+
+  // link index is resolved by the topology
+  const auto link_index = route.link_index(hop);
+  assert(link_index >= 0);
+  return link_index;
+}
+
+int Chunk::link_index_after_next() const noexcept {
+  // assert the chunk has a device after the next one
+  assert(!arrived_dest() && !next_device_is_dest());
+
+  // link index is resolved by the topology
+  const auto link_index = route.link_index(hop + 1);
+  assert(link_index >= 0);
+  return link_index;
 }
 
 void Chunk::mark_arrived_next_device() noexcept {
@@ -66,15 +119,19 @@ void Chunk::mark_arrived_next_device() noexcept {
   // it means the chunk hasn't arrived its final dest yet
   assert(!arrived_dest());
 
-  // pop previous node from the route
+  // advance the cursor
   // marking the current node has been changed
-  route.pop_front();
+  hop++;
 }
 
 bool Chunk::arrived_dest() const noexcept {
-  // if a chunk arrived dest, route length should be 1
-  // i.e., only containing the dest node
-  return route.size() == 1;
+  // if a chunk arrived dest, the cursor points to the last device
+  // i.e., only the dest node is left
+  return hop + 1 == route.size();
+}
+
+const Route& Chunk::get_route() const noexcept {
+  return route;
 }
 
 ChunkSize Chunk::get_size() const noexcept {
@@ -86,5 +143,5 @@ ChunkSize Chunk::get_size() const noexcept {
 
 void Chunk::invoke_callback() noexcept {
   // invoke callback
-  (*callback)(callback_arg);
+  callback();
 }
@@ -0,0 +1,130 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkPool.hh"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Get the header slot of a chunk, which holds the storage of its pool.
+ *
+ * @param chunk_ptr pointer to the chunk memory
+ * @return pointer to the storage slot of the header
+ */
+void** header_of(void* const chunk_ptr) noexcept {
+  auto* const block =
+      static_cast<unsigned char*>(chunk_ptr) - ChunkPool::header_size;
+  return reinterpret_cast<void**>(block);
+}
+
+} // namespace
+
+void* ChunkPool::allocate_unpooled(const size_t size) noexcept {
+  assert(size > 0);
+
+  // header without pool
+  auto* const block = static_cast<unsigned char*>(
+      ::operator new(header_size + size, std::nothrow));
+  assert(block != nullptr);
+  *reinterpret_cast<void**>(block) = nullptr;
+
+  return block + header_size;
+}
+
+void ChunkPool::deallocate(void* const chunk_ptr) noexcept {
+  if (chunk_ptr == nullptr) {
+    return;
+  }
+
+  // find the pool of the chunk
+  auto** const header = header_of(chunk_ptr);
+  auto* const storage = static_cast<Storage*>(*header);
+
+  if (storage == nullptr) {
+    ::operator delete(static_cast<void*>(header));
+  } else {
+    release(storage, header);
+  }
+}
+
+ChunkPool::ChunkPool() noexcept : storage(new Storage{{}, 0, 0, false}) {}
+
+ChunkPool::~ChunkPool() noexcept {
+  // chunks still alive free the storage with the last of them
+  if (storage->chunks_count > 0) {
+    storage->orphaned = true;
+    return;
+  }
+
+  delete storage;
+}
+
+std::unique_ptr<Chunk> ChunkPool::make_chunk(
+    const ChunkSize chunk_size,
+    Route route,
+    const Callback callback,
+    const CallbackArg callback_arg) noexcept {
+  return make_chunk(
+      chunk_size, std::move(route), InlineCallback(callback, callback_arg));
+}
+
+std::unique_ptr<Chunk> ChunkPool::make_chunk(
+    const ChunkSize chunk_size,
+    Route route,
+    InlineCallback callback) noexcept {
+  // construct the chunk in recycled memory
+  auto* const chunk_ptr = acquire();
+  auto* const chunk = ::new (chunk_ptr)
+      Chunk(chunk_size, std::move(route), std::move(callback));
+
+  return std::unique_ptr<Chunk>(chunk);
+}
+
+size_t ChunkPool::get_chunks_count() const noexcept {
+  return storage->chunks_count;
+}
+
+size_t ChunkPool::get_peak_chunks_count() const noexcept {
+  return storage->peak_chunks_count;
+}
+
+const Arena& ChunkPool::get_arena() const noexcept {
+  return storage->arena;
+}
+
+void* ChunkPool::acquire() noexcept {
+  // header names the storage of this pool
+  auto* const block =
+      static_cast<unsigned char*>(storage->arena.allocate(block_size));
+  *reinterpret_cast<void**>(block) = storage;
+
+  // update the high-water mark
+  storage->chunks_count++;
+  storage->peak_chunks_count =
+      std::max(storage->peak_chunks_count, storage->chunks_count);
+
+  return block + header_size;
+}
+
+void ChunkPool::release(Storage* const storage, void* const block) noexcept {
+  assert(storage != nullptr);
+  assert(block != nullptr);
+  assert(storage->chunks_count > 0);
+
+  // recycle the block
+  storage->arena.deallocate(block, block_size);
+  storage->chunks_count--;
+
+  // the pool is gone: the last chunk frees the storage
+  if (storage->orphaned && storage->chunks_count == 0) {
+    delete storage;
+  }
+}
@@ -4,13 +4,15 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Device.hh"
+#include <algorithm>
 #include <cassert>
 #include "congestion_aware/Chunk.hh"
 #include "congestion_aware/Link.hh"
 
 using namespace NetworkAnalyticalCongestionAware;
 
-Device::Device(const DeviceId id) noexcept : device_id(id) {
+Device::Device(const DeviceId id) noexcept
+    : device_id(id), links(nullptr), link_dests(nullptr), links_count(0) {
   assert(id >= 0);
 }
 
@@ -30,36 +32,64 @@ void Device::send(std::unique_ptr<Chunk> chunk) noexcept {
   // assert the chunk hasn't arrived its final destination yet
   assert(!chunk->arrived_dest());
 
-  // get next dest
-  const auto next_dest = chunk->next_device();
-  const auto next_dest_id = next_dest->get_id();
+  // get the link to the next dest, as resolved by the route
+  const auto link_index = chunk->next_link_index();
 
-  // assert the next dest is connected to this node
-  assert(connected(next_dest_id));
+  // assert the link connects this node to the next dest
+  assert(0 <= link_index && link_index < links_count);
+  assert(link_dests[link_index] == chunk->next_device()->get_id());
 
   // send the chunk to the next dest
   // delegate this task to the link
-  links[next_dest_id]->send(std::move(chunk));
+  links[link_index].send(std::move(chunk));
 }
 
-void Device::connect(
-    const DeviceId id,
-    const Bandwidth bandwidth,
-    const Latency latency) noexcept {
-  assert(id >= 0);
-  assert(bandwidth > 0);
-  assert(latency >= 0);
+void Device::set_links(
+    Link* const links,
+    const DeviceId* const link_dests,
+    const int links_count) noexcept {
+  assert(links_count >= 0);
+  assert(links_count == 0 || (links != nullptr && link_dests != nullptr));
+
+  this->links = links;
+  this->link_dests = link_dests;
+  this->links_count = links_count;
+}
 
-  // assert there's no existing connection
-  assert(!connected(id));
+int Device::get_links_count() const noexcept {
+  assert(links_count >= 0);
 
-  // create link
-  links[id] = std::make_shared<Link>(bandwidth, latency);
+  return links_count;
 }
 
-bool Device::connected(const DeviceId dest) const noexcept {
+int Device::get_link_index(const DeviceId dest) const noexcept {
   assert(dest >= 0);
 
-  // check whether the connection exists
-  return links.find(dest) != links.end();
+  // link dests are sorted
+  const auto* const link_dests_end = link_dests + links_count;
+  const auto* const link_dest =
+      std::lower_bound(link_dests, link_dests_end, dest);
+
+  // assert the connection exists
+  assert(link_dest != link_dests_end && *link_dest == dest);
+
+  return static_cast<int>(link_dest - link_dests);
+}
+
+Link* Device::get_link(const DeviceId dest) const noexcept {
+  assert(dest >= 0);
+
+  return get_link_at(get_link_index(dest));
+}
+
+Link* Device::get_link_at(const int link_index) const noexcept {
+  assert(0 <= link_index && link_index < links_count);
+
+  return links + link_index;
+}
+
+DeviceId Device::get_link_dest(const int link_index) const noexcept {
+  assert(0 <= link_index && link_index < links_count);
+
+  return link_dests[link_index];
 }
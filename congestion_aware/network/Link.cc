@@ -4,42 +4,69 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Link.hh"
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include "common/NetworkFunction.hh"
 #include "congestion_aware/Chunk.hh"
 #include "congestion_aware/Device.hh"
+#include "congestion_aware/ParallelSimulation.hh"
+#include "congestion_aware/Partition.hh"
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-// declaring static event_queue
-std::shared_ptr<EventQueue> Link::event_queue;
+namespace {
 
-void Link::link_become_free(void* const link_ptr) noexcept {
-  assert(link_ptr != nullptr);
+/**
+ * Find the first reserved slot ending after the given time.
+ * Slots are disjoint and ascending, so their ends ascend too.
+ *
+ * @param reserved_slots reserved slots (start, end) of a link
+ * @param time time to search from
+ * @return first slot ending after the time, or the end of the slots
+ */
+template <typename ReservedSlots>
+auto first_slot_ending_after(
+    ReservedSlots& reserved_slots,
+    const EventTime time) noexcept {
+  return std::upper_bound(
+      reserved_slots.begin(),
+      reserved_slots.end(),
+      time,
+      [](const EventTime time, const std::pair<EventTime, EventTime>& slot) {
+        return time < slot.second;
+      });
+}
 
-  // cast to Link*
-  auto* const link = static_cast<Link*>(link_ptr);
+} // namespace
 
-  // set link free
-  link->set_free();
+void Link::dispatch_event(const EventKind kind, void* const target) noexcept {
+  assert(target != nullptr);
 
-  // process pending chunks if one exist
-  if (link->pending_chunk_exists()) {
-    link->process_pending_transmission();
+  switch (kind) {
+    case EventKind::ChunkArrived:
+      Chunk::chunk_arrived_next_device(target);
+      break;
+    default:
+      // not a built-in event of links
+      assert(false);
+      break;
   }
 }
 
-void Link::set_event_queue(
-    std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
-  assert(event_queue_ptr != nullptr);
-
-  // set the event queue
-  Link::event_queue = std::move(event_queue_ptr);
-}
-
 Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
-    : bandwidth(bandwidth), latency(latency), pending_chunks(), busy(false) {
+    : event_queue(nullptr),
+      bandwidth(bandwidth),
+      latency(latency),
+      free_time(0),
+      hop_by_hop_free_time(0),
+      max_pending_chunks_count(0),
+      incoming_chunks_count(0),
+      congestion_model(CongestionModel::HopByHop),
+      partition(nullptr),
+      link_id(-1),
+      scheduled_events_count(0) {
   assert(bandwidth > 0);
   assert(latency >= 0);
 
@@ -50,40 +77,201 @@ Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
 void Link::send(std::unique_ptr<Chunk> chunk) noexcept {
   assert(chunk != nullptr);
 
-  if (busy) {
-    // link is busy, add to pending chunks
-    pending_chunks.push_back(std::move(chunk));
+  // chunk arrives next node after the communication delay
+  const auto departure_time = queue_chunk(chunk->get_size());
+  schedule_chunk_arrival(std::move(chunk), departure_time);
+}
+
+EventTime Link::transmit(const ChunkSize chunk_size) noexcept {
+  // chunk arrives next node after the communication delay
+  return queue_chunk(chunk_size) + communication_delay(chunk_size);
+}
+
+EventTime Link::reserve(
+    const ChunkSize chunk_size,
+    const EventTime ready_time) noexcept {
+  // chunk arrives next node after the communication delay
+  return reserve_slot(chunk_size, ready_time) + communication_delay(chunk_size);
+}
+
+EventTime Link::queue_chunk(const ChunkSize chunk_size) noexcept {
+  // hybrid: queue after the chunks queued hop by hop before it,
+  // in the first gap between the slots reserved by the idle routes
+  if (congestion_model == CongestionModel::Hybrid) {
+    assert(incoming_chunks_count > 0);
+    incoming_chunks_count--;
+    const auto ready_time = std::max(current_time(), hop_by_hop_free_time);
+    const auto departure_time = reserve_slot(chunk_size, ready_time);
+    hop_by_hop_free_time = departure_time + serialization_delay(chunk_size);
+    return departure_time;
+  }
+
+  // the chunk departs once the chunks sent before it are serialized
+  const auto current_time = this->current_time();
+  const auto departure_time = std::max(current_time, free_time);
+
+  // track the queue depth: drop the chunks already departed
+  while (!departure_times.empty() &&
+         departure_times.front() <= current_time) {
+    departure_times.pop_front();
+  }
+  if (departure_time > current_time) {
+    departure_times.push_back(departure_time);
+    max_pending_chunks_count =
+        std::max(max_pending_chunks_count, departure_times.size());
+  }
+
+  // link is busy until the chunk is serialized
+  free_time = departure_time + serialization_delay(chunk_size);
+  return departure_time;
+}
+
+EventTime Link::reserve_slot(
+    const ChunkSize chunk_size,
+    const EventTime ready_time) noexcept {
+  const auto current_time = this->current_time();
+  assert(ready_time >= current_time);
+
+  // drop the slots already passed
+  while (!reserved_slots.empty() &&
+         reserved_slots.front().second <= current_time) {
+    reserved_slots.pop_front();
+  }
+
+  // nothing reserved from the ready time on: append the slot
+  const auto serialization_time = serialization_delay(chunk_size);
+  if (free_time <= ready_time) {
+    free_time = ready_time + serialization_time;
+    if (!reserved_slots.empty() &&
+        reserved_slots.back().second == ready_time) {
+      reserved_slots.back().second = free_time;
+    } else {
+      reserved_slots.push_back({ready_time, free_time});
+    }
+    return ready_time;
+  }
+
+  // earliest gap of the timeline fitting the serialization,
+  // starting from the first slot not passed at the ready time
+  auto departure_time = ready_time;
+  auto next = first_slot_ending_after(reserved_slots, ready_time);
+  while (next != reserved_slots.end() &&
+         (next->first <= departure_time ||
+          next->first < departure_time + serialization_time)) {
+    departure_time = std::max(departure_time, next->second);
+    ++next;
+  }
+  const auto end_time = departure_time + serialization_time;
+
+  // reserve the slot, merged with the adjacent ones:
+  // slots before next end at or before the departure
+  const auto merges_previous = next != reserved_slots.begin() &&
+      std::prev(next)->second == departure_time;
+  const auto merges_next =
+      next != reserved_slots.end() && next->first == end_time;
+  if (merges_previous && merges_next) {
+    std::prev(next)->second = next->second;
+    reserved_slots.erase(next);
+  } else if (merges_previous) {
+    std::prev(next)->second = end_time;
+  } else if (merges_next) {
+    next->first = departure_time;
   } else {
-    // service this chunk immediately
-    schedule_chunk_transmission(std::move(chunk));
+    reserved_slots.insert(next, {departure_time, end_time});
   }
+  free_time = std::max(free_time, end_time);
+  return departure_time;
 }
 
-void Link::process_pending_transmission() noexcept {
-  // pending chunk should exist
-  assert(pending_chunk_exists());
+void Link::add_incoming_chunk() noexcept {
+  incoming_chunks_count++;
+}
 
-  // get chunk to process
-  auto chunk = std::move(pending_chunks.front());
-  pending_chunks.pop_front();
+bool Link::is_idle(const EventTime ready_time, const ChunkSize chunk_size)
+    const noexcept {
+  // a chunk queued hop by hop may reach the link first
+  if (incoming_chunks_count > 0) {
+    return false;
+  }
 
-  // service this chunk
-  schedule_chunk_transmission(std::move(chunk));
+  // nothing is reserved from the ready time on
+  if (free_time <= ready_time) {
+    return true;
+  }
+
+  // the chunk would depart right away unless a slot overlaps,
+  // as reserve() decides
+  const auto end_time = ready_time + serialization_delay(chunk_size);
+  const auto next = first_slot_ending_after(reserved_slots, ready_time);
+  return next == reserved_slots.end() ||
+      (next->first > ready_time && next->first >= end_time);
 }
 
 bool Link::pending_chunk_exists() const noexcept {
-  // check pending chunks is not empty
-  return !pending_chunks.empty();
+  return get_pending_chunks_count() > 0;
+}
+
+size_t Link::get_pending_chunks_count() const noexcept {
+  if (departure_times.empty()) {
+    return 0;
+  }
+
+  // chunks departing after the current time are still waiting
+  const auto current_time = this->current_time();
+  const auto first_pending = std::upper_bound(
+      departure_times.begin(), departure_times.end(), current_time);
+  return static_cast<size_t>(departure_times.end() - first_pending);
+}
+
+size_t Link::get_max_pending_chunks_count() const noexcept {
+  return max_pending_chunks_count;
+}
+
+EventTime Link::get_free_time() const noexcept {
+  return free_time;
+}
+
+void Link::set_event_queue(EventQueue* const event_queue) noexcept {
+  assert(event_queue != nullptr);
+
+  this->event_queue = event_queue;
+}
+
+void Link::set_congestion_model(
+    const CongestionModel congestion_model) noexcept {
+  this->congestion_model = congestion_model;
 }
 
-void Link::set_busy() noexcept {
-  // set busy to true
-  busy = true;
+Bandwidth Link::get_bandwidth() const noexcept {
+  return bandwidth;
 }
 
-void Link::set_free() noexcept {
-  // set busy to false
-  busy = false;
+Latency Link::get_latency() const noexcept {
+  return latency;
+}
+
+void Link::set_link_id(const int link_id) noexcept {
+  assert(link_id >= 0);
+
+  this->link_id = link_id;
+}
+
+void Link::set_partition(Partition* const partition) noexcept {
+  this->partition = partition;
+  scheduled_events_count = 0;
+}
+
+Partition* Link::get_partition() const noexcept {
+  return partition;
+}
+
+EventTime Link::current_time() const noexcept {
+  if (partition != nullptr) {
+    return partition->get_current_time();
+  }
+
+  assert(event_queue != nullptr);
+  return event_queue->get_current_time();
 }
 
 EventTime Link::serialization_delay(const ChunkSize chunk_size) const noexcept {
@@ -107,29 +295,33 @@ EventTime Link::communication_delay(const ChunkSize chunk_size) const noexcept {
   return static_cast<EventTime>(delay);
 }
 
-void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
+void Link::schedule_chunk_arrival(
+    std::unique_ptr<Chunk> chunk,
+    const EventTime departure_time) noexcept {
   assert(chunk != nullptr);
+  assert(link_id >= 0);
 
-  // link should be free
-  assert(!busy);
+  // chunk arrives next node after the communication delay
+  const auto arrival_time =
+      departure_time + communication_delay(chunk->get_size());
 
-  // set link busy
-  set_busy();
+  // the arrival is ordered as if scheduled when the chunk departs,
+  // then by the link and its event count
+  const auto key = EventKey{departure_time, link_id, scheduled_events_count};
+  scheduled_events_count++;
 
-  // get metadata
-  const auto chunk_size = chunk->get_size();
-  const auto current_time = Link::event_queue->get_current_time();
+  // parallel simulation: schedule into the partition of the next hop
+  if (partition != nullptr) {
+    const auto* const simulation = partition->get_simulation();
+    auto* const arrival_partition = simulation->arrival_partition(*chunk);
+    partition->schedule_event(
+        arrival_partition,
+        {arrival_time, key, EventKind::ChunkArrived, chunk.release()});
+    return;
+  }
 
   // schedule chunk arrival event
-  const auto communication_time = communication_delay(chunk_size);
-  const auto chunk_arrival_time = current_time + communication_time;
   auto* const chunk_ptr = static_cast<void*>(chunk.release());
-  Link::event_queue->schedule_event(
-      chunk_arrival_time, Chunk::chunk_arrived_next_device, chunk_ptr);
-
-  // schedule link free time
-  const auto serialization_time = serialization_delay(chunk_size);
-  const auto link_free_time = current_time + serialization_time;
-  auto* const link_ptr = static_cast<void*>(this);
-  Link::event_queue->schedule_event(link_free_time, link_become_free, link_ptr);
+  event_queue->schedule_event(
+      arrival_time, EventKind::ChunkArrived, chunk_ptr, key);
 }
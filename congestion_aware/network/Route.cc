@@ -0,0 +1,130 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Route.hh"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+Route::Route() noexcept : Route(nullptr) {}
+
+Route::Route(const std::shared_ptr<Device>* const devices) noexcept
+    : devices(devices), length(0), inline_hops(), borrowed_hops(nullptr) {}
+
+void Route::push_back(const DeviceId device_id) noexcept {
+  assert(device_id >= 0);
+
+  // fits into the inline storage (borrowed routes are longer)
+  const auto hop = Hop{device_id, -1};
+  if (borrowed_hops == nullptr && shared_hops == nullptr &&
+      length < inline_capacity) {
+    inline_hops[length] = hop;
+    length++;
+    return;
+  }
+
+  if (borrowed_hops != nullptr) {
+    // buffer is borrowed: own a copy before modifying
+    shared_hops = std::make_shared<std::vector<Hop>>(
+        borrowed_hops, borrowed_hops + length);
+    borrowed_hops = nullptr;
+  } else if (shared_hops == nullptr) {
+    // inline storage is full: move to a buffer
+    shared_hops = std::make_shared<std::vector<Hop>>(
+        inline_hops, inline_hops + length);
+  } else if (shared_hops.use_count() > 1) {
+    // buffer is shared with other copies: copy before modifying
+    shared_hops = std::make_shared<std::vector<Hop>>(*shared_hops);
+  }
+
+  shared_hops->push_back(hop);
+  length++;
+}
+
+int Route::size() const noexcept {
+  assert(length >= 0);
+
+  return length;
+}
+
+bool Route::empty() const noexcept {
+  return length == 0;
+}
+
+DeviceId Route::operator[](const int hop) const noexcept {
+  assert(0 <= hop && hop < length);
+
+  return data()[hop].device_id;
+}
+
+int Route::link_index(const int hop) const noexcept {
+  assert(0 <= hop && hop < length);
+
+  return data()[hop].link_index;
+}
+
+void Route::set_link_index(const int hop, const int link_index) noexcept {
+  // the dest device has no next device
+  assert(0 <= hop && hop < length - 1);
+  assert(link_index >= 0);
+
+  mutable_data()[hop].link_index = link_index;
+}
+
+Device* Route::device(const int hop) const noexcept {
+  assert(devices != nullptr);
+
+  // resolve the DeviceId through the device table
+  return devices[(*this)[hop]].get();
+}
+
+const Route::Hop* Route::data() const noexcept {
+  if (borrowed_hops != nullptr) {
+    return borrowed_hops;
+  }
+
+  if (shared_hops != nullptr) {
+    return shared_hops->data();
+  }
+
+  return inline_hops;
+}
+
+Route Route::borrow() const noexcept {
+  // short routes are copied inline anyway
+  if (length <= inline_capacity) {
+    return *this;
+  }
+
+  // refer to the buffer, without sharing its ownership
+  auto route = Route(devices);
+  route.length = length;
+  route.borrowed_hops = data();
+  return route;
+}
+
+bool Route::is_borrowed() const noexcept {
+  return borrowed_hops != nullptr;
+}
+
+Route::Hop* Route::mutable_data() noexcept {
+  // buffer is borrowed: own a copy before modifying
+  if (borrowed_hops != nullptr) {
+    shared_hops = std::make_shared<std::vector<Hop>>(
+        borrowed_hops, borrowed_hops + length);
+    borrowed_hops = nullptr;
+  }
+
+  if (shared_hops == nullptr) {
+    return inline_hops;
+  }
+
+  // buffer is shared with other copies: copy before modifying
+  if (shared_hops.use_count() > 1) {
+    shared_hops = std::make_shared<std::vector<Hop>>(*shared_hops);
+  }
+
+  return shared_hops->data();
+}
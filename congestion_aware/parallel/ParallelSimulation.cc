@@ -0,0 +1,198 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ParallelSimulation.hh"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include "congestion_aware/Chunk.hh"
+#include "congestion_aware/Device.hh"
+#include "congestion_aware/Link.hh"
+#include "congestion_aware/SpinBarrier.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// partition processed by the calling worker thread
+thread_local const Partition* worker_partition = nullptr;
+
+} // namespace
+
+ParallelSimulation::ParallelSimulation(
+    std::shared_ptr<Topology> topology,
+    const int threads_count) noexcept
+    : topology(std::move(topology)),
+      lookahead(std::numeric_limits<EventTime>::max()),
+      current_time(0) {
+  assert(this->topology != nullptr);
+  assert(threads_count > 0);
+
+  // reservations span the links of several partitions
+  assert(
+      this->topology->get_congestion_model() == CongestionModel::HopByHop);
+
+  // lookahead is the minimum link latency,
+  // as a chunk never arrives earlier than that after being scheduled
+  const auto devices_count = this->topology->get_devices_count();
+  for (auto src = 0; src < devices_count; src++) {
+    const auto device = this->topology->get_device(src);
+    for (auto i = 0; i < device->get_links_count(); i++) {
+      const auto link = device->get_link_at(i);
+      const auto latency = static_cast<EventTime>(link->get_latency());
+      lookahead = std::min(lookahead, latency);
+    }
+  }
+
+  // without lookahead, partitions can't proceed independently
+  const auto partitions_count = (lookahead > 0) ? threads_count : 1;
+  for (auto i = 0; i < partitions_count; i++) {
+    partitions.push_back(
+        std::make_unique<Partition>(i, partitions_count, this));
+  }
+
+  // assign devices to partitions
+  for (auto i = 0; i < devices_count; i++) {
+    device_partitions.push_back(device_partition(i));
+  }
+
+  // assign links to partitions:
+  // a link belongs to its NPU endpoint, preferring the source,
+  // so that links of a switch are spread across partitions
+  const auto npus_count = this->topology->get_npus_count();
+  for (auto src = 0; src < devices_count; src++) {
+    const auto device = this->topology->get_device(src);
+    for (auto i = 0; i < device->get_links_count(); i++) {
+      const auto dest = device->get_link_dest(i);
+      const auto link = device->get_link_at(i);
+      const auto owner = (src < npus_count || dest >= npus_count) ? src : dest;
+      link->set_partition(device_partitions[owner]);
+    }
+  }
+  this->topology->set_partitioned(true);
+}
+
+ParallelSimulation::~ParallelSimulation() noexcept {
+  // return links to the sequential event queue
+  const auto devices_count = topology->get_devices_count();
+  for (auto src = 0; src < devices_count; src++) {
+    const auto device = topology->get_device(src);
+    for (auto i = 0; i < device->get_links_count(); i++) {
+      device->get_link_at(i)->set_partition(nullptr);
+    }
+  }
+  topology->set_partitioned(false);
+}
+
+void ParallelSimulation::run() noexcept {
+  const auto partitions_count = get_partitions_count();
+  auto barrier = SpinBarrier(partitions_count);
+  auto min_event_times = std::vector<EventTime>(partitions_count, 0);
+
+  // spawn one worker per partition, except the one run by this thread
+  auto workers = std::vector<std::thread>();
+  for (auto i = 1; i < partitions_count; i++) {
+    workers.emplace_back([this, i, &barrier, &min_event_times]() {
+      run_partition(*partitions[i], barrier, min_event_times);
+    });
+  }
+  run_partition(*partitions[0], barrier, min_event_times);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  // simulation time is the time of the last processed event
+  for (const auto& partition : partitions) {
+    current_time = std::max(current_time, partition->get_current_time());
+  }
+}
+
+EventTime ParallelSimulation::get_current_time() const noexcept {
+  // inside a worker, return the time of its partition
+  if (worker_partition != nullptr &&
+      worker_partition->get_simulation() == this) {
+    return worker_partition->get_current_time();
+  }
+
+  return current_time;
+}
+
+int ParallelSimulation::get_partitions_count() const noexcept {
+  assert(!partitions.empty());
+
+  return static_cast<int>(partitions.size());
+}
+
+EventTime ParallelSimulation::get_lookahead() const noexcept {
+  return lookahead;
+}
+
+Partition* ParallelSimulation::arrival_partition(
+    const Chunk& chunk) const noexcept {
+  // chunk arrives its destination: processed by the NPU
+  auto* const next_device = chunk.next_device();
+  if (chunk.next_device_is_dest()) {
+    return device_partitions[next_device->get_id()];
+  }
+
+  // otherwise, processed by the next link
+  auto* const link = next_device->get_link_at(chunk.link_index_after_next());
+  return link->get_partition();
+}
+
+Partition* ParallelSimulation::device_partition(
+    const DeviceId device_id) const noexcept {
+  const auto partitions_count = get_partitions_count();
+  const auto npus_count = topology->get_npus_count();
+  const auto devices_count = topology->get_devices_count();
+  assert(0 <= device_id && device_id < devices_count);
+
+  // NPUs: contiguous blocks of NPU ids
+  if (device_id < npus_count) {
+    const auto index = static_cast<int64_t>(device_id) * partitions_count;
+    return partitions[index / npus_count].get();
+  }
+
+  // non-NPU devices: contiguous blocks of the remaining ids
+  const auto offset = static_cast<int64_t>(device_id - npus_count);
+  const auto index = offset * partitions_count;
+  return partitions[index / (devices_count - npus_count)].get();
+}
+
+void ParallelSimulation::run_partition(
+    Partition& partition,
+    SpinBarrier& barrier,
+    std::vector<EventTime>& min_event_times) noexcept {
+  worker_partition = &partition;
+  const auto id = partition.get_id();
+
+  while (true) {
+    // receive events sent in the previous window
+    partition.receive_events(partitions);
+    min_event_times[id] = partition.get_min_event_time();
+    barrier.wait();
+
+    // the next window starts at the earliest event of all partitions
+    const auto window_start =
+        *std::min_element(min_event_times.begin(), min_event_times.end());
+    if (window_start == std::numeric_limits<EventTime>::max()) {
+      // every partition finished
+      break;
+    }
+
+    // process the window: events sent to other partitions within this window
+    // arrive at or after the window end, given the lookahead
+    const auto window_end = (get_partitions_count() == 1)
+        ? std::numeric_limits<EventTime>::max()
+        : window_start + lookahead;
+    partition.process_events(window_end);
+    barrier.wait();
+  }
+
+  worker_partition = nullptr;
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Partition.hh"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include "congestion_aware/Link.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+Partition::Partition(
+    const int id,
+    const int partitions_count,
+    const ParallelSimulation* const simulation) noexcept
+    : id(id), simulation(simulation), current_time(0) {
+  assert(0 <= id && id < partitions_count);
+  assert(simulation != nullptr);
+
+  // one outbox per partition
+  outboxes.resize(partitions_count);
+}
+
+int Partition::get_id() const noexcept {
+  return id;
+}
+
+const ParallelSimulation* Partition::get_simulation() const noexcept {
+  return simulation;
+}
+
+EventTime Partition::get_current_time() const noexcept {
+  return current_time;
+}
+
+EventTime Partition::get_min_event_time() const noexcept {
+  if (events.empty()) {
+    return std::numeric_limits<EventTime>::max();
+  }
+
+  return events.front().event_time;
+}
+
+void Partition::schedule_event(
+    Partition* const partition,
+    const ParallelEvent& event) noexcept {
+  assert(partition != nullptr);
+  assert(event.event_time >= current_time);
+
+  // events of other partitions wait in the outbox until synchronization
+  if (partition != this) {
+    outboxes[partition->id].push_back(event);
+    return;
+  }
+
+  // insert the event and restore the heap property
+  events.push_back(event);
+  std::push_heap(events.begin(), events.end(), later);
+}
+
+void Partition::receive_events(
+    const std::vector<std::unique_ptr<Partition>>& partitions) noexcept {
+  for (const auto& partition : partitions) {
+    // move the events sent to this partition
+    auto& outbox = partition->outboxes[id];
+    for (const auto& event : outbox) {
+      events.push_back(event);
+      std::push_heap(events.begin(), events.end(), later);
+    }
+    outbox.clear();
+  }
+}
+
+void Partition::process_events(const EventTime end_time) noexcept {
+  while (!events.empty() && events.front().event_time < end_time) {
+    // dequeue the earliest event
+    std::pop_heap(events.begin(), events.end(), later);
+    const auto event = events.back();
+    events.pop_back();
+
+    // process the event
+    assert(event.event_time >= current_time);
+    current_time = event.event_time;
+    Link::dispatch_event(event.kind, event.target);
+  }
+}
+
+bool Partition::later(
+    const ParallelEvent& lhs,
+    const ParallelEvent& rhs) noexcept {
+  // compare event time first, then the key
+  if (lhs.event_time != rhs.event_time) {
+    return lhs.event_time > rhs.event_time;
+  }
+  return rhs.key < lhs.key;
+}
@@ -0,0 +1,36 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SpinBarrier.hh"
+#include <cassert>
+#include <thread>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+SpinBarrier::SpinBarrier(const int threads_count) noexcept
+    : threads_count(threads_count), waiting_count(threads_count), phase(0) {
+  assert(threads_count > 0);
+}
+
+void SpinBarrier::wait() noexcept {
+  const auto current_phase = phase.load(std::memory_order_acquire);
+
+  // the last thread to arrive releases the others
+  if (waiting_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    waiting_count.store(threads_count, std::memory_order_relaxed);
+    phase.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  // spin for a short while, then yield the core
+  auto spins_count = 0;
+  while (phase.load(std::memory_order_acquire) == current_phase) {
+    if (spins_count < 1'024) {
+      spins_count++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -7,6 +7,7 @@ LICENSE file in the root directory of this source tree.
 #include <cstdlib>
 #include <iostream>
 #include "congestion_aware/FullyConnected.hh"
+#include "congestion_aware/MultiDimTopology.hh"
 #include "congestion_aware/Ring.hh"
 #include "congestion_aware/Switch.hh"
 
@@ -22,30 +23,63 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
   const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
   const auto latencies_per_dim = network_parser.get_latencies_per_dim();
 
-  // for now, congestion_aware backend supports 1-dim topology only
-  if (dims_count != 1) {
-    std::cerr << "[Error] (network/analytical/congestion_aware) "
-              << "only support 1-dim topology" << std::endl;
-    std::exit(-1);
+  // if dims_count is 1, just create basic topology
+  if (dims_count == 1) {
+    // retrieve basic topology info
+    const auto topology_type = topologies_per_dim[0];
+    const auto npus_count = npus_counts_per_dim[0];
+    const auto bandwidth = bandwidths_per_dim[0];
+    const auto latency = latencies_per_dim[0];
+
+    // create and return basic topology
+    switch (topology_type) {
+      case TopologyBuildingBlock::Ring:
+        return std::make_shared<Ring>(npus_count, bandwidth, latency);
+      case TopologyBuildingBlock::Switch:
+        return std::make_shared<Switch>(npus_count, bandwidth, latency);
+      case TopologyBuildingBlock::FullyConnected:
+        return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+      default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "not supported basic-topology" << std::endl;
+        std::exit(-1);
+    }
   }
 
-  // retrieve basic basic-topology info
-  const auto topology_type = topologies_per_dim[0];
-  const auto npus_count = npus_counts_per_dim[0];
-  const auto bandwidth = bandwidths_per_dim[0];
-  const auto latency = latencies_per_dim[0];
-
-  switch (topology_type) {
-    case TopologyBuildingBlock::Ring:
-      return std::make_shared<Ring>(npus_count, bandwidth, latency);
-    case TopologyBuildingBlock::Switch:
-      return std::make_shared<Switch>(npus_count, bandwidth, latency);
-    case TopologyBuildingBlock::FullyConnected:
-      return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
-    default:
-      // shouldn't reaach here
-      std::cerr << "[Error] (network/analytical/congestion_aware) "
-                << "not supported basic-topology" << std::endl;
-      std::exit(-1);
+  // otherwise, create a network dim per each dimension
+  auto topology_per_dim = std::vector<std::unique_ptr<BasicTopology>>();
+  for (auto dim = 0; dim < dims_count; dim++) {
+    // retrieve info
+    const auto topology_type = topologies_per_dim[dim];
+    const auto npus_count = npus_counts_per_dim[dim];
+    const auto bandwidth = bandwidths_per_dim[dim];
+    const auto latency = latencies_per_dim[dim];
+
+    // create a network dim
+    std::unique_ptr<BasicTopology> dim_topology;
+    switch (topology_type) {
+      case TopologyBuildingBlock::Ring:
+        dim_topology = std::make_unique<Ring>(npus_count, bandwidth, latency);
+        break;
+      case TopologyBuildingBlock::Switch:
+        dim_topology = std::make_unique<Switch>(npus_count, bandwidth, latency);
+        break;
+      case TopologyBuildingBlock::FullyConnected:
+        dim_topology =
+            std::make_unique<FullyConnected>(npus_count, bandwidth, latency);
+        break;
+      default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "not supported basic-topology" << std::endl;
+        std::exit(-1);
+    }
+
+    // append network dimension
+    topology_per_dim.push_back(std::move(dim_topology));
   }
+
+  // create and return multi-dimensional topology
+  return std::make_shared<MultiDimTopology>(std::move(topology_per_dim));
 }
@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/RoutingTable.hh"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+RoutingTable::RoutingTable() noexcept
+    : npus_count(0), capacity_bytes(default_capacity_bytes), used_bytes(0) {}
+
+void RoutingTable::reset(const int npus_count) noexcept {
+  assert(npus_count > 0);
+
+  // drop every row
+  this->npus_count = npus_count;
+  rows.clear();
+  rows.resize(npus_count);
+  used_bytes = 0;
+}
+
+int RoutingTable::get_npus_count() const noexcept {
+  return npus_count;
+}
+
+const Route* RoutingTable::find(
+    const DeviceId src,
+    const DeviceId dest) const noexcept {
+  assert(0 <= src && src < npus_count);
+  assert(0 <= dest && dest < npus_count);
+
+  // row of src not allocated yet
+  const auto& row = rows[src];
+  if (row == nullptr) {
+    return nullptr;
+  }
+
+  // empty route: not cached
+  const auto& route = row[dest];
+  if (route.empty()) {
+    return nullptr;
+  }
+
+  return &route;
+}
+
+bool RoutingTable::store(
+    const DeviceId src,
+    const DeviceId dest,
+    const Route& route) noexcept {
+  assert(0 <= src && src < npus_count);
+  assert(0 <= dest && dest < npus_count);
+  assert(!route.empty());
+  assert(!route.is_borrowed());
+
+  // allocate the row of src
+  auto& row = rows[src];
+  if (row == nullptr) {
+    if (!reserve_bytes(sizeof(Route) * npus_count)) {
+      return false;
+    }
+    row = std::make_unique<Route[]>(npus_count);
+  }
+
+  // routes beyond the inline storage own a buffer
+  if (route.size() > Route::inline_capacity) {
+    if (!reserve_bytes(sizeof(Route::Hop) * route.size())) {
+      return false;
+    }
+  }
+
+  // the cached copy shares the buffer of the given route
+  assert(row[dest].empty());
+  row[dest] = route;
+  return true;
+}
+
+void RoutingTable::set_capacity_bytes(const size_t capacity_bytes) noexcept {
+  this->capacity_bytes = capacity_bytes;
+}
+
+size_t RoutingTable::get_capacity_bytes() const noexcept {
+  return capacity_bytes;
+}
+
+size_t RoutingTable::get_used_bytes() const noexcept {
+  return used_bytes;
+}
+
+bool RoutingTable::reserve_bytes(const size_t bytes) noexcept {
+  // routes of distinct src NPUs may be stored concurrently
+  auto current = used_bytes.load(std::memory_order_relaxed);
+  do {
+    if (current + bytes > capacity_bytes) {
+      return false;
+    }
+  } while (!used_bytes.compare_exchange_weak(
+      current, current + bytes, std::memory_order_relaxed));
+
+  return true;
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SimulationContext.hh"
+#include <cassert>
+#include "congestion_aware/Helper.hh"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+SimulationContext::SimulationContext(
+    const NetworkParser& network_parser) noexcept
+    : SimulationContext(construct_topology(network_parser)) {}
+
+SimulationContext::SimulationContext(
+    std::shared_ptr<Topology> topology) noexcept
+    : event_queue(std::make_shared<EventQueue>()),
+      chunk_pool(std::make_shared<ChunkPool>()),
+      topology(std::move(topology)) {
+  assert(this->topology != nullptr);
+
+  // links of the topology use the event queue of this context
+  this->topology->bind_event_queue(event_queue);
+
+  // chunks of the topology are recycled through the pool of this context
+  this->topology->bind_chunk_pool(chunk_pool);
+}
+
+std::shared_ptr<EventQueue> SimulationContext::get_event_queue()
+    const noexcept {
+  return event_queue;
+}
+
+std::shared_ptr<ChunkPool> SimulationContext::get_chunk_pool()
+    const noexcept {
+  return chunk_pool;
+}
+
+std::shared_ptr<Topology> SimulationContext::get_topology() const noexcept {
+  return topology;
+}
+
+EventTime SimulationContext::get_current_time() const noexcept {
+  return event_queue->get_current_time();
+}
+
+void SimulationContext::run() noexcept {
+  // invoke every event
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+}
@@ -4,24 +4,101 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Topology.hh"
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
 #include "congestion_aware/Link.hh"
 
 using namespace NetworkAnalyticalCongestionAware;
 
+namespace {
+
+/**
+ * Completion record of a batch in flight.
+ */
+struct BatchCompletion {
+  /// arena the record is allocated from
+  Arena* arena;
+
+  /// number of chunks of the batch not arrived yet
+  size_t pending_chunks_count;
+
+  /// callback to be invoked when the whole batch arrived
+  InlineCallback callback;
+};
+
+/**
+ * Count the arrival of a chunk of a batch,
+ * invoking the callback of the batch once every chunk arrived.
+ *
+ * @param batch completion record of the batch
+ */
+void batch_chunk_arrived(BatchCompletion* const batch) noexcept {
+  assert(batch->pending_chunks_count > 0);
+
+  batch->pending_chunks_count--;
+  if (batch->pending_chunks_count > 0) {
+    return;
+  }
+
+  // release the record before invoking, as the callback may send a batch
+  auto callback = std::move(batch->callback);
+  auto* const arena = batch->arena;
+  batch->~BatchCompletion();
+  arena->deallocate(batch, sizeof(BatchCompletion));
+  callback();
+}
+
+} // namespace
+
+// declaring static default_event_queue
+std::shared_ptr<EventQueue> Topology::default_event_queue;
+
 void Topology::set_event_queue(
     std::shared_ptr<EventQueue> event_queue) noexcept {
   assert(event_queue != nullptr);
 
-  // pass the given event_queue to Link
-  Link::set_event_queue(std::move(event_queue));
+  // register the dispatcher of built-in events
+  event_queue->set_event_dispatcher(Link::dispatch_event);
+
+  // set the default event queue
+  Topology::default_event_queue = std::move(event_queue);
 }
 
 Topology::Topology() noexcept
-    : npus_count(-1), devices_count(-1), dims_count(-1) {
+    : event_queue(Topology::default_event_queue),
+      chunk_pool(std::make_shared<ChunkPool>()),
+      npus_count(-1),
+      devices_count(-1),
+      dims_count(-1),
+      congestion_model(CongestionModel::HopByHop),
+      partitioned(false),
+      route_hits_count(0),
+      route_misses_count(0) {
   npus_count_per_dim = {};
 }
 
+void Topology::bind_event_queue(
+    std::shared_ptr<EventQueue> event_queue) noexcept {
+  assert(event_queue != nullptr);
+
+  // register the dispatcher of built-in events
+  event_queue->set_event_dispatcher(Link::dispatch_event);
+
+  // pass the given event_queue to every link
+  this->event_queue = std::move(event_queue);
+  for (auto& link : links) {
+    link.set_event_queue(this->event_queue.get());
+  }
+}
+
+std::shared_ptr<EventQueue> Topology::get_event_queue() const noexcept {
+  return event_queue;
+}
+
 int Topology::get_devices_count() const noexcept {
   assert(devices_count > 0);
   assert(npus_count > 0);
@@ -38,6 +115,26 @@ int Topology::get_npus_count() const noexcept {
   return npus_count;
 }
 
+std::shared_ptr<Device> Topology::get_device(const DeviceId id) const noexcept {
+  assert(0 <= id && id < devices_count);
+
+  return devices[id];
+}
+
+int Topology::get_links_count() const noexcept {
+  return static_cast<int>(links.size());
+}
+
+int Topology::get_link_id(
+    const DeviceId device_id,
+    const int link_index) const noexcept {
+  assert(0 <= device_id && device_id < devices_count);
+  assert(0 <= link_index);
+  assert(link_index < link_offsets[device_id + 1] - link_offsets[device_id]);
+
+  return link_offsets[device_id] + link_index;
+}
+
 int Topology::get_dims_count() const noexcept {
   assert(dims_count > 0);
 
@@ -56,6 +153,125 @@ std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
   return bandwidth_per_dim;
 }
 
+void Topology::bind_chunk_pool(std::shared_ptr<ChunkPool> chunk_pool) noexcept {
+  assert(chunk_pool != nullptr);
+
+  this->chunk_pool = std::move(chunk_pool);
+}
+
+std::shared_ptr<ChunkPool> Topology::get_chunk_pool() const noexcept {
+  return chunk_pool;
+}
+
+void Topology::set_partitioned(const bool partitioned) noexcept {
+  // size the routing table before the workers read it
+  prepare_routing_table();
+
+  this->partitioned = partitioned;
+}
+
+bool Topology::is_partitioned() const noexcept {
+  return partitioned;
+}
+
+std::unique_ptr<Chunk> Topology::make_chunk(
+    const ChunkSize chunk_size,
+    Route route,
+    const Callback callback,
+    const CallbackArg callback_arg) const noexcept {
+  return make_chunk(
+      chunk_size, std::move(route), InlineCallback(callback, callback_arg));
+}
+
+std::unique_ptr<Chunk> Topology::make_chunk(
+    const ChunkSize chunk_size,
+    Route route,
+    InlineCallback callback) const noexcept {
+  // the chunk pool isn't thread-safe, while partitioned chunks are
+  // destroyed on the worker of their destination
+  if (partitioned) {
+    return std::make_unique<Chunk>(
+        chunk_size, std::move(route), std::move(callback));
+  }
+
+  return chunk_pool->make_chunk(
+      chunk_size, std::move(route), std::move(callback));
+}
+
+Route Topology::route(const DeviceId src, const DeviceId dest) const noexcept {
+  // assert npus are in valid range
+  assert(0 <= src && src < npus_count);
+  assert(0 <= dest && dest < npus_count);
+
+  // worker threads of a ParallelSimulation only read the routing table
+  if (partitioned) {
+    if (const auto* const cached_route = routing_table.find(src, dest)) {
+      return cached_route->borrow();
+    }
+    return construct_resolved_route(src, dest);
+  }
+
+  prepare_routing_table();
+
+  // reuse the cached route, which outlives the chunks of the topology
+  if (const auto* const cached_route = routing_table.find(src, dest)) {
+    route_hits_count++;
+    return cached_route->borrow();
+  }
+
+  // construct the route and cache it
+  route_misses_count++;
+  auto route = construct_resolved_route(src, dest);
+  if (!routing_table.store(src, dest, route)) {
+    return route;
+  }
+  return routing_table.find(src, dest)->borrow();
+}
+
+void Topology::build_routing_table(const int threads_count) noexcept {
+  assert(threads_count > 0);
+
+  prepare_routing_table();
+
+  // each thread fills the rows of every threads_count-th src
+  const auto build_rows = [this, threads_count](const int first_src) {
+    for (auto src = first_src; src < npus_count; src += threads_count) {
+      for (auto dest = 0; dest < npus_count; dest++) {
+        if (routing_table.find(src, dest) == nullptr) {
+          const auto route = construct_resolved_route(src, dest);
+          routing_table.store(src, dest, route);
+        }
+      }
+    }
+  };
+
+  auto workers = std::vector<std::thread>();
+  for (auto i = 1; i < threads_count; i++) {
+    workers.emplace_back(build_rows, i);
+  }
+  build_rows(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void Topology::set_routing_table_capacity(
+    const size_t capacity_bytes) noexcept {
+  routing_table.set_capacity_bytes(capacity_bytes);
+}
+
+const RoutingTable& Topology::get_routing_table() const noexcept {
+  return routing_table;
+}
+
+uint64_t Topology::get_route_hits_count() const noexcept {
+  return route_hits_count;
+}
+
+uint64_t Topology::get_route_misses_count() const noexcept {
+  return route_misses_count;
+}
+
 void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
   assert(chunk != nullptr);
 
@@ -65,10 +281,215 @@ void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
   // assert src is valid
   assert(0 <= src && src < devices_count);
 
+  // reserve the whole route at once
+  if (congestion_model == CongestionModel::Reservation) {
+    reserve_route(std::move(chunk));
+    return;
+  }
+
+  // hybrid: idle routes take the contention-free delay in one event
+  if (congestion_model == CongestionModel::Hybrid) {
+    if (route_is_idle(*chunk)) {
+      reserve_route(std::move(chunk));
+      return;
+    }
+    add_incoming_chunk(*chunk);
+  }
+
   // initiate transmission from src
   devices[src]->send(std::move(chunk));
 }
 
+void Topology::send_batch(
+    const ChunkDescriptor* const descriptors,
+    const size_t descriptors_count,
+    const TaggedCallback callback,
+    const CallbackArg callback_arg) noexcept {
+  assert(callback != nullptr);
+
+  // each chunk carries the callback and its tag inline
+  send_chunks(
+      descriptors,
+      descriptors_count,
+      [callback, callback_arg](const ChunkDescriptor& descriptor) {
+        const auto tag = descriptor.tag;
+        return InlineCallback(
+            [callback, callback_arg, tag]() { callback(callback_arg, tag); });
+      });
+}
+
+void Topology::send_batch(
+    const ChunkDescriptor* const descriptors,
+    const size_t descriptors_count,
+    InlineCallback callback) noexcept {
+  assert(callback);
+
+  // nothing to wait for
+  if (descriptors_count == 0) {
+    callback();
+    return;
+  }
+
+  // one completion record per batch, counting the chunks down
+  auto* const batch = new (batch_arena.allocate(sizeof(BatchCompletion)))
+      BatchCompletion{&batch_arena, descriptors_count, std::move(callback)};
+  send_chunks(descriptors, descriptors_count, [batch](const ChunkDescriptor&) {
+    return InlineCallback([batch]() { batch_chunk_arrived(batch); });
+  });
+}
+
+void Topology::send_message(
+    const DeviceId src,
+    const DeviceId dest,
+    const ChunkSize message_size,
+    const ChunkSize chunk_size,
+    InlineCallback callback) noexcept {
+  assert(chunk_size > 0);
+
+  // full chunks, then the remainder
+  message_chunks.clear();
+  for (auto offset = ChunkSize{0}; offset < message_size;
+       offset += chunk_size) {
+    const auto size = std::min(chunk_size, message_size - offset);
+    message_chunks.push_back({src, dest, size, 0});
+  }
+
+  // the chunks share the route and one completion counter
+  send_batch(message_chunks.data(), message_chunks.size(), std::move(callback));
+}
+
+void Topology::send_message_in_chunks(
+    const DeviceId src,
+    const DeviceId dest,
+    const ChunkSize message_size,
+    const int chunks_count,
+    InlineCallback callback) noexcept {
+  assert(chunks_count > 0);
+
+  // no chunk smaller than 1 byte
+  const auto count =
+      std::min(static_cast<ChunkSize>(chunks_count), message_size);
+
+  // the first (message_size % count) chunks hold one more byte
+  message_chunks.clear();
+  for (auto i = ChunkSize{0}; i < count; i++) {
+    const auto size =
+        (message_size / count) + ((i < message_size % count) ? 1 : 0);
+    message_chunks.push_back({src, dest, size, 0});
+  }
+
+  send_batch(message_chunks.data(), message_chunks.size(), std::move(callback));
+}
+
+void Topology::set_congestion_model(
+    const CongestionModel congestion_model) noexcept {
+  this->congestion_model = congestion_model;
+
+  // links queue the chunks by the model
+  for (auto& link : links) {
+    link.set_congestion_model(congestion_model);
+  }
+}
+
+CongestionModel Topology::get_congestion_model() const noexcept {
+  return congestion_model;
+}
+
+void Topology::reserve_route(std::unique_ptr<Chunk> chunk) noexcept {
+  assert(chunk != nullptr);
+
+  // only the arrival at the dest is an event
+  const auto arrival_time = reserve_links(*chunk);
+  auto* const chunk_ptr = static_cast<void*>(chunk.release());
+  event_queue->schedule_event(
+      arrival_time, EventKind::ChunkArrived, chunk_ptr);
+}
+
+bool Topology::route_is_idle(const Chunk& chunk) const noexcept {
+  assert(!chunk.arrived_dest());
+  assert(event_queue != nullptr);
+
+  // walk the route as the chunk would without contention
+  const auto& route = chunk.get_route();
+  const auto chunk_size = chunk.get_size();
+  auto ready_time = event_queue->get_current_time();
+  for (auto hop = 0; hop < route.size() - 1; hop++) {
+    const auto* const link =
+        route.device(hop)->get_link_at(route.link_index(hop));
+    if (!link->is_idle(ready_time, chunk_size)) {
+      return false;
+    }
+    ready_time += link->communication_delay(chunk_size);
+  }
+
+  return true;
+}
+
+void Topology::add_incoming_chunk(const Chunk& chunk) noexcept {
+  assert(!chunk.arrived_dest());
+
+  const auto& route = chunk.get_route();
+  for (auto hop = 0; hop < route.size() - 1; hop++) {
+    auto* const link = route.device(hop)->get_link_at(route.link_index(hop));
+    link->add_incoming_chunk();
+  }
+}
+
+EventTime Topology::reserve_links(Chunk& chunk) noexcept {
+  assert(!chunk.arrived_dest());
+  assert(event_queue != nullptr);
+
+  // reserve each link when the chunk arrives at it
+  const auto chunk_size = chunk.get_size();
+  auto arrival_time = event_queue->get_current_time();
+  while (true) {
+    auto* const link =
+        chunk.current_device()->get_link_at(chunk.next_link_index());
+    arrival_time = link->reserve(chunk_size, arrival_time);
+    if (chunk.next_device_is_dest()) {
+      break;
+    }
+    chunk.mark_arrived_next_device();
+  }
+
+  return arrival_time;
+}
+
+template <typename MakeCallback>
+void Topology::send_chunks(
+    const ChunkDescriptor* const descriptors,
+    const size_t descriptors_count,
+    const MakeCallback make_callback) noexcept {
+  assert(descriptors_count == 0 || descriptors != nullptr);
+  assert(event_queue != nullptr);
+
+  // batch completions are shared by the whole topology,
+  // while the chunks of a ParallelSimulation are sent by its worker threads
+  if (partitioned) {
+    std::cerr << "[Error] (network/analytical/congestion_aware) "
+              << "batched sends are not supported by ParallelSimulation"
+              << std::endl;
+    std::exit(-1);
+  }
+
+  auto route = Route();
+  for (auto i = size_t{0}; i < descriptors_count; i++) {
+    const auto& descriptor = descriptors[i];
+    assert(descriptor.src != descriptor.dest);
+
+    // consecutive chunks of the same (src, dest) share the route
+    if (i == 0 || descriptor.src != descriptors[i - 1].src ||
+        descriptor.dest != descriptors[i - 1].dest) {
+      route = this->route(descriptor.src, descriptor.dest);
+    }
+    auto chunk = chunk_pool->make_chunk(
+        descriptor.chunk_size, route, make_callback(descriptor));
+
+    // sent as one by one, so the arrivals are ordered alike
+    send(std::move(chunk));
+  }
+}
+
 void Topology::connect(
     const DeviceId src,
     const DeviceId dest,
@@ -83,12 +504,64 @@ void Topology::connect(
   assert(bandwidth > 0);
   assert(latency >= 0);
 
-  // connect src -> dest
-  devices[src]->connect(dest, bandwidth, latency);
+  // register src -> dest
+  connections.push_back({src, dest, bandwidth, latency});
 
-  // if bidirectional, connect dest -> src
+  // if bidirectional, register dest -> src
   if (bidirectional) {
-    devices[dest]->connect(src, bandwidth, latency);
+    connections.push_back({dest, src, bandwidth, latency});
+  }
+}
+
+void Topology::build_adjacency() noexcept {
+  assert(devices.size() == devices_count);
+  assert(links.empty());
+
+  // group the connections by src, sorted by dest
+  std::sort(
+      connections.begin(),
+      connections.end(),
+      [](const Connection& lhs, const Connection& rhs) {
+        return (lhs.src != rhs.src) ? (lhs.src < rhs.src)
+                                    : (lhs.dest < rhs.dest);
+      });
+
+  // construct the links in CSR order;
+  // the array is never resized afterwards, so links don't move
+  links.reserve(connections.size());
+  link_dests.reserve(connections.size());
+  link_offsets.assign(devices_count + 1, 0);
+  for (size_t i = 0; i < connections.size(); i++) {
+    const auto& connection = connections[i];
+
+    // assert there's no duplicate connection
+    assert(
+        i == 0 || connections[i - 1].src != connection.src ||
+        connections[i - 1].dest != connection.dest);
+
+    links.emplace_back(connection.bandwidth, connection.latency);
+    links.back().set_link_id(static_cast<int>(i));
+    if (event_queue != nullptr) {
+      links.back().set_event_queue(event_queue.get());
+    }
+    link_dests.push_back(connection.dest);
+    link_offsets[connection.src + 1]++;
+  }
+  connections.clear();
+  connections.shrink_to_fit();
+
+  // prefix sum of the out-degrees
+  for (auto i = 0; i < devices_count; i++) {
+    link_offsets[i + 1] += link_offsets[i];
+  }
+
+  // pass each device its slice of the links
+  for (auto i = 0; i < devices_count; i++) {
+    const auto offset = link_offsets[i];
+    devices[i]->set_links(
+        links.data() + offset,
+        link_dests.data() + offset,
+        link_offsets[i + 1] - offset);
   }
 }
 
@@ -98,3 +571,28 @@ void Topology::instantiate_devices() noexcept {
     devices.push_back(std::make_shared<Device>(i));
   }
 }
+
+void Topology::prepare_routing_table() const noexcept {
+  assert(npus_count > 0);
+
+  // size the routing table on the first use
+  if (routing_table.get_npus_count() != npus_count) {
+    routing_table.reset(npus_count);
+  }
+}
+
+Route Topology::construct_resolved_route(
+    const DeviceId src,
+    const DeviceId dest) const noexcept {
+  // assert the links are constructed
+  assert(!link_offsets.empty());
+
+  // resolve the link of each hop
+  auto route = construct_route(src, dest);
+  for (auto hop = 0; hop < route.size() - 1; hop++) {
+    const auto& device = devices[route[hop]];
+    route.set_link_index(hop, device->get_link_index(route[hop + 1]));
+  }
+
+  return route;
+}
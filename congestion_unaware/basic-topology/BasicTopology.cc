@@ -5,6 +5,10 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_unaware/BasicTopology.hh"
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
 #include "common/NetworkFunction.hh"
 
 using namespace NetworkAnalytical;
@@ -15,6 +19,7 @@ BasicTopology::BasicTopology(
     const Bandwidth bandwidth,
     const Latency latency) noexcept
     : latency(latency),
+      delay_table_enabled(false),
       basic_topology_type(TopologyBuildingBlock::Undefined),
       Topology() {
   assert(npus_count > 0);
@@ -44,9 +49,15 @@ EventTime BasicTopology::send(
   assert(src != dest);
   assert(chunk_size > 0);
 
-  // get hops count
+  // get hops count, cheaper than a table load on a single dimension
   auto hops_count = compute_hops_count(src, dest);
 
+  // load-aware: queue at every hop
+  if (!queueing_factor_per_dim.empty()) {
+    return compute_loaded_communication_delay(
+        hops_count, chunk_size, queueing_factor_per_dim[0]);
+  }
+
   // return communication delay
   return compute_communication_delay(hops_count, chunk_size);
 }
@@ -68,8 +79,202 @@ EventTime BasicTopology::compute_communication_delay(
   return static_cast<EventTime>(comms_delay);
 }
 
+EventTime BasicTopology::compute_loaded_communication_delay(
+    const int hops_count,
+    const ChunkSize chunk_size,
+    const double queueing_factor) const noexcept {
+  assert(hops_count > 0);
+  assert(chunk_size > 0);
+  assert(queueing_factor >= 0);
+
+  // compute link delay and serialization delay
+  const auto link_delay = hops_count * latency;
+  const auto serialization_delay =
+      static_cast<double>(chunk_size) / bandwidth_Bpns;
+
+  // each hop waits behind the other traffic of its link
+  const auto queueing_delay =
+      hops_count * queueing_factor * serialization_delay;
+
+  return static_cast<EventTime>(
+      link_delay + serialization_delay + queueing_delay);
+}
+
 TopologyBuildingBlock BasicTopology::get_basic_topology_type() const noexcept {
   assert(basic_topology_type != TopologyBuildingBlock::Undefined);
 
   return basic_topology_type;
 }
+
+Latency BasicTopology::get_latency() const noexcept {
+  return latency;
+}
+
+EventTime BasicTopology::compute_phase_time(
+    const CollectiveType type,
+    const CollectiveAlgorithm algorithm,
+    const ChunkSize size) const noexcept {
+  assert(size > 0);
+
+  // nothing to send on a single NPU
+  const auto p = npus_count;
+  if (p == 1) {
+    return 0;
+  }
+
+  // the steps mirror the congestion-aware Collective,
+  // e.g., a Ring step passes a 1/p of the data to the next NPU
+  auto phase_time = EventTime{0};
+  switch (type) {
+    case CollectiveType::ReduceScatter:
+      switch (algorithm) {
+        case CollectiveAlgorithm::Ring:
+          return (p - 1) * compute_step_time(1, split_size(size, p));
+        case CollectiveAlgorithm::Direct:
+          return compute_direct_step_time(split_size(size, p));
+        case CollectiveAlgorithm::HalvingDoubling:
+          // exchange half of the data at halving distances
+          assert((p & (p - 1)) == 0);
+          for (auto distance = p / 2; distance > 0; distance /= 2) {
+            phase_time +=
+                compute_step_time(distance, split_size(size, p / distance));
+          }
+          return phase_time;
+        default:
+          break;
+      }
+      break;
+    case CollectiveType::AllGather:
+      switch (algorithm) {
+        case CollectiveAlgorithm::Ring:
+          return (p - 1) * compute_step_time(1, split_size(size, p));
+        case CollectiveAlgorithm::Direct:
+          return compute_direct_step_time(split_size(size, p));
+        case CollectiveAlgorithm::HalvingDoubling:
+          // exchange the gathered data at doubling distances
+          assert((p & (p - 1)) == 0);
+          for (auto distance = 1; distance < p; distance *= 2) {
+            phase_time +=
+                compute_step_time(distance, split_size(size, p / distance));
+          }
+          return phase_time;
+        default:
+          break;
+      }
+      break;
+    case CollectiveType::AllToAll:
+      switch (algorithm) {
+        case CollectiveAlgorithm::Ring:
+          // pairwise exchange: send to the NPU (step + 1) away at each step
+          for (auto distance = 1; distance < p; distance++) {
+            phase_time += compute_step_time(distance, split_size(size, p));
+          }
+          return phase_time;
+        case CollectiveAlgorithm::Direct:
+          return compute_direct_step_time(split_size(size, p));
+        default:
+          // HalvingDoubling isn't supported for All-to-All
+          break;
+      }
+      break;
+    case CollectiveType::Broadcast:
+      switch (algorithm) {
+        case CollectiveAlgorithm::Ring:
+          return (p - 1) * compute_step_time(1, size);
+        case CollectiveAlgorithm::Direct:
+          return compute_direct_step_time(size);
+        case CollectiveAlgorithm::HalvingDoubling:
+          // binomial tree: the NPUs holding the data double at each step
+          for (auto distance = 1; distance < p; distance *= 2) {
+            phase_time += compute_step_time(distance, size);
+          }
+          return phase_time;
+        default:
+          break;
+      }
+      break;
+    default:
+      // All-Reduce is composed of Reduce-Scatter and All-Gather phases
+      break;
+  }
+
+  // shouldn't reach here
+  std::cerr << "[Error] (network/analytical/congestion_unaware): "
+            << "Not supported collective phase" << std::endl;
+  std::exit(-1);
+}
+
+CollectiveAlgorithm BasicTopology::get_default_collective_algorithm()
+    const noexcept {
+  // Ring passes the data to the neighbors,
+  // FullyConnected and Switch reach every NPU directly
+  switch (get_basic_topology_type()) {
+    case TopologyBuildingBlock::Ring:
+      return CollectiveAlgorithm::Ring;
+    default:
+      return CollectiveAlgorithm::Direct;
+  }
+}
+
+void BasicTopology::compute_hops_count_per_dim(
+    const DeviceId src,
+    const DeviceId dest,
+    int* const hops_count_per_dim) const noexcept {
+  assert(hops_count_per_dim != nullptr);
+
+  hops_count_per_dim[0] = compute_hops_count(src, dest);
+}
+
+const BasicTopology& BasicTopology::get_basic_topology(
+    const int dim) const noexcept {
+  assert(dim == 0);
+
+  return *this;
+}
+
+void BasicTopology::enable_delay_table() noexcept {
+  delay_table_enabled = true;
+  build_delay_table();
+}
+
+void BasicTopology::build_delay_table() noexcept {
+  // send() doesn't read the table: build it only for a MultiDimTopology
+  if (!delay_table_enabled) {
+    return;
+  }
+
+  // class i: i hops, same arithmetic as compute_communication_delay()
+  auto delay_classes = std::vector<DelayTable::DelayClass>();
+  for (auto hops_count = 0; hops_count <= compute_max_hops_count();
+       hops_count++) {
+    delay_classes.push_back({hops_count * latency, bandwidth_Bpns});
+  }
+  if (!delay_table.reset(npus_count, std::move(delay_classes))) {
+    return;
+  }
+
+  for (auto src = 0; src < npus_count; src++) {
+    for (auto dest = 0; dest < npus_count; dest++) {
+      if (src != dest) {
+        delay_table.store(src, dest, compute_hops_count(src, dest));
+      }
+    }
+  }
+}
+
+EventTime BasicTopology::compute_step_time(
+    const int distance,
+    const ChunkSize chunk_size) const noexcept {
+  assert(0 < distance && distance < npus_count);
+
+  // every NPU sends to the NPU at the same distance
+  const auto hops_count = compute_hops_count(0, distance);
+  return compute_communication_delay(hops_count, chunk_size);
+}
+
+EventTime BasicTopology::compute_direct_step_time(
+    const ChunkSize chunk_size) const noexcept {
+  // the chunk to the farthest NPU arrives last
+  const auto hops_count = compute_max_hops_count();
+  return compute_communication_delay(hops_count, chunk_size);
+}
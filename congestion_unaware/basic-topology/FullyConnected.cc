@@ -22,6 +22,27 @@ FullyConnected::FullyConnected(
   basic_topology_type = TopologyBuildingBlock::FullyConnected;
 }
 
+void FullyConnected::send_batch(
+    const DeviceId* const srcs,
+    const DeviceId* const dests,
+    const ChunkSize* const chunk_sizes,
+    EventTime* const delays,
+    const size_t queries_count) const noexcept {
+  assert(queries_count == 0 || srcs != nullptr);
+  assert(queries_count == 0 || dests != nullptr);
+  assert(queries_count == 0 || chunk_sizes != nullptr);
+  assert(queries_count == 0 || delays != nullptr);
+
+  // every query is 1 hop
+  compute_communication_delays(
+      [](const DeviceId, const DeviceId) { return 1; },
+      srcs,
+      dests,
+      chunk_sizes,
+      delays,
+      queries_count);
+}
+
 int FullyConnected::compute_hops_count(const DeviceId src, const DeviceId dest)
     const noexcept {
   assert(0 <= src && src < npus_count);
@@ -31,3 +52,13 @@ int FullyConnected::compute_hops_count(const DeviceId src, const DeviceId dest)
   // for FullyConnected, hops_count is always 1 (src -> dest)
   return 1;
 }
+
+int FullyConnected::compute_max_hops_count() const noexcept {
+  // every NPU is 1 hop away
+  return 1;
+}
+
+int FullyConnected::compute_links_count() const noexcept {
+  // one link from each NPU to every other NPU
+  return npus_count * (npus_count - 1);
+}
@@ -24,6 +24,29 @@ Ring::Ring(
   basic_topology_type = TopologyBuildingBlock::Ring;
 }
 
+void Ring::send_batch(
+    const DeviceId* const srcs,
+    const DeviceId* const dests,
+    const ChunkSize* const chunk_sizes,
+    EventTime* const delays,
+    const size_t queries_count) const noexcept {
+  assert(queries_count == 0 || srcs != nullptr);
+  assert(queries_count == 0 || dests != nullptr);
+  assert(queries_count == 0 || chunk_sizes != nullptr);
+  assert(queries_count == 0 || delays != nullptr);
+
+  // Ring is final, so compute_hops_count() is inlined into the loop
+  compute_communication_delays(
+      [this](const DeviceId src, const DeviceId dest) {
+        return compute_hops_count(src, dest);
+      },
+      srcs,
+      dests,
+      chunk_sizes,
+      delays,
+      queries_count);
+}
+
 int Ring::compute_hops_count(const DeviceId src, const DeviceId dest)
     const noexcept {
   assert(0 <= src && src < npus_count);
@@ -53,3 +76,18 @@ int Ring::compute_hops_count(const DeviceId src, const DeviceId dest)
   return (clockwise_distance < anticlockwise_distance) ? clockwise_distance
                                                        : anticlockwise_distance;
 }
+
+int Ring::compute_max_hops_count() const noexcept {
+  // unidirectional: the NPU right behind is the farthest
+  if (!bidirectional) {
+    return npus_count - 1;
+  }
+
+  // bidirectional: the NPU across the ring is the farthest
+  return npus_count / 2;
+}
+
+int Ring::compute_links_count() const noexcept {
+  // one link per NPU in each direction
+  return bidirectional ? (2 * npus_count) : npus_count;
+}
@@ -22,6 +22,27 @@ Switch::Switch(
   basic_topology_type = TopologyBuildingBlock::Switch;
 }
 
+void Switch::send_batch(
+    const DeviceId* const srcs,
+    const DeviceId* const dests,
+    const ChunkSize* const chunk_sizes,
+    EventTime* const delays,
+    const size_t queries_count) const noexcept {
+  assert(queries_count == 0 || srcs != nullptr);
+  assert(queries_count == 0 || dests != nullptr);
+  assert(queries_count == 0 || chunk_sizes != nullptr);
+  assert(queries_count == 0 || delays != nullptr);
+
+  // every query is 2 hops, through the switch
+  compute_communication_delays(
+      [](const DeviceId, const DeviceId) { return 2; },
+      srcs,
+      dests,
+      chunk_sizes,
+      delays,
+      queries_count);
+}
+
 int Switch::compute_hops_count(const DeviceId src, const DeviceId dest)
     const noexcept {
   assert(0 <= src && src < npus_count);
@@ -31,3 +52,13 @@ int Switch::compute_hops_count(const DeviceId src, const DeviceId dest)
   // for switch, hops_count is always 2 (src -> switch -> dest)
   return 2;
 }
+
+int Switch::compute_max_hops_count() const noexcept {
+  // every NPU is 2 hops away, through the switch
+  return 2;
+}
+
+int Switch::compute_links_count() const noexcept {
+  // one uplink and one downlink per NPU
+  return 2 * npus_count;
+}
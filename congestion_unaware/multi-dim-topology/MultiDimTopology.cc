@@ -4,17 +4,29 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/MultiDimTopology.hh"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "common/NetworkFunction.hh"
+#include "congestion_unaware/FullyConnected.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
-MultiDimTopology::MultiDimTopology() noexcept : Topology() {
+MultiDimTopology::MultiDimTopology() noexcept
+    : Topology(), path_cost_model(PathCostModel::FirstDim) {
   // initialize values
   topology_per_dim.clear();
   npus_count_per_dim = {};
+  stride_per_dim = {};
 
   // initialize topology shape
   npus_count = 1;
@@ -25,28 +37,301 @@ EventTime MultiDimTopology::send(
     const DeviceId src,
     const DeviceId dest,
     const ChunkSize chunk_size) const noexcept {
+  // precomputed delay model of the pair
+  if (uses_delay_table()) {
+    return delay_table.lookup(src, dest, chunk_size);
+  }
+
   // translate src and dest to multi-dim address
   const auto src_address = translate_address(src);
   const auto dest_address = translate_address(dest);
 
-  // get dim to transfer
-  const auto dim_to_transfer = get_dim_to_transfer(src_address, dest_address);
-  
-  // prepare localized topology and address info
-  auto* const topology = topology_per_dim[dim_to_transfer].get();
-  const auto src_local_id = src_address[dim_to_transfer];
-  const auto dest_local_id = dest_address[dim_to_transfer];
+  return send_addresses(src_address, dest_address, chunk_size);
+}
+
+EventTime MultiDimTopology::send_addresses(
+    const MultiDimAddress& src_address,
+    const MultiDimAddress& dest_address,
+    const ChunkSize chunk_size) const noexcept {
+  assert(chunk_size > 0);
+
+  if (path_cost_model == PathCostModel::FirstDim) {
+    // get dim to transfer
+    const auto dim_to_transfer =
+        get_dim_to_transfer(src_address, dest_address);
+
+    // prepare localized topology and address info
+    const auto* const topology = topology_per_dim[dim_to_transfer].get();
+    const auto src_local_id = src_address[dim_to_transfer];
+    const auto dest_local_id = dest_address[dim_to_transfer];
+
+    // load-aware: queue at every hop of the dim
+    if (!queueing_factor_per_dim.empty()) {
+      const auto hops_count = compute_hops_count_on_dim(
+          dim_to_transfer, src_local_id, dest_local_id);
+      return topology->compute_loaded_communication_delay(
+          hops_count, chunk_size, queueing_factor_per_dim[dim_to_transfer]);
+    }
+
+    // per-dimension table, if the all-pairs table doesn't fit
+    const auto& dim_delay_table = topology->get_delay_table();
+    if (!dim_delay_table.empty()) {
+      return dim_delay_table.lookup(src_local_id, dest_local_id, chunk_size);
+    }
+
+    // run localized communication
+    const auto hops_count = compute_hops_count_on_dim(
+        dim_to_transfer, src_local_id, dest_local_id);
+    return topology->compute_communication_delay(hops_count, chunk_size);
+  }
+
+  // route through every differing dim, in dimension order
+  const auto load_aware = !queueing_factor_per_dim.empty();
+  auto link_delay = 0.0;
+  auto serialization_delay = 0.0;
+  auto queueing_delay = 0.0;
+  auto bottleneck_bandwidth_Bpns = std::numeric_limits<Bandwidth>::max();
+  for (auto dim = 0; dim < dims_count; dim++) {
+    if (src_address[dim] == dest_address[dim]) {
+      continue;
+    }
+    const auto hops_count =
+        compute_hops_count_on_dim(dim, src_address[dim], dest_address[dim]);
+    const auto bandwidth_Bpns = bandwidth_Bpns_per_dim[dim];
+    link_delay += hops_count * latency_per_dim[dim];
+
+    // load-aware: queue at every hop of the dim
+    if (load_aware) {
+      queueing_delay += hops_count * queueing_factor_per_dim[dim] *
+          (static_cast<double>(chunk_size) / bandwidth_Bpns);
+    }
+
+    if (path_cost_model == PathCostModel::StoreAndForward) {
+      // each hop serializes the whole chunk again
+      serialization_delay +=
+          hops_count * (static_cast<double>(chunk_size) / bandwidth_Bpns);
+    } else {
+      // pipelined: the slowest dim bounds the streaming rate
+      bottleneck_bandwidth_Bpns =
+          std::min(bottleneck_bandwidth_Bpns, bandwidth_Bpns);
+    }
+  }
+  if (path_cost_model == PathCostModel::Pipelined) {
+    serialization_delay =
+        static_cast<double>(chunk_size) / bottleneck_bandwidth_Bpns;
+  }
+
+  return static_cast<EventTime>(
+      link_delay + serialization_delay + queueing_delay);
+}
+
+int MultiDimTopology::compute_hops_count_on_dim(
+    const int dim,
+    const DeviceId src_local_id,
+    const DeviceId dest_local_id) const noexcept {
+  assert(0 <= dim && dim < dims_count);
+
+  // building blocks are final, so their hops count is called directly
+  const auto& topology = *topology_per_dim[dim];
+  switch (topology.get_basic_topology_type()) {
+    case TopologyBuildingBlock::Ring:
+      return static_cast<const Ring&>(topology).compute_hops_count(
+          src_local_id, dest_local_id);
+    case TopologyBuildingBlock::FullyConnected:
+      return static_cast<const FullyConnected&>(topology).compute_hops_count(
+          src_local_id, dest_local_id);
+    case TopologyBuildingBlock::Switch:
+      return static_cast<const Switch&>(topology).compute_hops_count(
+          src_local_id, dest_local_id);
+    default:
+      break;
+  }
+
+  // shouldn't reach here
+  std::cerr << "[Error] (network/analytical/congestion_unaware): "
+            << "Not supported building block" << std::endl;
+  std::exit(-1);
+}
+
+void MultiDimTopology::send_traffic_matrix(
+    const ChunkSize* const chunk_sizes,
+    EventTime* const delays) const noexcept {
+  assert(chunk_sizes != nullptr);
+  assert(delays != nullptr);
+
+  const auto use_delay_table = uses_delay_table();
+  for (auto src = 0; src < npus_count; src++) {
+    // one translation of src per row
+    const auto src_address = translate_address(src);
+    const auto row = static_cast<size_t>(src) * npus_count;
+    for (auto dest = 0; dest < npus_count; dest++) {
+      const auto chunk_size = chunk_sizes[row + dest];
+      if (src == dest || chunk_size == 0) {
+        delays[row + dest] = 0;
+      } else if (use_delay_table) {
+        delays[row + dest] = delay_table.lookup(src, dest, chunk_size);
+      } else {
+        delays[row + dest] =
+            send_addresses(src_address, translate_address(dest), chunk_size);
+      }
+    }
+  }
+}
+
+void MultiDimTopology::compute_hops_count_per_dim(
+    const DeviceId src,
+    const DeviceId dest,
+    int* const hops_count_per_dim) const noexcept {
+  assert(hops_count_per_dim != nullptr);
+
+  const auto src_address = translate_address(src);
+  const auto dest_address = translate_address(dest);
+  for (auto dim = 0; dim < dims_count; dim++) {
+    hops_count_per_dim[dim] = 0;
+  }
+
+  // FirstDim: the route stays within the first differing dim
+  if (path_cost_model == PathCostModel::FirstDim) {
+    const auto dim = get_dim_to_transfer(src_address, dest_address);
+    hops_count_per_dim[dim] =
+        compute_hops_count_on_dim(dim, src_address[dim], dest_address[dim]);
+    return;
+  }
+
+  // otherwise, through every differing dim
+  for (auto dim = 0; dim < dims_count; dim++) {
+    if (src_address[dim] != dest_address[dim]) {
+      hops_count_per_dim[dim] =
+          compute_hops_count_on_dim(dim, src_address[dim], dest_address[dim]);
+    }
+  }
+}
+
+bool MultiDimTopology::uses_delay_table() const noexcept {
+  // the tables hold the unloaded delay of the first dim only
+  return path_cost_model == PathCostModel::FirstDim && !delay_table.empty() &&
+      queueing_factor_per_dim.empty();
+}
 
-  // run localized communication
-  const auto comms_delay =
-      topology->send(src_local_id, dest_local_id, chunk_size);
+void MultiDimTopology::set_path_cost_model(
+    const PathCostModel path_cost_model) noexcept {
+  this->path_cost_model = path_cost_model;
+}
 
-  // return communication delay
-  return comms_delay;
+PathCostModel MultiDimTopology::get_path_cost_model() const noexcept {
+  return path_cost_model;
+}
+
+void MultiDimTopology::send_batch(
+    const DeviceId* const srcs,
+    const DeviceId* const dests,
+    const ChunkSize* const chunk_sizes,
+    EventTime* const delays,
+    const size_t queries_count) const noexcept {
+  assert(queries_count == 0 || srcs != nullptr);
+  assert(queries_count == 0 || dests != nullptr);
+  assert(queries_count == 0 || chunk_sizes != nullptr);
+  assert(queries_count == 0 || delays != nullptr);
+
+  // charging every dim or the load costs O(dims) per query anyway
+  if (path_cost_model != PathCostModel::FirstDim ||
+      !queueing_factor_per_dim.empty()) {
+    for (auto i = size_t{0}; i < queries_count; i++) {
+      delays[i] = send(srcs[i], dests[i], chunk_sizes[i]);
+    }
+    return;
+  }
+
+  // precomputed delay model of every pair
+  if (!delay_table.empty()) {
+    for (auto i = size_t{0}; i < queries_count; i++) {
+      delays[i] = delay_table.lookup(srcs[i], dests[i], chunk_sizes[i]);
+    }
+    return;
+  }
+
+  // per-block scratch on the stack, so nothing is allocated
+  constexpr auto block_size = size_t{256};
+  auto dims = std::array<int, block_size>();
+  auto local_srcs = std::array<DeviceId, block_size>();
+  auto local_dests = std::array<DeviceId, block_size>();
+  auto gathered_srcs = std::array<DeviceId, block_size>();
+  auto gathered_dests = std::array<DeviceId, block_size>();
+  auto gathered_chunk_sizes = std::array<ChunkSize, block_size>();
+  auto gathered_delays = std::array<EventTime, block_size>();
+  auto gathered_queries = std::array<size_t, block_size>();
+
+  for (auto first = size_t{0}; first < queries_count; first += block_size) {
+    const auto block_queries_count =
+        std::min(block_size, queries_count - first);
+
+    // the dim to transfer is the lowest dim where the addresses differ
+    for (auto i = size_t{0}; i < block_queries_count; i++) {
+      assert(0 <= srcs[first + i] && srcs[first + i] < npus_count);
+      assert(0 <= dests[first + i] && dests[first + i] < npus_count);
+      assert(srcs[first + i] != dests[first + i]);
+      auto src = static_cast<uint32_t>(srcs[first + i]);
+      auto dest = static_cast<uint32_t>(dests[first + i]);
+
+      auto dim = 0;
+      while (src % npus_count_per_dim[dim] == dest % npus_count_per_dim[dim]) {
+        src /= npus_count_per_dim[dim];
+        dest /= npus_count_per_dim[dim];
+        dim++;
+      }
+      dims[i] = dim;
+      local_srcs[i] = src % npus_count_per_dim[dim];
+      local_dests[i] = dest % npus_count_per_dim[dim];
+    }
+
+    // one batch per dim: gather its queries, send, and scatter the delays
+    for (auto dim = 0; dim < dims_count; dim++) {
+      auto gathered_count = size_t{0};
+      for (auto i = size_t{0}; i < block_queries_count; i++) {
+        // branch-free compaction: always write, advance only on a match
+        gathered_srcs[gathered_count] = local_srcs[i];
+        gathered_dests[gathered_count] = local_dests[i];
+        gathered_chunk_sizes[gathered_count] = chunk_sizes[first + i];
+        gathered_queries[gathered_count] = first + i;
+        gathered_count += (dims[i] == dim) ? 1 : 0;
+      }
+      if (gathered_count == 0) {
+        continue;
+      }
+
+      topology_per_dim[dim]->send_batch(
+          gathered_srcs.data(),
+          gathered_dests.data(),
+          gathered_chunk_sizes.data(),
+          gathered_delays.data(),
+          gathered_count);
+      for (auto i = size_t{0}; i < gathered_count; i++) {
+        delays[gathered_queries[i]] = gathered_delays[i];
+      }
+    }
+  }
 }
 
 void MultiDimTopology::append_dimension(
     std::unique_ptr<BasicTopology> topology) noexcept {
+  // addresses are fixed-capacity
+  if (dims_count >= max_dims_count) {
+    std::cerr << "[Error] (network/analytical/congestion_unaware): "
+              << "More than " << max_dims_count << " dimensions" << std::endl;
+    std::exit(-1);
+  }
+
+  // the table of the dimension is built once it serves this topology
+  topology->enable_delay_table();
+
+  // stride of the new dimension
+  stride_per_dim.push_back(npus_count);
+
+  // latency and bandwidth of the new dimension
+  latency_per_dim.push_back(topology->get_latency());
+  bandwidth_Bpns_per_dim.push_back(
+      bw_GBps_to_Bpns(topology->get_bandwidth_per_dim()[0]));
+
   // increment dims_count
   dims_count++;
 
@@ -61,41 +346,76 @@ void MultiDimTopology::append_dimension(
   // push back topology and npus_count
   topology_per_dim.push_back(std::move(topology));
   npus_count_per_dim.push_back(topology_size);
-}
 
-MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(
-    const DeviceId npu_id) const noexcept {
-  // If units-count if [2, 8, 4], and the given id is 47, then the id should be
-  // 47 // 16 = 2, leftover = 47 % 16 = 15
-  // 15 // 2 = 7, leftover = 15 % 2 = 1
-  // 1 // 1 = 1, leftover = 0
-  // therefore the address is [1, 7, 2]
+  // the registered load was for the previous shape
+  clear_utilization();
 
-  // create empty address
-  auto multi_dim_address = MultiDimAddress();
-  for (auto i = 0; i < dims_count; i++) {
-    multi_dim_address.push_back(-1);
-  }
+  // precompute the delay model of the new shape
+  build_delay_table();
+}
 
-  auto leftover = npu_id;
-  auto denominator = npus_count;
+const BasicTopology& MultiDimTopology::get_basic_topology(
+    const int dim) const noexcept {
+  assert(0 <= dim && dim < dims_count);
 
-  for (auto dim = dims_count - 1; dim >= 0; dim--) {
-    // change denominator
-    denominator /= npus_count_per_dim[dim];
+  return *topology_per_dim[dim];
+}
 
-    // get and update address
-    const auto quotient = leftover / denominator;
-    leftover %= denominator;
+void MultiDimTopology::build_delay_table() noexcept {
+  // the classes of dim d follow those of the dims before it
+  auto delay_classes = std::vector<DelayTable::DelayClass>();
+  auto class_offsets = std::vector<int>();
+  for (const auto& topology : topology_per_dim) {
+    const auto& dim_delay_table = topology->get_delay_table();
+    if (dim_delay_table.empty()) {
+      delay_table.clear();
+      return;
+    }
+    class_offsets.push_back(static_cast<int>(delay_classes.size()));
+    const auto& dim_delay_classes = dim_delay_table.get_delay_classes();
+    delay_classes.insert(
+        delay_classes.end(),
+        dim_delay_classes.begin(),
+        dim_delay_classes.end());
+  }
+  if (!delay_table.reset(npus_count, std::move(delay_classes))) {
+    return;
+  }
+
+  // translate each NPU once, instead of once per pair
+  auto addresses = std::vector<MultiDimAddress>();
+  for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+    addresses.push_back(translate_address(npu_id));
+  }
 
-    // update address
-    multi_dim_address[dim] = quotient;
+  for (auto src = 0; src < npus_count; src++) {
+    for (auto dest = 0; dest < npus_count; dest++) {
+      if (src == dest) {
+        continue;
+      }
+      const auto& src_address = addresses[src];
+      const auto& dest_address = addresses[dest];
+      const auto dim = get_dim_to_transfer(src_address, dest_address);
+      const auto class_id =
+          topology_per_dim[dim]->get_delay_table().get_class_id(
+              src_address[dim], dest_address[dim]);
+      delay_table.store(src, dest, class_offsets[dim] + class_id);
+    }
   }
+}
 
-  // check address translation
-  for (auto i = 0; i < dims_count; i++) {
-    assert(0 <= multi_dim_address[i]);
-    assert(multi_dim_address[i] < npus_count_per_dim[i]);
+MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(
+    const DeviceId npu_id) const noexcept {
+  assert(0 <= npu_id && npu_id < npus_count);
+
+  // If units-count if [2, 8, 4], the strides are [1, 2, 16],
+  // and the given id is 47, then the address is
+  // (47 / 1) % 2 = 1, (47 / 2) % 8 = 7, (47 / 16) % 4 = 2
+  // therefore the address is [1, 7, 2]
+  auto multi_dim_address = MultiDimAddress();
+  for (auto dim = 0; dim < dims_count; dim++) {
+    multi_dim_address[dim] =
+        (npu_id / stride_per_dim[dim]) % npus_count_per_dim[dim];
   }
 
   // return retrieved address
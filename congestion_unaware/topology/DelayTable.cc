@@ -0,0 +1,80 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/DelayTable.hh"
+#include <limits>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+DelayTable::DelayTable() noexcept
+    : npus_count(0), capacity_bytes(default_capacity_bytes) {}
+
+bool DelayTable::reset(
+    const int npus_count,
+    std::vector<DelayClass> delay_classes) noexcept {
+  assert(npus_count > 0);
+  assert(!delay_classes.empty());
+
+  clear();
+
+  // class ids are stored in 2 bytes
+  if (delay_classes.size() > std::numeric_limits<uint16_t>::max()) {
+    return false;
+  }
+
+  // leave the table empty if it doesn't fit into the memory cap
+  const auto pairs_count = static_cast<size_t>(npus_count) * npus_count;
+  if (pairs_count > capacity_bytes / sizeof(uint16_t)) {
+    return false;
+  }
+
+  this->npus_count = npus_count;
+  this->delay_classes = std::move(delay_classes);
+  class_ids.assign(pairs_count, 0);
+  return true;
+}
+
+void DelayTable::clear() noexcept {
+  npus_count = 0;
+  class_ids.clear();
+  class_ids.shrink_to_fit();
+  delay_classes.clear();
+}
+
+bool DelayTable::empty() const noexcept {
+  return npus_count == 0;
+}
+
+void DelayTable::store(
+    const DeviceId src,
+    const DeviceId dest,
+    const int class_id) noexcept {
+  assert(0 <= src && src < npus_count);
+  assert(0 <= dest && dest < npus_count);
+  assert(0 <= class_id);
+  assert(static_cast<size_t>(class_id) < delay_classes.size());
+
+  class_ids[(static_cast<size_t>(src) * npus_count) + dest] =
+      static_cast<uint16_t>(class_id);
+}
+
+const std::vector<DelayTable::DelayClass>& DelayTable::get_delay_classes()
+    const noexcept {
+  return delay_classes;
+}
+
+void DelayTable::set_capacity_bytes(const size_t capacity_bytes) noexcept {
+  this->capacity_bytes = capacity_bytes;
+}
+
+size_t DelayTable::get_capacity_bytes() const noexcept {
+  return capacity_bytes;
+}
+
+size_t DelayTable::get_used_bytes() const noexcept {
+  return class_ids.size() * sizeof(uint16_t);
+}
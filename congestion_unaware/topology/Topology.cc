@@ -4,13 +4,164 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/Topology.hh"
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "common/NetworkFunction.hh"
+#include "congestion_unaware/BasicTopology.hh"
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 Topology::Topology() noexcept : npus_count(-1), dims_count(-1) {}
 
+EventTime Topology::collective_time(
+    const CollectiveType type,
+    const ChunkSize collective_size,
+    const std::vector<CollectiveAlgorithm>& algorithm_per_dim) const noexcept {
+  assert(collective_size > 0);
+  assert(algorithm_per_dim.size() == static_cast<size_t>(dims_count));
+
+  // size of the data of each NPU before the phase of each dimension,
+  // as scattered by the Reduce-Scatter phases of the previous dimensions
+  auto phases_time = EventTime{0};
+  auto scattered_npus_count = uint64_t{1};
+  for (auto dim = 0; dim < dims_count; dim++) {
+    const auto& topology = get_basic_topology(dim);
+    const auto algorithm = algorithm_per_dim[dim];
+    const auto scattered_size =
+        split_size(collective_size, scattered_npus_count);
+    scattered_npus_count *= npus_count_per_dim[dim];
+
+    switch (type) {
+      case CollectiveType::AllReduce:
+        phases_time += topology.compute_phase_time(
+            CollectiveType::ReduceScatter, algorithm, scattered_size);
+        phases_time += topology.compute_phase_time(
+            CollectiveType::AllGather, algorithm, scattered_size);
+        break;
+      case CollectiveType::ReduceScatter:
+      case CollectiveType::AllGather:
+        phases_time +=
+            topology.compute_phase_time(type, algorithm, scattered_size);
+        break;
+      default:
+        // All-to-All and Broadcast run on the whole data in every dimension
+        phases_time +=
+            topology.compute_phase_time(type, algorithm, collective_size);
+        break;
+    }
+  }
+
+  // phases run one after another
+  return phases_time;
+}
+
+EventTime Topology::collective_time(
+    const CollectiveType type,
+    const ChunkSize collective_size) const noexcept {
+  // default algorithm of each dimension
+  auto algorithm_per_dim = std::vector<CollectiveAlgorithm>();
+  for (auto dim = 0; dim < dims_count; dim++) {
+    algorithm_per_dim.push_back(
+        get_basic_topology(dim).get_default_collective_algorithm());
+  }
+
+  return collective_time(type, collective_size, algorithm_per_dim);
+}
+
+void Topology::set_utilization_per_dim(
+    const std::vector<double>& utilization_per_dim) noexcept {
+  if (utilization_per_dim.size() != static_cast<size_t>(dims_count)) {
+    std::cerr << "[Error] (network/analytical/congestion_unaware): "
+              << "Utilization given for " << utilization_per_dim.size()
+              << " dimensions, but the topology has " << dims_count
+              << std::endl;
+    std::exit(-1);
+  }
+
+  this->utilization_per_dim.clear();
+  queueing_factor_per_dim.clear();
+  for (const auto utilization : utilization_per_dim) {
+    if (utilization < 0) {
+      std::cerr << "[Error] (network/analytical/congestion_unaware): "
+                << "Negative utilization " << utilization << std::endl;
+      std::exit(-1);
+    }
+
+    // saturated links would wait forever
+    const auto capped_utilization = std::min(utilization, max_utilization);
+    this->utilization_per_dim.push_back(capped_utilization);
+
+    // M/D/1 mean wait: rho / (2 * (1 - rho)) service times
+    queueing_factor_per_dim.push_back(
+        capped_utilization / (2 * (1 - capped_utilization)));
+  }
+}
+
+void Topology::set_traffic_matrix(
+    const ChunkSize* const chunk_sizes,
+    const EventTime duration) noexcept {
+  assert(chunk_sizes != nullptr);
+  assert(duration > 0);
+
+  // bytes carried by the links of each dimension, once per hop
+  auto link_bytes_per_dim = std::vector<double>(dims_count, 0);
+  auto hops_count_per_dim = std::vector<int>(dims_count, 0);
+  for (auto src = 0; src < npus_count; src++) {
+    const auto row = static_cast<size_t>(src) * npus_count;
+    for (auto dest = 0; dest < npus_count; dest++) {
+      const auto chunk_size = chunk_sizes[row + dest];
+      if (src == dest || chunk_size == 0) {
+        continue;
+      }
+      compute_hops_count_per_dim(src, dest, hops_count_per_dim.data());
+      for (auto dim = 0; dim < dims_count; dim++) {
+        link_bytes_per_dim[dim] +=
+            hops_count_per_dim[dim] * static_cast<double>(chunk_size);
+      }
+    }
+  }
+
+  // utilization: bytes over what the links of the dimension carry
+  auto utilization_per_dim = std::vector<double>();
+  for (auto dim = 0; dim < dims_count; dim++) {
+    const auto instances_count = npus_count / npus_count_per_dim[dim];
+    const auto links_count = static_cast<double>(instances_count) *
+        get_basic_topology(dim).compute_links_count();
+    const auto capacity_bytes = links_count *
+        bw_GBps_to_Bpns(bandwidth_per_dim[dim]) *
+        static_cast<double>(duration);
+    utilization_per_dim.push_back(link_bytes_per_dim[dim] / capacity_bytes);
+  }
+
+  set_utilization_per_dim(utilization_per_dim);
+}
+
+void Topology::clear_utilization() noexcept {
+  utilization_per_dim.clear();
+  queueing_factor_per_dim.clear();
+}
+
+bool Topology::is_load_aware() const noexcept {
+  return !queueing_factor_per_dim.empty();
+}
+
+std::vector<double> Topology::get_utilization_per_dim() const noexcept {
+  return utilization_per_dim;
+}
+
+void Topology::set_delay_table_capacity(const size_t capacity_bytes) noexcept {
+  delay_table.set_capacity_bytes(capacity_bytes);
+  build_delay_table();
+}
+
+const DelayTable& Topology::get_delay_table() const noexcept {
+  return delay_table;
+}
+
 int Topology::get_npus_count() const noexcept {
   assert(npus_count > 0);
 
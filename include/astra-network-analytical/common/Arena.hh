@@ -0,0 +1,257 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * Arena is a slab allocator with free-list recycling.
+ *
+ * Small blocks (up to max_block_size bytes) are rounded up to a size class
+ * and carved out of large slabs. Freed blocks are pushed into the free list
+ * of their size class and reused by the next allocation of the same class,
+ * so a steady-state workload never reaches the system allocator.
+ * Larger blocks (e.g., buffers of growing vectors) are rounded up to a power
+ * of two, obtained from the system allocator, and recycled the same way.
+ *
+ * Memory of the slabs and the large blocks is returned to the system only
+ * when the Arena is destroyed, so every block should be released before
+ * the Arena.
+ */
+class Arena {
+ public:
+  /// alignment and granularity of the size classes
+  static constexpr size_t block_alignment = alignof(std::max_align_t);
+
+  /// largest block size served from the slabs
+  static constexpr size_t max_block_size = 256;
+
+  /**
+   * Constructor.
+   */
+  Arena() noexcept;
+
+  /**
+   * Destructor.
+   */
+  ~Arena() noexcept;
+
+  /**
+   * Copying is disabled, as allocated blocks refer to the arena.
+   */
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * Allocate a block.
+   *
+   * @param size size of the block in bytes
+   * @return pointer to the allocated block
+   */
+  [[nodiscard]] void* allocate(size_t size) noexcept;
+
+  /**
+   * Release a block allocated by this arena.
+   *
+   * @param block pointer to the block
+   * @param size size of the block in bytes, same as the allocation
+   */
+  void deallocate(void* block, size_t size) noexcept;
+
+  /**
+   * Get the size of the blocks currently in use.
+   *
+   * @return bytes currently in use
+   */
+  [[nodiscard]] size_t get_used_bytes() const noexcept;
+
+  /**
+   * Get the peak size of the blocks in use.
+   *
+   * @return peak bytes in use
+   */
+  [[nodiscard]] size_t get_peak_used_bytes() const noexcept;
+
+  /**
+   * Get the size of the memory obtained from the system.
+   *
+   * @return bytes of the slabs and the large blocks
+   */
+  [[nodiscard]] size_t get_reserved_bytes() const noexcept;
+
+  /**
+   * Get the number of allocations forwarded to the system allocator.
+   *
+   * @return number of system allocations
+   */
+  [[nodiscard]] size_t get_system_allocations_count() const noexcept;
+
+ private:
+  /// size of a slab in bytes
+  static constexpr size_t slab_size = 64 * 1024;
+
+  /// number of size classes
+  static constexpr size_t size_classes_count = max_block_size / block_alignment;
+
+  /// number of power-of-two classes of the large blocks
+  static constexpr size_t large_size_classes_count = 64;
+
+  /// a freed block, linked into the free list of its size class
+  struct FreeBlock {
+    /// next freed block of the same size class
+    FreeBlock* next;
+  };
+
+  /// free list per size class
+  std::array<FreeBlock*, size_classes_count> free_lists;
+
+  /// free list per power-of-two class of the large blocks
+  std::array<FreeBlock*, large_size_classes_count> large_free_lists;
+
+  /// slabs obtained from the system
+  std::vector<void*> slabs;
+
+  /// next unused byte of the current slab
+  char* slab_cursor;
+
+  /// unused bytes left in the current slab
+  size_t slab_remaining_bytes;
+
+  /// bytes currently in use
+  size_t used_bytes;
+
+  /// peak bytes in use
+  size_t peak_used_bytes;
+
+  /// bytes obtained from the system
+  size_t reserved_bytes;
+
+  /// number of allocations forwarded to the system allocator
+  size_t system_allocations_count;
+
+  /**
+   * Compute the size class of a small block.
+   *
+   * @param size size of the block in bytes
+   * @return size class of the block
+   */
+  [[nodiscard]] static size_t size_class(size_t size) noexcept;
+
+  /**
+   * Compute the power-of-two class of a large block.
+   *
+   * @param size size of the block in bytes
+   * @return log2 of the rounded-up block size
+   */
+  [[nodiscard]] static size_t large_size_class(size_t size) noexcept;
+
+  /**
+   * Obtain a new slab from the system.
+   */
+  void allocate_slab() noexcept;
+};
+
+/**
+ * ArenaAllocator adapts Arena to the standard Allocator requirements,
+ * so standard containers can place their nodes in an Arena.
+ * A default-constructed ArenaAllocator uses the system allocator.
+ *
+ * @tparam T type of the allocated objects
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  /**
+   * Constructor using the system allocator.
+   */
+  ArenaAllocator() noexcept : arena(nullptr) {}
+
+  /**
+   * Constructor.
+   *
+   * @param arena arena to allocate from
+   */
+  explicit ArenaAllocator(Arena* const arena) noexcept : arena(arena) {}
+
+  /**
+   * Rebinding constructor.
+   *
+   * @param other allocator of another type sharing the arena
+   */
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena(other.get_arena()) {}
+
+  /**
+   * Allocate storage for objects.
+   *
+   * @param count number of objects
+   * @return pointer to the allocated storage
+   */
+  [[nodiscard]] T* allocate(const size_t count) noexcept {
+    static_assert(alignof(T) <= Arena::block_alignment);
+
+    const auto size = count * sizeof(T);
+    if (arena == nullptr) {
+      return static_cast<T*>(::operator new(size));
+    }
+    return static_cast<T*>(arena->allocate(size));
+  }
+
+  /**
+   * Release storage for objects.
+   *
+   * @param objects pointer to the storage
+   * @param count number of objects
+   */
+  void deallocate(T* const objects, const size_t count) noexcept {
+    if (arena == nullptr) {
+      ::operator delete(objects);
+      return;
+    }
+    arena->deallocate(objects, count * sizeof(T));
+  }
+
+  /**
+   * Get the arena this allocator allocates from.
+   *
+   * @return pointer to the arena, nullptr for the system allocator
+   */
+  [[nodiscard]] Arena* get_arena() const noexcept {
+    return arena;
+  }
+
+ private:
+  /// arena to allocate from, nullptr for the system allocator
+  Arena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(
+    const ArenaAllocator<T>& lhs,
+    const ArenaAllocator<U>& rhs) noexcept {
+  return lhs.get_arena() == rhs.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(
+    const ArenaAllocator<T>& lhs,
+    const ArenaAllocator<U>& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+} // namespace NetworkAnalytical
@@ -0,0 +1,94 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "common/Arena.hh"
+#include "common/Event.hh"
+#include "common/Type.hh"
+
+namespace NetworkAnalytical {
+
+/**
+ * BinaryHeapQueue keeps every event in an array-based binary min-heap,
+ * ordered by (event time, registration order).
+ *
+ * Both push and pop are O(log(pending events)), regardless of
+ * how many distinct event times are pending.
+ *
+ * Events registered at the same event time are popped in FIFO order.
+ * The heap array is allocated from the given Arena and keeps its capacity,
+ * so steady-state scheduling doesn't allocate.
+ */
+class BinaryHeapQueue {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param arena arena to allocate the registered events from
+   */
+  explicit BinaryHeapQueue(Arena& arena) noexcept;
+
+  /**
+   * Check whether the queue has no registered events.
+   *
+   * @return true if the queue is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Get the earliest registered event time.
+   *
+   * @return earliest registered event time
+   */
+  [[nodiscard]] EventTime get_min_event_time() const noexcept;
+
+  /**
+   * Register an event with a given event time.
+   *
+   * @param event_time time of event
+   * @param event event to register
+   */
+  void push(EventTime event_time, Event event) noexcept;
+
+  /**
+   * Remove and return the earliest registered event.
+   *
+   * @return earliest registered event
+   */
+  [[nodiscard]] Event pop() noexcept;
+
+ private:
+  /// an event with its event time and registration order
+  struct Entry {
+    /// event time
+    EventTime event_time;
+
+    /// registration order, breaking ties of the same event time
+    uint64_t sequence;
+
+    /// registered event
+    Event event;
+  };
+
+  /**
+   * Heap comparator, placing the earliest entry at the top of the heap.
+   *
+   * @param lhs an entry
+   * @param rhs another entry
+   * @return true if lhs should be popped after rhs, false otherwise
+   */
+  [[nodiscard]] static bool later(const Entry& lhs, const Entry& rhs) noexcept;
+
+  /// entries in binary heap layout
+  std::vector<Entry, ArenaAllocator<Entry>> heap;
+
+  /// next registration order
+  uint64_t next_sequence;
+};
+
+} // namespace NetworkAnalytical
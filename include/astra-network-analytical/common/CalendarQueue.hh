@@ -0,0 +1,151 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <vector>
+#include "common/Arena.hh"
+#include "common/Event.hh"
+#include "common/EventList.hh"
+#include "common/Type.hh"
+
+namespace NetworkAnalytical {
+
+/**
+ * CalendarQueue is a bucketed priority queue of EventLists
+ * (R. Brown, "Calendar Queues", CACM 1988).
+ *
+ * Each bucket covers a time interval of bucket_width ns ("a day"),
+ * and the buckets together cover buckets_count * bucket_width ns ("a year").
+ * An EventList with event time t is stored in bucket (t / bucket_width)
+ * modulo buckets_count, sorted by its event time.
+ *
+ * The number of buckets and the bucket width are automatically resized
+ * as the number of registered event times grows or shrinks,
+ * so both push and pop run in O(1) amortized time.
+ *
+ * Events registered at the same event time are popped in FIFO order.
+ * EventLists and events are allocated from the given Arena.
+ */
+class CalendarQueue {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param arena arena to allocate the registered events from
+   */
+  explicit CalendarQueue(Arena& arena) noexcept;
+
+  /**
+   * Check whether the calendar queue has no registered events.
+   *
+   * @return true if the calendar queue is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Get the earliest registered event time.
+   *
+   * @return earliest registered event time
+   */
+  [[nodiscard]] EventTime get_min_event_time() const noexcept;
+
+  /**
+   * Register an event with a given event time.
+   *
+   * @param event_time time of event
+   * @param event event to register
+   */
+  void push(EventTime event_time, Event event) noexcept;
+
+  /**
+   * Remove and return the earliest registered event.
+   * Events with the same event time are returned in FIFO order.
+   *
+   * @return earliest registered event
+   */
+  [[nodiscard]] Event pop() noexcept;
+
+ private:
+  /// minimum number of buckets
+  static constexpr size_t min_buckets_count = 2;
+
+  /// maximum number of event times sampled to compute the bucket width
+  static constexpr size_t bucket_width_samples_count = 25;
+
+  /// a bucket holds EventLists sorted by their event time
+  using Bucket = std::list<EventList, ArenaAllocator<EventList>>;
+
+  /// arena to allocate EventLists and events from
+  Arena* arena;
+
+  /// buckets of the calendar, size is always a power of 2
+  std::vector<Bucket> buckets;
+
+  /// time interval covered by a single bucket
+  EventTime bucket_width;
+
+  /// number of registered EventLists (i.e., distinct event times)
+  size_t event_lists_count;
+
+  /// index of the bucket holding the earliest EventList
+  size_t min_bucket;
+
+  /// every registered event time is at least this value
+  EventTime last_time;
+
+  /**
+   * Compute the bucket index of a given event time.
+   *
+   * @param event_time event time
+   * @return index of the bucket the event time belongs to
+   */
+  [[nodiscard]] size_t bucket_index(EventTime event_time) const noexcept;
+
+  /**
+   * Create empty buckets allocating from the arena.
+   * Events are move-only, so buckets are constructed rather than copied.
+   *
+   * @param buckets_count number of buckets
+   * @return empty buckets
+   */
+  [[nodiscard]] std::vector<Bucket> make_buckets(
+      size_t buckets_count) const noexcept;
+
+  /**
+   * Insert an EventList into its bucket, keeping the bucket sorted.
+   *
+   * @param bucket bucket to insert the EventList
+   * @param source list holding the EventList to move
+   * @param event_list_it iterator of the EventList in the source list
+   */
+  static void splice_sorted(
+      Bucket& bucket,
+      Bucket& source,
+      Bucket::iterator event_list_it) noexcept;
+
+  /**
+   * Find the bucket holding the earliest EventList and update min_bucket.
+   */
+  void locate_min_bucket() noexcept;
+
+  /**
+   * Estimate the bucket width by sampling the earliest event times.
+   *
+   * @return new bucket width
+   */
+  [[nodiscard]] EventTime compute_bucket_width() const noexcept;
+
+  /**
+   * Rebuild the calendar with a new number of buckets and bucket width.
+   *
+   * @param new_buckets_count new number of buckets
+   */
+  void resize(size_t new_buckets_count) noexcept;
+};
+
+} // namespace NetworkAnalytical
@@ -5,18 +5,63 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cassert>
+#include <cstring>
+#include <new>
 #include <tuple>
+#include <utility>
+#include "common/InlineCallback.hh"
 #include "common/Type.hh"
 
 namespace NetworkAnalytical {
 
 /**
- * Event is a wrapper for a callback function and its argument.
+ * EventKey orders simultaneous built-in events by who scheduled them,
+ * rather than by the order they were scheduled in:
+ * (schedule time, origin id, sequence), compared lexicographically.
+ *
+ * The key doesn't depend on how the network is partitioned,
+ * so EventQueue and ParallelSimulation process simultaneous events
+ * in the same order.
+ */
+struct EventKey {
+  /// time the event was scheduled at
+  EventTime schedule_time;
+
+  /// id of the object which scheduled the event (e.g., a link)
+  int origin_id;
+
+  /// number of events the origin scheduled before this one
+  uint64_t sequence;
+};
+
+/**
+ * Check whether an event key orders before another one.
+ *
+ * @param lhs an event key
+ * @param rhs another event key
+ * @return true if lhs orders before rhs, false otherwise
+ */
+[[nodiscard]] inline bool operator<(
+    const EventKey& lhs,
+    const EventKey& rhs) noexcept {
+  // compare (schedule time, origin id, sequence)
+  return std::tie(lhs.schedule_time, lhs.origin_id, lhs.sequence) <
+      std::tie(rhs.schedule_time, rhs.origin_id, rhs.sequence);
+}
+
+/**
+ * Event is a typed, inline record of a scheduled event. It holds either
+ *   - a callback function pointer and its argument (EventKind::Callback),
+ *   - a callable with inline captures (EventKind::Closure), or
+ *   - a built-in event of the network backend and its target object
+ *     (e.g., EventKind::ChunkArrived on a Chunk),
+ *     optionally ordered by an EventKey.
  */
 class Event {
  public:
   /**
-   * Constructor.
+   * Constructor of a callback event.
    *
    * @param callback function pointer
    * @param callback_arg argument of the callback function
@@ -24,12 +69,132 @@ class Event {
   Event(Callback callback, CallbackArg callback_arg) noexcept;
 
   /**
-   * Invoke the callback function.
+   * Constructor of a closure event.
+   *
+   * @param closure callable to invoke
+   */
+  explicit Event(InlineCallback closure) noexcept;
+
+  /**
+   * Constructor of a built-in event.
+   *
+   * @param kind kind of the built-in event
+   * @param target object the built-in event acts on
+   */
+  Event(EventKind kind, void* target) noexcept;
+
+  /**
+   * Constructor of a built-in event ordered by a key.
+   *
+   * @param kind kind of the built-in event
+   * @param target object the built-in event acts on
+   * @param key order of the event among the simultaneous keyed events
+   */
+  Event(EventKind kind, void* target, const EventKey& key) noexcept;
+
+  /**
+   * Move constructor.
+   *
+   * @param other event to move from
+   */
+  Event(Event&& other) noexcept
+      : kind(other.kind), schedule_time(other.schedule_time) {
+    // only closures need their payload moved, others are plain words
+    // copied at once (Builtin is the larger of Handler and Builtin)
+    if (kind == EventKind::Closure) {
+      new (&closure) InlineCallback(std::move(other.closure));
+    } else {
+      std::memcpy(
+          static_cast<void*>(&builtin), &other.builtin, sizeof(Builtin));
+    }
+  }
+
+  /**
+   * Move assignment.
+   *
+   * @param other event to move from
+   * @return this event
+   */
+  Event& operator=(Event&& other) noexcept {
+    if (this != &other) {
+      this->~Event();
+      new (this) Event(std::move(other));
+    }
+    return *this;
+  }
+
+  Event(const Event&) = delete;
+  Event& operator=(const Event&) = delete;
+
+  /**
+   * Destructor, destroying the closure of a closure event.
+   */
+  ~Event() noexcept {
+    // only closures own their payload
+    if (kind == EventKind::Closure) {
+      closure.~InlineCallback();
+    }
+  }
+
+  /**
+   * Get the kind of the event.
+   *
+   * @return kind of the event
+   */
+  [[nodiscard]] EventKind get_kind() const noexcept;
+
+  /**
+   * Check whether the event is a built-in event ordered by a key.
+   *
+   * @return true if the event has a key, false otherwise
+   */
+  [[nodiscard]] bool has_key() const noexcept {
+    // only built-in events carry keys
+    if (kind == EventKind::Callback || kind == EventKind::Closure) {
+      return false;
+    }
+    return builtin.key.origin_id >= 0;
+  }
+
+  /**
+   * Get the key of a keyed built-in event.
+   *
+   * @return key of the event
+   */
+  [[nodiscard]] const EventKey& get_key() const noexcept {
+    assert(has_key());
+    return builtin.key;
+  }
+
+  /**
+   * Get the time the event was scheduled at.
+   *
+   * @return schedule time of the event
    */
-  void invoke_event() noexcept;
+  [[nodiscard]] EventTime get_schedule_time() const noexcept {
+    return schedule_time;
+  }
 
   /**
-   * Get the callback function and the argument.
+   * Set the time the event was scheduled at,
+   * which orders it against the keyed events of the same time.
+   *
+   * @param schedule_time schedule time of the event
+   */
+  void set_schedule_time(EventTime schedule_time) noexcept {
+    this->schedule_time = schedule_time;
+  }
+
+  /**
+   * Invoke the event.
+   * Built-in events are handed to the given dispatcher.
+   *
+   * @param dispatcher dispatcher of built-in events
+   */
+  void invoke_event(EventDispatcher dispatcher = nullptr) noexcept;
+
+  /**
+   * Get the callback function and the argument of a callback event.
    *
    * @return callback function and its argument
    */
@@ -37,11 +202,45 @@ class Event {
       const noexcept;
 
  private:
-  /// pointer to the callback function
-  Callback callback;
+  /// callback function pointer and its argument
+  struct Handler {
+    /// pointer to the callback function
+    Callback callback;
+
+    /// argument of the callback function
+    CallbackArg callback_arg;
+  };
+
+  /// target object and key of a built-in event
+  struct Builtin {
+    /// object the event acts on
+    void* target;
+
+    /// order of the event, origin id -1 if unordered
+    EventKey key;
+  };
+
+  static_assert(
+      sizeof(Handler) <= sizeof(Builtin),
+      "moving an event copies plain payloads as a Builtin");
+
+  /// kind of the event
+  EventKind kind;
+
+  /// time the event was scheduled at
+  EventTime schedule_time;
+
+  /// payload of the event, selected by kind
+  union {
+    /// EventKind::Callback
+    Handler handler;
+
+    /// EventKind::Closure
+    InlineCallback closure;
 
-  /// argument of the callback function
-  CallbackArg callback_arg;
+    /// built-in events
+    Builtin builtin;
+  };
 };
 
 } // namespace NetworkAnalytical
@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include <list>
+#include "common/Arena.hh"
 #include "common/Event.hh"
 #include "common/Type.hh"
 
@@ -20,8 +21,9 @@ class EventList {
    * Constructor.
    *
    * @param event_time event time of the event list
+   * @param arena arena to allocate the registered events from
    */
-  explicit EventList(EventTime event_time) noexcept;
+  EventList(EventTime event_time, Arena& arena) noexcept;
 
   /**
    * Get the registered event time.
@@ -33,22 +35,37 @@ class EventList {
   /**
    * Register an event into the event list.
    *
-   * @param callback callback function pointer
-   * @param callback_arg argument of the callback function
+   * @param event event to register
    */
-  void add_event(Callback callback, CallbackArg callback_arg) noexcept;
+  void add_event(Event event) noexcept;
+
+  /**
+   * Check whether the event list has no registered events.
+   *
+   * @return true if the event list is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Remove and return the first registered event.
+   *
+   * @return first registered event
+   */
+  [[nodiscard]] Event pop_event() noexcept;
 
   /**
    * Invoke all events in the event list.
+   *
+   * @param dispatcher dispatcher of built-in events
    */
-  void invoke_events() noexcept;
+  void invoke_events(EventDispatcher dispatcher = nullptr) noexcept;
 
  private:
   /// event time of the event list
   EventTime event_time;
 
   /// list of registered events
-  std::list<Event> events;
+  std::list<Event, ArenaAllocator<Event>> events;
 };
 
 } // namespace NetworkAnalytical
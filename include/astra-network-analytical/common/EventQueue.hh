@@ -5,20 +5,69 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstddef>
+#include <vector>
+#include "common/Arena.hh"
+#include "common/BinaryHeapQueue.hh"
+#include "common/CalendarQueue.hh"
+#include "common/Event.hh"
+#include "common/InlineCallback.hh"
+#include "common/PairingHeapQueue.hh"
+#include "common/RadixHeapQueue.hh"
+#include "common/SortedListQueue.hh"
 #include "common/Type.hh"
-#include "common/EventList.hh"
+
+/// Scheduling policy of EventQueue, selected at compile time
+/// (set through the EVENT_QUEUE_POLICY CMake option)
+#ifndef NETWORK_ANALYTICAL_EVENT_QUEUE_POLICY
+#define NETWORK_ANALYTICAL_EVENT_QUEUE_POLICY CalendarQueue
+#endif
 
 namespace NetworkAnalytical {
 
 /**
- * EventQueue manages scheduled EventLists.
+ * GenericEventQueue manages scheduled events.
+ *
+ * Scheduled events are stored in a Scheduler policy class,
+ * which should provide:
+ *   - explicit Scheduler(Arena& arena), allocating from the given arena
+ *   - bool empty() const
+ *   - EventTime get_min_event_time() const
+ *   - void push(EventTime event_time, Event event)
+ *   - Event pop(), returning events of the same time in FIFO order
+ *
+ * Supported policies are:
+ *   - CalendarQueue: O(1) amortized, default
+ *   - RadixHeapQueue: exploits monotone integer event times
+ *   - BinaryHeapQueue: many distinct event times
+ *   - PairingHeapQueue: many distinct event times, cheap push
+ *   - SortedListQueue: a few distinct event times with many events
+ *
+ * Events are typed, inline records (see Event): callbacks with their
+ * arguments, closures with inline captures, and built-in events of the
+ * network backend, which are handed to the registered EventDispatcher.
+ *
+ * Events of the same time are invoked in FIFO order.
+ * A built-in event scheduled with an EventKey is ordered as if it had been
+ * scheduled at the schedule time of its key (e.g., the departure of a chunk
+ * whose arrival is scheduled ahead): after the events scheduled up to then,
+ * and among the keyed events of the same schedule time, by their keys.
+ * With set_keyed_order(true), every keyed event is ordered by its key,
+ * which is the order ParallelSimulation processes them in.
+ *
+ * Every allocation of the scheduler is served by an Arena owned by the
+ * event queue, so a steady-state simulation doesn't call the system allocator
+ * per scheduled event.
+ *
+ * @tparam Scheduler policy class storing the scheduled events
  */
-class EventQueue {
+template <typename Scheduler>
+class GenericEventQueue {
  public:
   /**
    * Constructor.
    */
-  EventQueue() noexcept;
+  GenericEventQueue() noexcept;
 
   /**
    * Get current event time of the event queue.
@@ -54,12 +103,157 @@ class EventQueue {
       Callback callback,
       CallbackArg callback_arg) noexcept;
 
+  /**
+   * Schedule a closure with a given event time.
+   * The closure captures a few words inline, without allocation.
+   *
+   * @param event_time time of event
+   * @param closure callable to invoke
+   */
+  void schedule_event(EventTime event_time, InlineCallback closure) noexcept;
+
+  /**
+   * Schedule a built-in event with a given event time.
+   *
+   * @param event_time time of event
+   * @param kind kind of the built-in event
+   * @param target object the built-in event acts on
+   */
+  void schedule_event(
+      EventTime event_time,
+      EventKind kind,
+      void* target) noexcept;
+
+  /**
+   * Schedule a built-in event ordered by a key among the simultaneous ones.
+   *
+   * @param event_time time of event
+   * @param kind kind of the built-in event
+   * @param target object the built-in event acts on
+   * @param key order of the event among the simultaneous keyed events
+   */
+  void schedule_event(
+      EventTime event_time,
+      EventKind kind,
+      void* target,
+      const EventKey& key) noexcept;
+
+  /**
+   * Schedule built-in events of the same kind,
+   * e.g., the arrivals of a batch of chunks sent at the same time.
+   * A convenience wrapper pushing the events one by one:
+   * the schedulers have no bulk insert, as a push into the default
+   * CalendarQueue already takes O(1) amortized time.
+   *
+   * @param kind kind of the built-in events
+   * @param event_times time of each event
+   * @param targets object each event acts on
+   * @param events_count number of events
+   */
+  void schedule_events(
+      EventKind kind,
+      const EventTime* event_times,
+      void* const* targets,
+      size_t events_count) noexcept;
+
+  /**
+   * Set whether every keyed event is ordered by its key.
+   * Otherwise (by default), keyed events scheduled at the schedule time
+   * of their keys are invoked in FIFO order like the others,
+   * e.g., to compare against ParallelSimulation, which orders them by keys.
+   *
+   * @param keyed_order true to order every keyed event by its key
+   */
+  void set_keyed_order(bool keyed_order) noexcept;
+
+  /**
+   * Register the dispatcher of built-in events,
+   * usually done by the network backend.
+   *
+   * @param dispatcher dispatcher of built-in events
+   */
+  void set_event_dispatcher(EventDispatcher dispatcher) noexcept;
+
+  /**
+   * Get the arena holding the scheduled events,
+   * e.g., to inspect its peak size.
+   *
+   * @return arena of the event queue
+   */
+  [[nodiscard]] const Arena& get_arena() const noexcept;
+
+  /**
+   * Get the number of events scheduled so far.
+   *
+   * @return number of scheduled events
+   */
+  [[nodiscard]] uint64_t get_scheduled_events_count() const noexcept;
+
  private:
   /// current time of the event queue
   EventTime current_time;
 
-  /// list of EventLists
-  std::list<EventList> event_queue;
+  /// arena to allocate the scheduled events from
+  Arena arena;
+
+  /// scheduled events
+  Scheduler event_queue;
+
+  /// keyed events of the current time held back,
+  /// sorted from the largest key unless keyed_events_sorted is false
+  std::vector<Event, ArenaAllocator<Event>> keyed_events;
+
+  /// whether keyed_events is sorted
+  bool keyed_events_sorted;
+
+  /// whether every keyed event is ordered by its key
+  bool keyed_order;
+
+  /// dispatcher of built-in events
+  EventDispatcher event_dispatcher;
+
+  /// number of events scheduled so far
+  uint64_t scheduled_events_count;
+
+  /**
+   * Register an event to the scheduler, stamped with the current time.
+   *
+   * @param event_time time of event
+   * @param event event to schedule
+   */
+  void push_event(EventTime event_time, Event event) noexcept;
+
+  /**
+   * Invoke the held back keyed events whose keys were scheduled
+   * before the given time, in the order of their keys.
+   *
+   * @param schedule_time time to invoke the keyed events scheduled before
+   */
+  void invoke_keyed_events(EventTime schedule_time) noexcept;
+
+  /**
+   * Comparator sorting the keyed events from the largest key,
+   * so the one with the smallest key is at the back.
+   *
+   * @param lhs a keyed event
+   * @param rhs another keyed event
+   * @return true if lhs should be invoked after rhs, false otherwise
+   */
+  [[nodiscard]] static bool later(
+      const Event& lhs,
+      const Event& rhs) noexcept {
+    return rhs.get_key() < lhs.get_key();
+  }
 };
 
+/// EventQueue uses the scheduling policy selected at compile time
+using EventQueue = GenericEventQueue<NETWORK_ANALYTICAL_EVENT_QUEUE_POLICY>;
+
+/// Supported policies are explicitly instantiated in EventQueue.cc
+extern template class GenericEventQueue<CalendarQueue>;
+extern template class GenericEventQueue<RadixHeapQueue>;
+extern template class GenericEventQueue<BinaryHeapQueue>;
+extern template class GenericEventQueue<PairingHeapQueue>;
+extern template class GenericEventQueue<SortedListQueue>;
+
 } // namespace NetworkAnalytical
@@ -0,0 +1,176 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "common/Type.hh"
+
+namespace NetworkAnalytical {
+
+/**
+ * InlineCallback is a move-only "void()" callable whose captures are stored
+ * inline, so a callback capturing a few words never allocates.
+ *
+ * Captured objects should fit into storage_size bytes.
+ * Trivially copyable captures (e.g., pointers, ids, and sizes) are moved
+ * with a plain copy; other captures (e.g., a std::unique_ptr) are moved
+ * and destroyed through a relocator stored next to the invoker.
+ */
+class InlineCallback {
+ public:
+  /// size of the inline storage for the captures in bytes
+  static constexpr size_t storage_size = 3 * sizeof(void*);
+
+  /**
+   * Constructor of an empty callback.
+   */
+  InlineCallback() noexcept;
+
+  /**
+   * Constructor wrapping a callback function pointer and its argument.
+   *
+   * @param callback callback function pointer
+   * @param callback_arg argument of the callback function
+   */
+  InlineCallback(Callback callback, CallbackArg callback_arg) noexcept;
+
+  /**
+   * Constructor storing a callable, e.g., a lambda, inline.
+   *
+   * @tparam Function type of the callable
+   * @param function callable to invoke
+   */
+  template <
+      typename Function,
+      typename = std::enable_if_t<
+          !std::is_same_v<std::decay_t<Function>, InlineCallback>>>
+  InlineCallback(Function function) noexcept {
+    static_assert(
+        sizeof(Function) <= storage_size,
+        "InlineCallback: captures exceed the inline storage");
+    static_assert(
+        alignof(Function) <= alignof(void*),
+        "InlineCallback: captures are over-aligned");
+    static_assert(
+        std::is_nothrow_move_constructible_v<Function>,
+        "InlineCallback: captures should be nothrow move constructible");
+
+    // place the callable into the inline storage
+    new (storage) Function(std::move(function));
+    invoker = [](void* const storage) {
+      (*std::launder(static_cast<Function*>(storage)))();
+    };
+
+    // trivially copyable captures are relocated by copying the storage
+    if constexpr (!std::is_trivially_copyable_v<Function>) {
+      relocator = [](void* const destination, void* const source) {
+        auto* const function = std::launder(static_cast<Function*>(source));
+        if (destination != nullptr) {
+          new (destination) Function(std::move(*function));
+        }
+        function->~Function();
+      };
+    } else {
+      relocator = nullptr;
+    }
+  }
+
+  /**
+   * Move constructor.
+   * The moved-from callback becomes empty.
+   *
+   * @param other callback to move from
+   */
+  InlineCallback(InlineCallback&& other) noexcept
+      : invoker(nullptr), relocator(nullptr) {
+    take(other);
+  }
+
+  /**
+   * Move assignment.
+   * The moved-from callback becomes empty.
+   *
+   * @param other callback to move from
+   * @return this callback
+   */
+  InlineCallback& operator=(InlineCallback&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  InlineCallback(const InlineCallback&) = delete;
+  InlineCallback& operator=(const InlineCallback&) = delete;
+
+  /**
+   * Destructor, destroying the stored callable.
+   */
+  ~InlineCallback() noexcept {
+    reset();
+  }
+
+  /**
+   * Invoke the stored callable.
+   */
+  void operator()() noexcept;
+
+  /**
+   * Check whether a callable is stored.
+   *
+   * @return true if a callable is stored, false otherwise
+   */
+  [[nodiscard]] explicit operator bool() const noexcept;
+
+ private:
+  /**
+   * Take over the callable of another callback, leaving it empty.
+   * This callback should hold no callable.
+   *
+   * @param other callback to take the callable from
+   */
+  void take(InlineCallback& other) noexcept {
+    // move the callable, then mark the other callback empty
+    invoker = other.invoker;
+    relocator = other.relocator;
+    if (relocator != nullptr) {
+      (*relocator)(storage, other.storage);
+    } else {
+      std::memcpy(storage, other.storage, storage_size);
+    }
+    other.invoker = nullptr;
+    other.relocator = nullptr;
+  }
+
+  /**
+   * Destroy the stored callable, leaving this callback empty.
+   */
+  void reset() noexcept {
+    // destroy the callable if it's not trivially copyable
+    if (relocator != nullptr) {
+      (*relocator)(nullptr, storage);
+    }
+    invoker = nullptr;
+    relocator = nullptr;
+  }
+
+  /// function invoking the callable in the storage
+  void (*invoker)(void*);
+
+  /// function moving the callable into another storage (or nowhere if null)
+  /// and destroying it, nullptr if the callable is trivially copyable
+  void (*relocator)(void*, void*);
+
+  /// inline storage of the callable
+  alignas(void*) unsigned char storage[storage_size];
+};
+
+} // namespace NetworkAnalytical
@@ -19,4 +19,22 @@ namespace NetworkAnalytical {
  */
 Bandwidth bw_GBps_to_Bpns(Bandwidth bw_GBps) noexcept;
 
+/**
+ * Convert bandwidth from B/ns to GB/s.
+ * Inverse of bw_GBps_to_Bpns.
+ *
+ * @param bw_Bpns bandwidth in B/ns
+ * @return translated bandwidth in GB/s
+ */
+Bandwidth bw_Bpns_to_GBps(Bandwidth bw_Bpns) noexcept;
+
+/**
+ * Split data into equal chunks, rounding up to at least 1 byte.
+ *
+ * @param size size of the data
+ * @param chunks_count number of chunks
+ * @return size of each chunk
+ */
+ChunkSize split_size(ChunkSize size, uint64_t chunks_count) noexcept;
+
 } // namespace NetworkAnalytical
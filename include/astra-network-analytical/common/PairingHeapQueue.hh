@@ -0,0 +1,135 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "common/Arena.hh"
+#include "common/Event.hh"
+#include "common/Type.hh"
+
+namespace NetworkAnalytical {
+
+/**
+ * PairingHeapQueue keeps every event in a pairing heap
+ * (Fredman et al., Algorithmica 1986), ordered by
+ * (event time, registration order).
+ *
+ * Push is O(1) and pop is O(log(pending events)) amortized.
+ * Pushing is cheaper than BinaryHeapQueue,
+ * which suits workloads that schedule many events far in the future.
+ *
+ * Events registered at the same event time are popped in FIFO order.
+ * Heap nodes are allocated from the given Arena.
+ */
+class PairingHeapQueue {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param arena arena to allocate the registered events from
+   */
+  explicit PairingHeapQueue(Arena& arena) noexcept;
+
+  /**
+   * Destructor.
+   */
+  ~PairingHeapQueue() noexcept;
+
+  /**
+   * Copying is disabled, as the queue owns its heap nodes.
+   */
+  PairingHeapQueue(const PairingHeapQueue&) = delete;
+  PairingHeapQueue& operator=(const PairingHeapQueue&) = delete;
+
+  /**
+   * Check whether the queue has no registered events.
+   *
+   * @return true if the queue is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Get the earliest registered event time.
+   *
+   * @return earliest registered event time
+   */
+  [[nodiscard]] EventTime get_min_event_time() const noexcept;
+
+  /**
+   * Register an event with a given event time.
+   *
+   * @param event_time time of event
+   * @param event event to register
+   */
+  void push(EventTime event_time, Event event) noexcept;
+
+  /**
+   * Remove and return the earliest registered event.
+   *
+   * @return earliest registered event
+   */
+  [[nodiscard]] Event pop() noexcept;
+
+ private:
+  /// a heap node holding an event
+  struct Node {
+    /// event time
+    EventTime event_time;
+
+    /// registration order, breaking ties of the same event time
+    uint64_t sequence;
+
+    /// registered event
+    Event event;
+
+    /// leftmost child
+    Node* child;
+
+    /// next sibling
+    Node* sibling;
+  };
+
+  /// arena to allocate nodes from
+  Arena* arena;
+
+  /// root of the heap, holding the earliest event
+  Node* root;
+
+  /// next registration order
+  uint64_t next_sequence;
+
+  /// scratch space to pair the children of a popped root
+  std::vector<Node*, ArenaAllocator<Node*>> pairing_buffer;
+
+  /**
+   * Check whether a node should be popped before another node.
+   *
+   * @param lhs a node
+   * @param rhs another node
+   * @return true if lhs precedes rhs, false otherwise
+   */
+  [[nodiscard]] static bool precedes(const Node* lhs, const Node* rhs) noexcept;
+
+  /**
+   * Meld two heaps.
+   *
+   * @param lhs root of a heap
+   * @param rhs root of another heap
+   * @return root of the melded heap
+   */
+  [[nodiscard]] static Node* meld(Node* lhs, Node* rhs) noexcept;
+
+  /**
+   * Meld the children of a popped root in two passes.
+   *
+   * @param first_child leftmost child of the popped root
+   * @return root of the melded heap
+   */
+  [[nodiscard]] Node* merge_pairs(Node* first_child) noexcept;
+};
+
+} // namespace NetworkAnalytical
@@ -0,0 +1,121 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "common/Arena.hh"
+#include "common/Event.hh"
+#include "common/Type.hh"
+
+namespace NetworkAnalytical {
+
+/**
+ * RadixHeapQueue is a radix heap (Ahuja et al., JACM 1990),
+ * which exploits that EventTime is an unsigned integer
+ * and that scheduled event times never precede the last popped one.
+ *
+ * An event with event time t is stored in bucket
+ * (bit width of (t XOR last popped time)), so that bucket 0 holds the events
+ * at the last popped time. When bucket 0 is drained, the first non-empty
+ * bucket is redistributed into lower buckets. Every event moves at most
+ * 64 times, so push is O(1) and pop is O(log(EventTime range)) amortized.
+ *
+ * Events registered at the same event time are popped in FIFO order.
+ * Bucket arrays are allocated from the given Arena and keep their capacity,
+ * so steady-state scheduling doesn't allocate.
+ */
+class RadixHeapQueue {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param arena arena to allocate the registered events from
+   */
+  explicit RadixHeapQueue(Arena& arena) noexcept;
+
+  /**
+   * Check whether the queue has no registered events.
+   *
+   * @return true if the queue is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Get the earliest registered event time.
+   *
+   * @return earliest registered event time
+   */
+  [[nodiscard]] EventTime get_min_event_time() const noexcept;
+
+  /**
+   * Register an event with a given event time.
+   * The event time should not precede the last popped event time.
+   *
+   * @param event_time time of event
+   * @param event event to register
+   */
+  void push(EventTime event_time, Event event) noexcept;
+
+  /**
+   * Remove and return the earliest registered event.
+   *
+   * @return earliest registered event
+   */
+  [[nodiscard]] Event pop() noexcept;
+
+ private:
+  /// number of buckets: one per bit of EventTime, plus bucket 0
+  static constexpr size_t buckets_count = 65;
+
+  /// an event with its event time
+  struct Entry {
+    /// event time
+    EventTime event_time;
+
+    /// registered event
+    Event event;
+  };
+
+  /// a bucket holds entries in registration order
+  using Bucket = std::vector<Entry, ArenaAllocator<Entry>>;
+
+  /// buckets of entries
+  std::array<Bucket, buckets_count> buckets;
+
+  /// index of the first unpopped entry of bucket 0
+  size_t front_index;
+
+  /// number of registered entries
+  size_t entries_count;
+
+  /// last popped event time
+  EventTime last_time;
+
+  /**
+   * Compute the bucket index of a given event time.
+   *
+   * @param event_time event time
+   * @return index of the bucket the event time belongs to
+   */
+  [[nodiscard]] size_t bucket_index(EventTime event_time) const noexcept;
+
+  /**
+   * Get the first non-empty bucket other than bucket 0.
+   *
+   * @return index of the first non-empty bucket
+   */
+  [[nodiscard]] size_t first_non_empty_bucket() const noexcept;
+
+  /**
+   * Redistribute the first non-empty bucket into lower buckets,
+   * so that bucket 0 holds the earliest events.
+   */
+  void refill() noexcept;
+};
+
+} // namespace NetworkAnalytical
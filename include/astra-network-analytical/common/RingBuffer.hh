@@ -0,0 +1,367 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * RingBuffer is a double-ended queue stored in one circular array.
+ *
+ * The array grows by doubling when full and never shrinks,
+ * so once it reached the peak size of a workload,
+ * pushing and popping never reach the system allocator
+ * (unlike std::deque, which allocates and frees its blocks as it moves).
+ * Elements are accessed by random-access iterators in queue order.
+ *
+ * @tparam T type of the elements, default-constructible and copyable
+ */
+template <typename T>
+class RingBuffer {
+ public:
+  /**
+   * Random-access iterator over the elements, in queue order.
+   *
+   * @tparam Buffer ring buffer type, const for const iterators
+   * @tparam Value element type, const for const iterators
+   */
+  template <typename Buffer, typename Value>
+  class BasicIterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    /**
+     * Constructor of a singular iterator.
+     */
+    BasicIterator() noexcept : buffer(nullptr), index(0) {}
+
+    /**
+     * Constructor.
+     *
+     * @param buffer ring buffer to iterate
+     * @param index position of the element in queue order
+     */
+    BasicIterator(Buffer* const buffer, const difference_type index) noexcept
+        : buffer(buffer), index(index) {}
+
+    reference operator*() const noexcept {
+      return (*buffer)[static_cast<size_t>(index)];
+    }
+
+    pointer operator->() const noexcept {
+      return &**this;
+    }
+
+    reference operator[](const difference_type offset) const noexcept {
+      return *(*this + offset);
+    }
+
+    BasicIterator& operator++() noexcept {
+      index++;
+      return *this;
+    }
+
+    BasicIterator operator++(int) noexcept {
+      const auto it = *this;
+      index++;
+      return it;
+    }
+
+    BasicIterator& operator--() noexcept {
+      index--;
+      return *this;
+    }
+
+    BasicIterator operator--(int) noexcept {
+      const auto it = *this;
+      index--;
+      return it;
+    }
+
+    BasicIterator& operator+=(const difference_type offset) noexcept {
+      index += offset;
+      return *this;
+    }
+
+    BasicIterator& operator-=(const difference_type offset) noexcept {
+      index -= offset;
+      return *this;
+    }
+
+    BasicIterator operator+(const difference_type offset) const noexcept {
+      return BasicIterator(buffer, index + offset);
+    }
+
+    BasicIterator operator-(const difference_type offset) const noexcept {
+      return BasicIterator(buffer, index - offset);
+    }
+
+    difference_type operator-(const BasicIterator& other) const noexcept {
+      return index - other.index;
+    }
+
+    bool operator==(const BasicIterator& other) const noexcept {
+      return index == other.index;
+    }
+
+    bool operator!=(const BasicIterator& other) const noexcept {
+      return index != other.index;
+    }
+
+    bool operator<(const BasicIterator& other) const noexcept {
+      return index < other.index;
+    }
+
+    bool operator>(const BasicIterator& other) const noexcept {
+      return index > other.index;
+    }
+
+    bool operator<=(const BasicIterator& other) const noexcept {
+      return index <= other.index;
+    }
+
+    bool operator>=(const BasicIterator& other) const noexcept {
+      return index >= other.index;
+    }
+
+   private:
+    /// ring buffer being iterated
+    Buffer* buffer;
+
+    /// position of the element in queue order
+    difference_type index;
+  };
+
+  using iterator = BasicIterator<RingBuffer, T>;
+  using const_iterator = BasicIterator<const RingBuffer, const T>;
+
+  /**
+   * Constructor of an empty ring buffer, allocating nothing.
+   */
+  RingBuffer() noexcept : head(0), count(0) {}
+
+  /**
+   * Check whether the ring buffer is empty.
+   *
+   * @return true if the ring buffer is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept {
+    return count == 0;
+  }
+
+  /**
+   * Get the number of elements.
+   *
+   * @return number of elements
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    return count;
+  }
+
+  /**
+   * Get the number of elements the ring buffer holds without growing.
+   *
+   * @return capacity of the ring buffer
+   */
+  [[nodiscard]] size_t capacity() const noexcept {
+    return slots.size();
+  }
+
+  /**
+   * Access an element by its position in queue order.
+   *
+   * @param position position of the element
+   * @return the element
+   */
+  [[nodiscard]] T& operator[](const size_t position) noexcept {
+    assert(position < count);
+    return slots[(head + position) & (slots.size() - 1)];
+  }
+
+  /**
+   * Access an element by its position in queue order.
+   *
+   * @param position position of the element
+   * @return the element
+   */
+  [[nodiscard]] const T& operator[](const size_t position) const noexcept {
+    assert(position < count);
+    return slots[(head + position) & (slots.size() - 1)];
+  }
+
+  /**
+   * Access the first element.
+   *
+   * @return the first element
+   */
+  [[nodiscard]] T& front() noexcept {
+    return (*this)[0];
+  }
+
+  /**
+   * Access the first element.
+   *
+   * @return the first element
+   */
+  [[nodiscard]] const T& front() const noexcept {
+    return (*this)[0];
+  }
+
+  /**
+   * Access the last element.
+   *
+   * @return the last element
+   */
+  [[nodiscard]] T& back() noexcept {
+    return (*this)[count - 1];
+  }
+
+  /**
+   * Access the last element.
+   *
+   * @return the last element
+   */
+  [[nodiscard]] const T& back() const noexcept {
+    return (*this)[count - 1];
+  }
+
+  /**
+   * Append an element, growing the ring buffer if full.
+   *
+   * @param value element to append
+   */
+  void push_back(const T& value) noexcept {
+    if (count == slots.size()) {
+      grow();
+    }
+    count++;
+    back() = value;
+  }
+
+  /**
+   * Remove the first element.
+   */
+  void pop_front() noexcept {
+    assert(!empty());
+    head = (head + 1) & (slots.size() - 1);
+    count--;
+  }
+
+  /**
+   * Insert an element before the given position,
+   * shifting the elements on the shorter side of it.
+   *
+   * @param position position to insert the element at
+   * @param value element to insert
+   * @return iterator to the inserted element
+   */
+  iterator insert(const iterator position, const T& value) noexcept {
+    const auto index = static_cast<size_t>(position - begin());
+    assert(index <= count);
+    if (count == slots.size()) {
+      grow();
+    }
+    count++;
+
+    if (index < count / 2) {
+      // open a slot in front, then move the earlier elements into it
+      head = (head - 1) & (slots.size() - 1);
+      for (size_t i = 0; i < index; i++) {
+        (*this)[i] = std::move((*this)[i + 1]);
+      }
+    } else {
+      // move the later elements toward the back
+      for (auto i = count - 1; i > index; i--) {
+        (*this)[i] = std::move((*this)[i - 1]);
+      }
+    }
+
+    (*this)[index] = value;
+    return begin() + static_cast<std::ptrdiff_t>(index);
+  }
+
+  /**
+   * Remove the element at the given position,
+   * shifting the elements on the shorter side of it.
+   *
+   * @param position position of the element to remove
+   * @return iterator to the element following the removed one
+   */
+  iterator erase(const iterator position) noexcept {
+    const auto index = static_cast<size_t>(position - begin());
+    assert(index < count);
+
+    if (index < count / 2) {
+      // move the earlier elements toward the back, then drop the front slot
+      for (auto i = index; i > 0; i--) {
+        (*this)[i] = std::move((*this)[i - 1]);
+      }
+      head = (head + 1) & (slots.size() - 1);
+    } else {
+      // move the later elements toward the front
+      for (auto i = index; i + 1 < count; i++) {
+        (*this)[i] = std::move((*this)[i + 1]);
+      }
+    }
+    count--;
+
+    return begin() + static_cast<std::ptrdiff_t>(index);
+  }
+
+  [[nodiscard]] iterator begin() noexcept {
+    return iterator(this, 0);
+  }
+
+  [[nodiscard]] iterator end() noexcept {
+    return iterator(this, static_cast<std::ptrdiff_t>(count));
+  }
+
+  [[nodiscard]] const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  [[nodiscard]] const_iterator end() const noexcept {
+    return const_iterator(this, static_cast<std::ptrdiff_t>(count));
+  }
+
+ private:
+  /// smallest capacity allocated on the first push
+  static constexpr size_t min_capacity = 8;
+
+  /// circular array of the elements, size is always 0 or a power of 2
+  std::vector<T> slots;
+
+  /// index of the first element in slots
+  size_t head;
+
+  /// number of elements
+  size_t count;
+
+  /**
+   * Double the capacity, moving the elements to the front of a new array.
+   */
+  void grow() noexcept {
+    const auto new_capacity =
+        slots.empty() ? min_capacity : 2 * slots.size();
+    auto new_slots = std::vector<T>(new_capacity);
+    for (size_t i = 0; i < count; i++) {
+      new_slots[i] = std::move((*this)[i]);
+    }
+    slots = std::move(new_slots);
+    head = 0;
+  }
+};
+
+} // namespace NetworkAnalytical
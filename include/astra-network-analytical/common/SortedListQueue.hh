@@ -0,0 +1,72 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <list>
+#include "common/Arena.hh"
+#include "common/Event.hh"
+#include "common/EventList.hh"
+#include "common/Type.hh"
+
+namespace NetworkAnalytical {
+
+/**
+ * SortedListQueue keeps EventLists in a list sorted by event time.
+ *
+ * Pushing a new event linearly scans the list (O(distinct event times)),
+ * while popping is O(1). This is efficient when only a few distinct
+ * event times are pending, e.g., collectives on Switch topologies.
+ *
+ * Events registered at the same event time are popped in FIFO order.
+ * EventLists and events are allocated from the given Arena.
+ */
+class SortedListQueue {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param arena arena to allocate the registered events from
+   */
+  explicit SortedListQueue(Arena& arena) noexcept;
+
+  /**
+   * Check whether the queue has no registered events.
+   *
+   * @return true if the queue is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Get the earliest registered event time.
+   *
+   * @return earliest registered event time
+   */
+  [[nodiscard]] EventTime get_min_event_time() const noexcept;
+
+  /**
+   * Register an event with a given event time.
+   *
+   * @param event_time time of event
+   * @param event event to register
+   */
+  void push(EventTime event_time, Event event) noexcept;
+
+  /**
+   * Remove and return the earliest registered event.
+   *
+   * @return earliest registered event
+   */
+  [[nodiscard]] Event pop() noexcept;
+
+ private:
+  /// arena to allocate EventLists and events from
+  Arena* arena;
+
+  /// list of EventLists, sorted by event time
+  std::list<EventList, ArenaAllocator<EventList>> event_lists;
+};
+
+} // namespace NetworkAnalytical
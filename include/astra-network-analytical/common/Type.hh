@@ -30,7 +30,38 @@ using Latency = double;
 /// Event time in ns
 using EventTime = uint64_t;
 
+/// Kinds of scheduled events
+///   - Callback: raw callback function pointer and its argument
+///   - Closure: callable with inline captures (InlineCallback)
+///   - LinkBecomeFree, ChunkArrived: built-in events of the network backend,
+///     dispatched by the EventDispatcher registered to the event queue
+enum class EventKind : uint8_t {
+  Callback,
+  Closure,
+  LinkBecomeFree,
+  ChunkArrived
+};
+
+/// Dispatcher of built-in events: "void func(EventKind, void*)"
+using EventDispatcher = void (*)(EventKind, void*);
+
 /// Basic multi-dimensional topology building blocks
 enum class TopologyBuildingBlock { Undefined, Ring, FullyConnected, Switch };
 
+/// Collective communication patterns
+enum class CollectiveType {
+  AllReduce,
+  AllGather,
+  ReduceScatter,
+  AllToAll,
+  Broadcast
+};
+
+/// Algorithm of a collective within the NPUs of one dimension
+///   - Ring: p - 1 steps, each NPU sends to its neighbor in the dimension
+///   - Direct: one step, each NPU sends to every other NPU of the dimension
+///   - HalvingDoubling: log2(p) steps of pairwise exchanges
+///     (binomial tree for Broadcast)
+enum class CollectiveAlgorithm { Ring, Direct, HalvingDoubling };
+
 } // namespace NetworkAnalytical
@@ -5,8 +5,11 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include "common/InlineCallback.hh"
 #include "common/Type.hh"
+#include "congestion_aware/Route.hh"
 #include "congestion_aware/Type.hh"
 
 using namespace NetworkAnalytical;
@@ -28,6 +31,23 @@ class Chunk {
    */
   static void chunk_arrived_next_device(void* chunk_ptr) noexcept;
 
+  /**
+   * Allocate memory for a chunk created with new, e.g., std::make_unique.
+   * Such chunks aren't pooled (see ChunkPool).
+   *
+   * @param size: size of the chunk
+   * @return pointer to the chunk memory
+   */
+  static void* operator new(size_t size) noexcept;
+
+  /**
+   * Release the memory of a chunk,
+   * to its ChunkPool if it was pooled, to the system allocator otherwise.
+   *
+   * @param chunk_ptr: pointer to the chunk memory
+   */
+  static void operator delete(void* chunk_ptr) noexcept;
+
   /**
    * Constructor.
    *
@@ -42,34 +62,81 @@ class Chunk {
       Callback callback,
       CallbackArg callback_arg) noexcept;
 
+  /**
+   * Constructor with a callback capturing a few words inline,
+   * e.g., [ctx, id]() { ctx->on_arrival(id); }.
+   *
+   * @param chunk_size: size of the chunk
+   * @param route: route of the chunk from its source to destination
+   * @param callback: callback to be invoked when the chunk arrives destination
+   */
+  Chunk(ChunkSize chunk_size, Route route, InlineCallback callback) noexcept;
+
   /**
    * Get the current sitting device of the chunk
    *
    * @return current device of the chunk
    */
-  [[nodiscard]] std::shared_ptr<Device> current_device() const noexcept;
+  [[nodiscard]] Device* current_device() const noexcept;
 
   /**
    * Get the next destined device of the chunk
    *
    * @return next device of the chunk
    */
-  [[nodiscard]] std::shared_ptr<Device> next_device() const noexcept;
+  [[nodiscard]] Device* next_device() const noexcept;
+
+  /**
+   * Check if the next device of the chunk is its destination.
+   *
+   * @return true if the next device is the destination, false otherwise
+   */
+  [[nodiscard]] bool next_device_is_dest() const noexcept;
+
+  /**
+   * Get the device the chunk is destined to after the next device.
+   *
+   * @return device after the next device of the chunk
+   */
+  [[nodiscard]] Device* device_after_next() const noexcept;
+
+  /**
+   * Get the index of the link from the current device to the next device,
+   * among the links of the current device.
+   *
+   * @return index of the link to the next device
+   */
+  [[nodiscard]] int next_link_index() const noexcept;
+
+  /**
+   * Get the index of the link from the next device to the device after it,
+   * among the links of the next device.
+   *
+   * @return index of the link after the next device
+   */
+  [[nodiscard]] int link_index_after_next() const noexcept;
 
   /**
    * Mark the chunk arrived at its next device
-   * i.e., drop the current device from the route
+   * i.e., advance the hop cursor along the route
    */
   void mark_arrived_next_device() noexcept;
 
   /**
    * Check if the chunk arrived at its destination
-   * i.e., if the route length is 1 (only destination device left)
+   * i.e., if the hop cursor points to the last device of the route
    *
    * @return true if the chunk arrived at its destination, false otherwise
    */
   [[nodiscard]] bool arrived_dest() const noexcept;
 
+  /**
+   * Get the route of the chunk
+   *
+   * @return route of the chunk from its source to destination
+   */
+  [[nodiscard]] const Route& get_route() const noexcept;
+
   /**
    * Get the size of the chunk
    *
@@ -87,17 +154,17 @@ class Chunk {
   /// size of the chunk
   ChunkSize chunk_size;
 
-  /// route of the chunk to its destination.
-  /// Route has the structure of [current device, next device, ..., dest device]
+  /// route of the chunk from its source to destination.
+  /// Route has the structure of [src device, ..., dest device]
   /// e.g., if a chunk starts from device 5, then reaches destination 3,
   /// the route would be e.g., [5, 1, 6, 2, 3]
   Route route;
 
-  /// callback to be invoked when the chunk arrives at its destination
-  Callback callback;
+  /// index of the current device of the chunk in the route
+  int hop;
 
-  /// argument of the callback
-  CallbackArg callback_arg;
+  /// callback to be invoked when the chunk arrives at its destination
+  InlineCallback callback;
 };
 
 } // namespace NetworkAnalyticalCongestionAware
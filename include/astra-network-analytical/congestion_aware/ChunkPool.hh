@@ -0,0 +1,163 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/Arena.hh"
+#include "common/InlineCallback.hh"
+#include "common/Type.hh"
+#include "congestion_aware/Chunk.hh"
+#include "congestion_aware/Type.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ChunkPool hands out Chunk objects recycled through an Arena.
+ *
+ * Each chunk is preceded by a header naming its pool, so that deleting
+ * a pooled chunk (e.g., through the default deleter of unique_ptr<Chunk>)
+ * returns its memory to the pool.
+ * Chunks allocated with plain new (e.g., std::make_unique<Chunk>)
+ * carry an empty header and go back to the system allocator.
+ *
+ * The arena outlives the pool while chunks of the pool are alive,
+ * e.g., held by the events of a simulation stopped early,
+ * and is released with the last of them.
+ *
+ * ChunkPool is not thread-safe: chunks of a pool shouldn't be created or
+ * destroyed concurrently, so Topology::make_chunk() creates unpooled
+ * chunks while a ParallelSimulation partitions the topology.
+ */
+class ChunkPool {
+ public:
+  /// size of the header preceding each chunk, keeping chunks aligned
+  static constexpr size_t header_size = Arena::block_alignment;
+
+  /**
+   * Allocate memory for a chunk outside of any pool.
+   *
+   * @param size size of the chunk
+   * @return pointer to the chunk memory
+   */
+  [[nodiscard]] static void* allocate_unpooled(size_t size) noexcept;
+
+  /**
+   * Release the memory of a chunk,
+   * to its pool if it was pooled, to the system allocator otherwise.
+   *
+   * @param chunk_ptr pointer to the chunk memory
+   */
+  static void deallocate(void* chunk_ptr) noexcept;
+
+  /**
+   * Constructor.
+   */
+  ChunkPool() noexcept;
+
+  /**
+   * Destructor.
+   * Chunks still alive keep the arena until they're deleted.
+   */
+  ~ChunkPool() noexcept;
+
+  ChunkPool(const ChunkPool&) = delete;
+  ChunkPool& operator=(const ChunkPool&) = delete;
+
+  /**
+   * Create a pooled chunk.
+   *
+   * @param chunk_size size of the chunk
+   * @param route route of the chunk from its source to destination
+   * @param callback callback to be invoked when the chunk arrives destination
+   * @param callback_arg argument of the callback
+   * @return created chunk
+   */
+  [[nodiscard]] std::unique_ptr<Chunk> make_chunk(
+      ChunkSize chunk_size,
+      Route route,
+      Callback callback,
+      CallbackArg callback_arg) noexcept;
+
+  /**
+   * Create a pooled chunk with a callback capturing a few words inline.
+   *
+   * @param chunk_size size of the chunk
+   * @param route route of the chunk from its source to destination
+   * @param callback callback to be invoked when the chunk arrives destination
+   * @return created chunk
+   */
+  [[nodiscard]] std::unique_ptr<Chunk> make_chunk(
+      ChunkSize chunk_size,
+      Route route,
+      InlineCallback callback) noexcept;
+
+  /**
+   * Get the number of chunks of this pool currently alive.
+   *
+   * @return number of live chunks
+   */
+  [[nodiscard]] size_t get_chunks_count() const noexcept;
+
+  /**
+   * Get the maximum number of chunks of this pool alive at once.
+   *
+   * @return high-water mark of live chunks
+   */
+  [[nodiscard]] size_t get_peak_chunks_count() const noexcept;
+
+  /**
+   * Get the arena backing the pool.
+   *
+   * @return arena of the pool
+   */
+  [[nodiscard]] const Arena& get_arena() const noexcept;
+
+ private:
+  /**
+   * Storage of a pool, named by the header of each chunk,
+   * which outlives the pool while chunks of the pool are alive.
+   */
+  struct Storage {
+    /// arena the chunks are allocated from
+    Arena arena;
+
+    /// number of chunks currently alive
+    size_t chunks_count;
+
+    /// maximum number of chunks alive at once
+    size_t peak_chunks_count;
+
+    /// whether the pool is destroyed, so the last chunk frees the storage
+    bool orphaned;
+  };
+
+  /// size of a pooled block: header and chunk
+  static constexpr size_t block_size = header_size + sizeof(Chunk);
+
+  /// storage of the pool
+  Storage* storage;
+
+  /**
+   * Get memory for a pooled chunk.
+   *
+   * @return pointer to the chunk memory
+   */
+  [[nodiscard]] void* acquire() noexcept;
+
+  /**
+   * Return the memory of a pooled chunk,
+   * freeing the storage with the last chunk of a destroyed pool.
+   *
+   * @param storage storage of the pool of the chunk
+   * @param block pointer to the block, i.e., the header of the chunk
+   */
+  static void release(Storage* storage, void* block) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,308 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "common/EventQueue.hh"
+#include "common/InlineCallback.hh"
+#include "common/Type.hh"
+#include "congestion_aware/Topology.hh"
+#include "congestion_aware/Type.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Collective simulates a collective communication over a topology,
+ * sending its chunks through Topology::send().
+ *
+ * The collective is compiled into steps of transfers (src, dest, size).
+ * Each NPU issues its transfers step by step:
+ * it starts step s once every transfer sent to it in step s - 1 arrived,
+ * e.g., a Ring step forwards the data received in the previous step.
+ *
+ * On a multi-dimensional topology, the collective is hierarchical:
+ * one phase per dimension, each running the algorithm of the dimension
+ * among the NPUs differing only in their coordinate of the dimension.
+ *   - Reduce-Scatter: dimensions 0, 1, ..., each on the scattered data
+ *   - All-Gather: dimensions ..., 1, 0, mirroring Reduce-Scatter
+ *   - All-Reduce: Reduce-Scatter, then All-Gather
+ *   - All-to-All and Broadcast: dimensions 0, 1, ... on the whole data
+ *
+ * Transfers are stored contiguously per (step, NPU) as chunk descriptors,
+ * tagged with the (dest, step) slot they count toward,
+ * so each step is issued by one Topology::send_batch() call
+ * and no memory is allocated per chunk beyond the chunk pool.
+ */
+class Collective {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param topology topology to run the collective on
+   * @param type collective communication pattern
+   * @param collective_size size of the data of each NPU in bytes:
+   *     the input for All-Reduce, Reduce-Scatter, All-to-All, and Broadcast,
+   *     the output for All-Gather
+   * @param algorithm_per_dim algorithm of the collective in each dimension
+   * @param root NPU holding the data of a Broadcast, ignored otherwise
+   */
+  Collective(
+      std::shared_ptr<Topology> topology,
+      CollectiveType type,
+      ChunkSize collective_size,
+      std::vector<CollectiveAlgorithm> algorithm_per_dim,
+      DeviceId root = 0) noexcept;
+
+  /**
+   * Constructor using the same algorithm in every dimension.
+   *
+   * @param topology topology to run the collective on
+   * @param type collective communication pattern
+   * @param collective_size size of the data of each NPU in bytes
+   * @param algorithm algorithm of the collective in every dimension
+   * @param root NPU holding the data of a Broadcast, ignored otherwise
+   */
+  Collective(
+      std::shared_ptr<Topology> topology,
+      CollectiveType type,
+      ChunkSize collective_size,
+      CollectiveAlgorithm algorithm,
+      DeviceId root = 0) noexcept;
+
+  /**
+   * Start the collective at the current time.
+   * A finished collective can be started again.
+   *
+   * @param callback callback to be invoked when the collective finishes
+   */
+  void start(InlineCallback callback = InlineCallback()) noexcept;
+
+  /**
+   * Check whether the collective finished.
+   *
+   * @return true if every transfer arrived, false otherwise
+   */
+  [[nodiscard]] bool finished() const noexcept;
+
+  /**
+   * Get the time the collective started.
+   *
+   * @return start time of the collective
+   */
+  [[nodiscard]] EventTime get_start_time() const noexcept;
+
+  /**
+   * Get the time the last transfer of the collective arrived.
+   *
+   * @return finish time of the collective
+   */
+  [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+  /**
+   * Get the completion time of the collective.
+   *
+   * @return finish time - start time
+   */
+  [[nodiscard]] EventTime get_duration() const noexcept;
+
+  /**
+   * Get the number of steps of the collective.
+   *
+   * @return number of steps
+   */
+  [[nodiscard]] int get_steps_count() const noexcept;
+
+  /**
+   * Get the number of transfers of the collective, i.e., sent chunks.
+   *
+   * @return number of transfers
+   */
+  [[nodiscard]] int get_transfers_count() const noexcept;
+
+ private:
+  /**
+   * Transfer while the steps are being compiled.
+   */
+  struct StepTransfer {
+    /// step of the transfer
+    int step;
+
+    /// chunk sent, tagged once the steps are compiled
+    ChunkDescriptor transfer;
+  };
+
+  /**
+   * Handle the arrival of a transfer sent by send_batch().
+   *
+   * @param collective_ptr pointer to the collective
+   * @param tag slot of the (dest, step) of the transfer
+   */
+  static void chunk_arrived(void* collective_ptr, uint64_t tag) noexcept;
+
+  /// topology to run the collective on
+  std::shared_ptr<Topology> topology;
+
+  /// event queue of the topology
+  std::shared_ptr<EventQueue> event_queue;
+
+  /// number of NPUs
+  int npus_count;
+
+  /// number of NPUs per dimension
+  std::vector<int> npus_count_per_dim;
+
+  /// stride of the NPU ids per dimension
+  std::vector<int> stride_per_dim;
+
+  /// number of steps
+  int steps_count;
+
+  /// transfers, sorted by (step, src)
+  std::vector<ChunkDescriptor> transfers;
+
+  /// transfers sent by (src, step) are in
+  /// [offsets[slot(src, step)], offsets[slot(src, step) + 1])
+  std::vector<int> offsets;
+
+  /// number of transfers received by (dest, step), indexed by slot
+  std::vector<int> receives_count;
+
+  /// transfers to be received by (dest, step), indexed by slot
+  std::vector<int> pending_receives;
+
+  /// next step to issue per NPU
+  std::vector<int> next_step;
+
+  /// number of transfers not arrived yet
+  int pending_transfers_count;
+
+  /// time the collective started
+  EventTime start_time;
+
+  /// time the last transfer arrived
+  EventTime finish_time;
+
+  /// callback to be invoked when the collective finishes
+  InlineCallback callback;
+
+  /// transfers while the steps are being compiled
+  std::vector<StepTransfer> step_transfers;
+
+  /**
+   * Get an NPU of the same line of a dimension.
+   *
+   * @param npu_id NPU of the line
+   * @param dim dimension of the line
+   * @param rank coordinate of the NPU to get in the dimension
+   * @return id of the NPU
+   */
+  [[nodiscard]] DeviceId peer(DeviceId npu_id, int dim, int rank)
+      const noexcept;
+
+  /**
+   * Get the coordinate of an NPU in a dimension.
+   *
+   * @param npu_id id of the NPU
+   * @param dim dimension
+   * @return coordinate of the NPU in the dimension
+   */
+  [[nodiscard]] int rank(DeviceId npu_id, int dim) const noexcept;
+
+  /**
+   * Get the index of (NPU, step) into the per-slot arrays.
+   *
+   * @param npu_id id of the NPU
+   * @param step step of the collective
+   * @return index of the slot
+   */
+  [[nodiscard]] int slot(DeviceId npu_id, int step) const noexcept;
+
+  /**
+   * Compile the Reduce-Scatter phase of a dimension.
+   *
+   * @param dim dimension of the phase
+   * @param algorithm algorithm of the phase
+   * @param size size of the data of each NPU before the phase
+   */
+  void add_reduce_scatter(
+      int dim,
+      CollectiveAlgorithm algorithm,
+      ChunkSize size) noexcept;
+
+  /**
+   * Compile the All-Gather phase of a dimension.
+   *
+   * @param dim dimension of the phase
+   * @param algorithm algorithm of the phase
+   * @param size size of the data of each NPU after the phase
+   */
+  void add_all_gather(
+      int dim,
+      CollectiveAlgorithm algorithm,
+      ChunkSize size) noexcept;
+
+  /**
+   * Compile the All-to-All phase of a dimension.
+   *
+   * @param dim dimension of the phase
+   * @param algorithm algorithm of the phase
+   * @param size size of the data of each NPU
+   */
+  void add_all_to_all(
+      int dim,
+      CollectiveAlgorithm algorithm,
+      ChunkSize size) noexcept;
+
+  /**
+   * Compile the Broadcast phase of a dimension.
+   *
+   * @param dim dimension of the phase
+   * @param algorithm algorithm of the phase
+   * @param size size of the broadcast data
+   * @param root NPU holding the data of the Broadcast
+   */
+  void add_broadcast(
+      int dim,
+      CollectiveAlgorithm algorithm,
+      ChunkSize size,
+      DeviceId root) noexcept;
+
+  /**
+   * Add a compiled transfer.
+   *
+   * @param src NPU sending the chunk
+   * @param step step of the transfer
+   * @param dest NPU receiving the chunk
+   * @param size size of the chunk
+   */
+  void add_transfer(DeviceId src, int step, DeviceId dest, ChunkSize size)
+      noexcept;
+
+  /**
+   * Sort the compiled transfers by (step, src).
+   */
+  void build_steps() noexcept;
+
+  /**
+   * Issue the steps of an NPU whose dependencies are resolved.
+   *
+   * @param npu_id id of the NPU
+   */
+  void advance(DeviceId npu_id) noexcept;
+
+  /**
+   * Handle the arrival of a transfer.
+   *
+   * @param receive_slot slot of the (dest, step) of the transfer
+   */
+  void transfer_arrived(int receive_slot) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
@@ -5,7 +5,6 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
-#include <map>
 #include <memory>
 #include "common/Type.hh"
 #include "congestion_aware/Type.hh"
@@ -17,6 +16,9 @@ namespace NetworkAnalyticalCongestionAware {
 /**
  * Device class represents a single device in the network.
  * Device is usually an NPU or a switch.
+ *
+ * Links are owned by the Topology in a single contiguous array;
+ * a device refers to the slice of its outgoing links, sorted by dest.
  */
 class Device {
  public:
@@ -43,29 +45,69 @@ class Device {
   void send(std::unique_ptr<Chunk> chunk) noexcept;
 
   /**
-   * Connect a device to another device.
+   * Set the outgoing links of this device.
    *
-   * @param id id of the device to connect this device to
-   * @param bandwidth bandwidth of the link
-   * @param latency latency of the link
+   * @param links first outgoing link of this device
+   * @param link_dests dest device id of each outgoing link, sorted
+   * @param links_count number of outgoing links
    */
-  void connect(DeviceId id, Bandwidth bandwidth, Latency latency) noexcept;
+  void set_links(
+      Link* links,
+      const DeviceId* link_dests,
+      int links_count) noexcept;
 
- private:
-  /// device Id
-  DeviceId device_id;
+  /**
+   * Get the number of outgoing links of this device.
+   *
+   * @return number of outgoing links
+   */
+  [[nodiscard]] int get_links_count() const noexcept;
+
+  /**
+   * Get the index of the link connecting this device to another device,
+   * among the links of this device.
+   *
+   * @param dest id of the connected device
+   * @return index of the link to the given device
+   */
+  [[nodiscard]] int get_link_index(DeviceId dest) const noexcept;
+
+  /**
+   * Get the link connecting this device to another device.
+   *
+   * @param dest id of the connected device
+   * @return link to the given device
+   */
+  [[nodiscard]] Link* get_link(DeviceId dest) const noexcept;
 
-  /// links to other nodes
-  /// map[dest node node_id] -> link
-  std::map<DeviceId, std::shared_ptr<Link>> links;
+  /**
+   * Get a link of this device by its index.
+   *
+   * @param link_index index of the link among the links of this device
+   * @return link of the given index
+   */
+  [[nodiscard]] Link* get_link_at(int link_index) const noexcept;
 
   /**
-   * Check if this device is connected to another device.
+   * Get the dest device of a link of this device by its index.
    *
-   * @param dest id of the device to check te connectivity
-   * @return true if connected to the given device, false otherwise
+   * @param link_index index of the link among the links of this device
+   * @return id of the dest device of the link
    */
-  [[nodiscard]] bool connected(DeviceId dest) const noexcept;
+  [[nodiscard]] DeviceId get_link_dest(int link_index) const noexcept;
+
+ private:
+  /// device Id
+  DeviceId device_id;
+
+  /// first outgoing link of this device, owned by the topology
+  Link* links;
+
+  /// dest device id of each outgoing link, sorted
+  const DeviceId* link_dests;
+
+  /// number of outgoing links
+  int links_count;
 };
 
 } // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,205 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "common/EventQueue.hh"
+#include "common/InlineCallback.hh"
+#include "common/Type.hh"
+#include "congestion_aware/Route.hh"
+#include "congestion_aware/Topology.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * FlowSimulation is a flow-level (fluid) congestion-aware engine.
+ *
+ * Each message is a flow over its route, instead of chunks hopping
+ * from link to link. The bandwidth of every link is shared by the flows
+ * crossing it with max-min fairness (progressive filling),
+ * and the rates are recomputed only when a flow starts or drains,
+ * so the number of events is proportional to the number of flows
+ * rather than to the number of (chunk, hop) pairs.
+ *
+ * A flow drains once all its bytes are transmitted at its rates;
+ * its callback is then invoked after the latency of its route.
+ * This ignores the store-and-forward serialization at every hop
+ * and the FIFO order of chunks queued at a link, which the packet engine
+ * models (see benchmark_flow_simulation for the accuracy trade-off).
+ *
+ * The engine shares the links and the EventQueue of the topology,
+ * but not their occupancy: flows and chunks don't congest each other.
+ */
+class FlowSimulation {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param topology topology whose links the flows traverse
+   */
+  explicit FlowSimulation(std::shared_ptr<Topology> topology) noexcept;
+
+  /**
+   * Start a flow at the current time.
+   *
+   * @param message_size size of the message in bytes
+   * @param route route of the flow, e.g., from topology->route()
+   * @param callback callback to be invoked when the message arrives dest
+   * @param callback_arg argument of the callback
+   */
+  void send(
+      ChunkSize message_size,
+      const Route& route,
+      Callback callback,
+      CallbackArg callback_arg) noexcept;
+
+  /**
+   * Start a flow at the current time,
+   * with a callback capturing a few words inline.
+   *
+   * @param message_size size of the message in bytes
+   * @param route route of the flow, e.g., from topology->route()
+   * @param callback callback to be invoked when the message arrives dest
+   */
+  void send(
+      ChunkSize message_size,
+      const Route& route,
+      InlineCallback callback) noexcept;
+
+  /**
+   * Get the number of flows still transmitting.
+   *
+   * @return number of active flows
+   */
+  [[nodiscard]] int get_active_flows_count() const noexcept;
+
+  /**
+   * Get the current rate of an active flow.
+   * Flows are identified by the order of send() calls, starting from 0.
+   *
+   * @param flow_id id of the flow
+   * @return rate of the flow in GB/s, 0 if not active
+   */
+  [[nodiscard]] Bandwidth get_flow_rate(uint64_t flow_id) const noexcept;
+
+  /**
+   * Get the number of max-min rate recomputations so far.
+   *
+   * @return number of rate recomputations
+   */
+  [[nodiscard]] uint64_t get_rate_updates_count() const noexcept;
+
+ private:
+  /**
+   * Message transmitted as a flow.
+   */
+  struct Flow {
+    /// id of the flow, in the order of send() calls
+    uint64_t flow_id;
+
+    /// ids of the links traversed by the flow
+    std::vector<int> link_ids;
+
+    /// bytes not transmitted yet
+    double remaining_bytes;
+
+    /// current rate in B/ns, negative while not assigned
+    double rate;
+
+    /// latency of the route in ns
+    EventTime latency;
+
+    /// callback to be invoked when the message arrives dest
+    InlineCallback callback;
+  };
+
+  /// topology whose links the flows traverse
+  std::shared_ptr<Topology> topology;
+
+  /// event queue of the topology
+  std::shared_ptr<EventQueue> event_queue;
+
+  /// capacity of each link in B/ns, indexed by link id
+  std::vector<double> link_capacities;
+
+  /// flow slots, reused once their flows drain
+  std::vector<Flow> flows;
+
+  /// indices of the unused flow slots
+  std::vector<int> free_slots;
+
+  /// indices of the slots of the active flows
+  std::vector<int> active_slots;
+
+  /// id of the next flow
+  uint64_t next_flow_id;
+
+  /// time the remaining bytes of the flows were last updated
+  EventTime last_update_time;
+
+  /// incremented whenever the rates change,
+  /// invalidating the drain event scheduled with the previous rates
+  uint64_t epoch;
+
+  /// whether a rate update is already scheduled at the current time
+  bool update_pending;
+
+  /// number of rate recomputations
+  uint64_t rate_updates_count;
+
+  /// scratch of the progressive filling, indexed by link id:
+  /// capacity not assigned yet
+  std::vector<double> residual_capacities;
+
+  /// scratch of the progressive filling, indexed by link id:
+  /// number of flows without an assigned rate
+  std::vector<int> unassigned_counts;
+
+  /// scratch of the progressive filling, indexed by link id:
+  /// slots of the flows crossing the link
+  std::vector<std::vector<int>> link_flows;
+
+  /// scratch of the progressive filling: links crossed by any flow
+  std::vector<int> used_links;
+
+  /**
+   * Transmit the bytes of every active flow
+   * from the last update up to the current time.
+   */
+  void advance() noexcept;
+
+  /**
+   * Recompute the max-min fair rates of the active flows,
+   * then schedule the event of the next drain.
+   */
+  void update_rates() noexcept;
+
+  /**
+   * Assign the max-min fair rates by progressive filling:
+   * repeatedly saturate the links with the smallest fair share,
+   * fixing the rates of the flows crossing them.
+   */
+  void assign_rates() noexcept;
+
+  /**
+   * Schedule the event of the earliest drain under the current rates.
+   */
+  void schedule_drain() noexcept;
+
+  /**
+   * Handle a drain event: finish the drained flows
+   * and recompute the rates of the others.
+   *
+   * @param epoch epoch the event was scheduled at
+   */
+  void drain(uint64_t epoch) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
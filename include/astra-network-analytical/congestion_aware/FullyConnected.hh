@@ -36,9 +36,9 @@ class FullyConnected final : public BasicTopology {
   FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
   /**
-   * Implementation of route function in Topology.
+   * Implementation of construct_route function in Topology.
    */
-  [[nodiscard]] Route route(DeviceId src, DeviceId dest)
+  [[nodiscard]] Route construct_route(DeviceId src, DeviceId dest)
       const noexcept override;
 };
 
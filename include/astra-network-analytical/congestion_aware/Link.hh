@@ -5,8 +5,11 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <utility>
 #include "common/EventQueue.hh"
+#include "common/RingBuffer.hh"
 #include "common/Type.hh"
 #include "congestion_aware/Type.hh"
 
@@ -16,25 +19,33 @@ namespace NetworkAnalyticalCongestionAware {
 
 /**
  * Link models physical links between two devices.
+ *
+ * A link serializes its chunks in FIFO order, so the departure of a chunk
+ * is fully determined when it's sent: it departs once the link finishes
+ * serializing the chunks sent before it.
+ * The link therefore keeps only the time it becomes free,
+ * and schedules the arrival of every chunk at the next device right away;
+ * chunks sent later never change the schedule of earlier ones.
+ * The arrival is keyed by the departure of the chunk, so it's ordered
+ * among the simultaneous events as if scheduled when the chunk departs.
+ *
+ * Under the hybrid model, the chunks queued hop by hop still depart in FIFO
+ * order, each in the first gap between the reserved slots after the chunk
+ * before it. Slots reserved by idle routes stay committed, so a chunk
+ * queued hop by hop waits for the reservations made before it was sent,
+ * even ones ahead in time (reservations are only made while no chunk
+ * queued hop by hop is yet to cross the link).
  */
 class Link {
  public:
   /**
-   * Callback to be called when a link becomes free.
-   *  - If the link has pending chunks, process the first one.
-   *  - If the link has no pending chunks, set the link as free.
+   * Dispatcher of the built-in events scheduled by links.
+   *   - EventKind::ChunkArrived: the target chunk arrives at the next device
    *
-   * @param link_ptr pointer to the link that becomes free
+   * @param kind kind of the built-in event
+   * @param target chunk the event acts on
    */
-  static void link_become_free(void* link_ptr) noexcept;
-
-  /**
-   * Set the event queue to be used by the link.
-   *
-   * @param event_queue_ptr pointer to the event queue
-   */
-  static void set_event_queue(
-      std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+  static void dispatch_event(EventKind kind, void* target) noexcept;
 
   /**
    * Constructor.
@@ -45,40 +56,154 @@ class Link {
   Link(Bandwidth bandwidth, Latency latency) noexcept;
 
   /**
-   * Try to send a chunk through the link.
-   * - If the link is free, service the chunk immediately.
-   * - If the link is busy, add the chunk to the pending chunks list.
+   * Send a chunk through the link.
+   * The chunk departs once the link becomes free (immediately if idle),
+   * and arrives at the next device after its communication delay.
    *
    * @param chunk the chunk to be served by the link
    */
   void send(std::unique_ptr<Chunk> chunk) noexcept;
 
   /**
-   * Dequeue and try to send the first pending chunk
-   * in the pending chunks list.
+   * Serialize a chunk on the link, without scheduling its arrival,
+   * e.g., to schedule the arrivals of a batch of chunks at once.
+   * The chunk departs once the link becomes free (immediately if idle);
+   * under the hybrid model, in the earliest free slot after the chunks
+   * transmitted before it.
+   *
+   * @param chunk_size size of the chunk
+   * @return time the chunk arrives at the next device
+   */
+  EventTime transmit(ChunkSize chunk_size) noexcept;
+
+  /**
+   * Reserve the link for a chunk ready to depart at the given time
+   * (reservation congestion model).
+   * The chunk takes the earliest slot of the timeline of the link
+   * which is free for its serialization delay, at or after the given time,
+   * so it may depart ahead of the chunks reserved later in the timeline.
+   *
+   * @param chunk_size size of the chunk
+   * @param ready_time time the chunk is ready to depart
+   * @return time the chunk arrives at the next device
+   */
+  EventTime reserve(ChunkSize chunk_size, EventTime ready_time) noexcept;
+
+  /**
+   * Register a chunk queued hop by hop whose route crosses the link
+   * (hybrid model). It's released once transmitted through the link.
+   */
+  void add_incoming_chunk() noexcept;
+
+  /**
+   * Check whether a chunk ready to depart at the given time
+   * would depart right away, i.e., no slot reserved on the link
+   * overlaps its serialization, and no chunk queued hop by hop
+   * is yet to cross the link.
+   *
+   * @param ready_time time the chunk is ready to depart
+   * @param chunk_size size of the chunk
+   * @return true if the chunk wouldn't wait, false otherwise
+   */
+  [[nodiscard]] bool is_idle(EventTime ready_time, ChunkSize chunk_size)
+      const noexcept;
+
+  /**
+   * Compute the communication delay of a chunk.
+   * i.e., communication delay = (link latency) + (serialization delay)
+   *
+   * @param chunk_size size of the target chunk
+   * @return communication delay of the chunk
    */
-  void process_pending_transmission() noexcept;
+  [[nodiscard]] EventTime communication_delay(
+      ChunkSize chunk_size) const noexcept;
 
   /**
-   * Check if the link has pending chunks.
+   * Check if the link has chunks waiting to depart.
    *
    * @return true if the link has pending chunks, false otherwise
    */
   [[nodiscard]] bool pending_chunk_exists() const noexcept;
 
   /**
-   * Set the link as busy.
+   * Get the number of chunks waiting to depart.
+   *
+   * @return number of pending chunks
+   */
+  [[nodiscard]] size_t get_pending_chunks_count() const noexcept;
+
+  /**
+   * Get the maximum number of chunks that have waited for the link at once.
+   *
+   * @return maximum queue depth of the link
+   */
+  [[nodiscard]] size_t get_max_pending_chunks_count() const noexcept;
+
+  /**
+   * Get the time the link finishes serializing the chunks sent
+   * or reserved so far.
+   *
+   * @return time the link becomes free
+   */
+  [[nodiscard]] EventTime get_free_time() const noexcept;
+
+  /**
+   * Set the event queue to be used by the link.
+   * The dispatcher of built-in events (dispatch_event)
+   * should be registered to the event queue.
+   *
+   * @param event_queue event queue of the simulation the link belongs to
+   */
+  void set_event_queue(EventQueue* event_queue) noexcept;
+
+  /**
+   * Set how the chunks sent through the link are congested.
+   * Under the hybrid model, transmit() queues into the reserved slots.
+   *
+   * @param congestion_model congestion model of the topology
    */
-  void set_busy() noexcept;
+  void set_congestion_model(CongestionModel congestion_model) noexcept;
 
   /**
-   * Set the link as free.
+   * Get the bandwidth of the link.
+   *
+   * @return bandwidth of the link in GB/s
    */
-  void set_free() noexcept;
+  [[nodiscard]] Bandwidth get_bandwidth() const noexcept;
+
+  /**
+   * Get the latency of the link.
+   *
+   * @return latency of the link in ns
+   */
+  [[nodiscard]] Latency get_latency() const noexcept;
+
+  /**
+   * Set the id of the link within its topology,
+   * which orders the simultaneous events the link schedules.
+   *
+   * @param link_id id of the link
+   */
+  void set_link_id(int link_id) noexcept;
+
+  /**
+   * Assign the link to a partition of a ParallelSimulation.
+   * Links without a partition use the sequential EventQueue.
+   *
+   * @param partition partition of the link, nullptr for the EventQueue
+   */
+  void set_partition(Partition* partition) noexcept;
+
+  /**
+   * Get the partition of the link.
+   *
+   * @return partition of the link, nullptr if sequentially simulated
+   */
+  [[nodiscard]] Partition* get_partition() const noexcept;
 
  private:
   /// event queue Link uses to schedule events
-  static std::shared_ptr<EventQueue> event_queue;
+  EventQueue* event_queue;
 
   /// bandwidth of the link in GB/s
   Bandwidth bandwidth;
@@ -89,11 +214,45 @@ class Link {
   /// latency of the link in ns
   Latency latency;
 
-  /// queue of pending chunks
-  std::list<std::unique_ptr<Chunk>> pending_chunks;
+  /// time the link finishes serializing the chunks sent so far
+  EventTime free_time;
+
+  /// time the link finishes serializing the chunks queued hop by hop
+  /// so far (hybrid model)
+  EventTime hop_by_hop_free_time;
 
-  /// flag to indicate if the link is busy
-  bool busy;
+  /// timeline of the reservation model: reserved slots (start, end),
+  /// ascending and disjoint, where adjacent slots are merged
+  RingBuffer<std::pair<EventTime, EventTime>> reserved_slots;
+
+  /// departure times of the chunks which may still be waiting, ascending;
+  /// a ring buffer, so that a steady-state send never allocates
+  RingBuffer<EventTime> departure_times;
+
+  /// maximum number of chunks that have waited for the link at once
+  size_t max_pending_chunks_count;
+
+  /// number of chunks queued hop by hop yet to cross the link
+  size_t incoming_chunks_count;
+
+  /// how the chunks sent through the link are congested
+  CongestionModel congestion_model;
+
+  /// partition of the link in a ParallelSimulation, nullptr if sequential
+  Partition* partition;
+
+  /// id of the link within its topology
+  int link_id;
+
+  /// number of events the link scheduled so far
+  uint64_t scheduled_events_count;
+
+  /**
+   * Get the current time of the event queue (or partition) of the link.
+   *
+   * @return current event time
+   */
+  [[nodiscard]] EventTime current_time() const noexcept;
 
   /**
    * Compute the serialization delay of a chunk on the link.
@@ -106,24 +265,32 @@ class Link {
       ChunkSize chunk_size) const noexcept;
 
   /**
-   * Compute the communication delay of a chunk.
-   * i.e., communication delay = (link latency) + (serialization delay)
+   * Queue a chunk on the link, as transmit() does.
    *
-   * @param chunk_size size of the target chunk
-   * @return communication delay of the chunk
+   * @param chunk_size size of the chunk
+   * @return time the chunk departs
    */
-  [[nodiscard]] EventTime communication_delay(
-      ChunkSize chunk_size) const noexcept;
+  EventTime queue_chunk(ChunkSize chunk_size) noexcept;
+
+  /**
+   * Reserve a slot of the link, as reserve() does.
+   *
+   * @param chunk_size size of the chunk
+   * @param ready_time time the chunk is ready to depart
+   * @return time the chunk departs
+   */
+  EventTime reserve_slot(ChunkSize chunk_size, EventTime ready_time) noexcept;
 
   /**
-   * Schedule the transmission of a chunk.
-   * - Set the link as busy.
-   * - Link becomes free after the serialization delay.
-   * - Chunk arrives next node after the communication delay.
+   * Schedule the arrival of a chunk at the next device,
+   * keyed by its departure.
    *
    * @param chunk chunk to be transmitted
+   * @param departure_time time the chunk departs
    */
-  void schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept;
+  void schedule_chunk_arrival(
+      std::unique_ptr<Chunk> chunk,
+      EventTime departure_time) noexcept;
 };
 
 } // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,104 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "common/Type.hh"
+#include "congestion_aware/BasicTopology.hh"
+#include "congestion_aware/Topology.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * MultiDimTopology implements multi-dimensional network topologies
+ * which can be constructed by stacking up multiple BasicTopology instances.
+ *
+ * NPUs sharing every coordinate but one form a line of that dimension,
+ * connected as the BasicTopology of the dimension
+ * (with its own switches, if any).
+ * Chunks are routed in dimension order, from the first dimension.
+ *
+ * e.g., [Ring(2), Switch(4)] has 8 NPUs:
+ *   - Ring lines: (0, 1), (2, 3), (4, 5), (6, 7)
+ *   - Switch lines: (0, 2, 4, 6) with switch 8, (1, 3, 5, 7) with switch 9
+ */
+class MultiDimTopology final : public Topology {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param topology_per_dim BasicTopology instance of each dimension
+   */
+  explicit MultiDimTopology(
+      std::vector<std::unique_ptr<BasicTopology>> topology_per_dim) noexcept;
+
+  /**
+   * Implementation of construct_route function in Topology.
+   */
+  [[nodiscard]] Route construct_route(DeviceId src, DeviceId dest)
+      const noexcept override;
+
+ private:
+  /// Each NPU ID can be broken down into multiple dimensions.
+  /// for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
+  /// then the NPU ID can be broken down into [1, 7, 1].
+  using MultiDimAddress = std::vector<DeviceId>;
+
+  /// BasicTopology instances per dimension.
+  std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
+
+  /// difference of the NPU IDs of adjacent coordinates per dimension
+  std::vector<int> stride_per_dim;
+
+  /// id of the first non-NPU device (e.g., switch) of each dimension
+  std::vector<DeviceId> first_device_id_per_dim;
+
+  /**
+   * Translate the NPU ID into a multi-dimensional address.
+   *
+   * @param npu_id id of the NPU
+   * @return the same NPU in multi-dimensional address representation
+   */
+  [[nodiscard]] MultiDimAddress translate_address(
+      DeviceId npu_id) const noexcept;
+
+  /**
+   * Get the index of the line of a dimension the given NPU belongs to.
+   *
+   * @param npu_id id of the NPU
+   * @param dim dimension of the line
+   * @return index of the line among the lines of the dimension
+   */
+  [[nodiscard]] int line_index(DeviceId npu_id, int dim) const noexcept;
+
+  /**
+   * Translate a device id of the BasicTopology of a dimension
+   * into the device id of this topology,
+   * along the line of the dimension the given NPU belongs to.
+   *
+   * @param local_id device id within the BasicTopology of the dimension
+   * @param npu_id id of an NPU on the line
+   * @param dim dimension of the line
+   * @return device id within this topology
+   */
+  [[nodiscard]] DeviceId translate_device_id(
+      DeviceId local_id,
+      DeviceId npu_id,
+      int dim) const noexcept;
+
+  /**
+   * Connect the lines of a dimension
+   * the same way as the BasicTopology of the dimension.
+   *
+   * @param dim dimension to connect
+   */
+  void connect_dimension(int dim) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
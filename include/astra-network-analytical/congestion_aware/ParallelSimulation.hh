@@ -0,0 +1,144 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "common/Type.hh"
+#include "congestion_aware/Partition.hh"
+#include "congestion_aware/Topology.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+class SpinBarrier;
+
+/**
+ * ParallelSimulation runs a congestion-aware topology
+ * as a conservative parallel discrete-event simulation.
+ *
+ * Links (and NPUs) are partitioned across worker threads,
+ * and each partition processes its own events.
+ * Every chunk crossing partitions takes at least the minimum link latency,
+ * so partitions independently process a window of that length (lookahead)
+ * and then exchange the events sent to each other.
+ *
+ * Simultaneous events are ordered by a deterministic key (see ParallelEvent),
+ * so results are bit-identical for any number of threads,
+ * and to the sequential run on the EventQueue, which uses the same key.
+ *
+ * While the simulation runs:
+ *   - links schedule their events into their partitions
+ *     instead of the EventQueue of the topology,
+ *   - chunk callbacks run on the worker thread owning the destination NPU,
+ *     and may only send chunks from that NPU,
+ *   - Topology::make_chunk() allocates unpooled chunks, which are freed
+ *     on the worker of their destination,
+ *   - Topology::route() only reads the routing table,
+ *     and batched sends (e.g., Topology::send_batch()) are rejected,
+ *   - get_current_time() returns the time of the calling worker.
+ */
+class ParallelSimulation {
+ public:
+  /**
+   * Constructor.
+   * Partitions the links of the topology, which should be done
+   * before any chunk is created or sent through the topology.
+   *
+   * @param topology topology to simulate
+   * @param threads_count number of worker threads (and partitions)
+   */
+  ParallelSimulation(
+      std::shared_ptr<Topology> topology,
+      int threads_count) noexcept;
+
+  /**
+   * Destructor.
+   * Returns the links to the sequential EventQueue
+   * and Topology::make_chunk() to the chunk pool.
+   */
+  ~ParallelSimulation() noexcept;
+
+  /**
+   * Run the simulation until every event is processed.
+   */
+  void run() noexcept;
+
+  /**
+   * Get the current simulation time.
+   * Inside chunk callbacks, this is the time of the calling worker.
+   * After run(), this is the time of the last processed event.
+   *
+   * @return current simulation time
+   */
+  [[nodiscard]] EventTime get_current_time() const noexcept;
+
+  /**
+   * Get the number of partitions.
+   * Falls back to a single partition if the lookahead is zero.
+   *
+   * @return number of partitions
+   */
+  [[nodiscard]] int get_partitions_count() const noexcept;
+
+  /**
+   * Get the lookahead, i.e., the minimum link latency.
+   *
+   * @return lookahead in ns
+   */
+  [[nodiscard]] EventTime get_lookahead() const noexcept;
+
+  /**
+   * Get the partition processing the arrival of a chunk at its next device.
+   *   - If the next device is the destination, the partition of the NPU.
+   *   - Otherwise, the partition of the next link the chunk is sent through.
+   *
+   * @param chunk chunk being transmitted
+   * @return partition processing the arrival of the chunk
+   */
+  [[nodiscard]] Partition* arrival_partition(const Chunk& chunk) const noexcept;
+
+ private:
+  /// topology to simulate
+  std::shared_ptr<Topology> topology;
+
+  /// partitions, one per worker thread
+  std::vector<std::unique_ptr<Partition>> partitions;
+
+  /// partition owning each device
+  std::vector<Partition*> device_partitions;
+
+  /// minimum link latency in ns
+  EventTime lookahead;
+
+  /// time of the last processed event
+  EventTime current_time;
+
+  /**
+   * Compute the partition owning a device.
+   * Devices are assigned in contiguous blocks of ids,
+   * NPUs and non-NPU devices (e.g., switches) separately.
+   *
+   * @param device_id id of the device
+   * @return partition owning the device
+   */
+  [[nodiscard]] Partition* device_partition(DeviceId device_id) const noexcept;
+
+  /**
+   * Process the events of a partition, synchronizing with other workers.
+   *
+   * @param partition partition to process
+   * @param barrier barrier shared by the workers
+   * @param min_event_times earliest event time of each partition
+   */
+  void run_partition(
+      Partition& partition,
+      SpinBarrier& barrier,
+      std::vector<EventTime>& min_event_times) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
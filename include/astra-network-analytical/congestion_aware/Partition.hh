@@ -0,0 +1,144 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "common/Event.hh"
+#include "common/Type.hh"
+#include "congestion_aware/Type.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+class ParallelSimulation;
+
+/**
+ * ParallelEvent is a built-in event of the parallel simulation.
+ *
+ * Events are ordered by (event time, EventKey of the origin link),
+ * a key which doesn't depend on how the links are partitioned.
+ * Therefore, every link observes its events in the same order
+ * regardless of the number of partitions,
+ * and in the same order as the sequential EventQueue.
+ */
+struct ParallelEvent {
+  /// time of the event
+  EventTime event_time;
+
+  /// order of the event among the simultaneous ones
+  EventKey key;
+
+  /// kind of the built-in event
+  EventKind kind;
+
+  /// link or chunk the event acts on
+  void* target;
+};
+
+/**
+ * Partition owns a subset of the links (and NPUs) of a parallel simulation
+ * and the events acting on them, processed by a single worker thread.
+ *
+ * Events for other partitions are buffered in per-partition outboxes,
+ * and exchanged when all partitions synchronize.
+ */
+class Partition {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param id id of the partition
+   * @param partitions_count number of partitions in the simulation
+   * @param simulation parallel simulation the partition belongs to
+   */
+  Partition(
+      int id,
+      int partitions_count,
+      const ParallelSimulation* simulation) noexcept;
+
+  /**
+   * Get id of the partition.
+   *
+   * @return id of the partition
+   */
+  [[nodiscard]] int get_id() const noexcept;
+
+  /**
+   * Get the parallel simulation the partition belongs to.
+   *
+   * @return parallel simulation of the partition
+   */
+  [[nodiscard]] const ParallelSimulation* get_simulation() const noexcept;
+
+  /**
+   * Get the time of the event being processed.
+   *
+   * @return current event time of the partition
+   */
+  [[nodiscard]] EventTime get_current_time() const noexcept;
+
+  /**
+   * Get the earliest event time of the partition.
+   *
+   * @return earliest event time, or the max EventTime if there's no event
+   */
+  [[nodiscard]] EventTime get_min_event_time() const noexcept;
+
+  /**
+   * Schedule an event to be processed by the given partition.
+   *
+   * @param partition partition to process the event
+   * @param event event to schedule
+   */
+  void schedule_event(Partition* partition, const ParallelEvent& event) noexcept;
+
+  /**
+   * Move the events sent by other partitions into this partition.
+   *
+   * @param partitions every partition of the simulation
+   */
+  void receive_events(
+      const std::vector<std::unique_ptr<Partition>>& partitions) noexcept;
+
+  /**
+   * Process the events earlier than the given time, in the order of their keys.
+   *
+   * @param end_time end (exclusive) of the window to process
+   */
+  void process_events(EventTime end_time) noexcept;
+
+ private:
+  /// id of the partition
+  int id;
+
+  /// parallel simulation the partition belongs to
+  const ParallelSimulation* simulation;
+
+  /// time of the event being processed
+  EventTime current_time;
+
+  /// events of this partition, in binary heap layout
+  std::vector<ParallelEvent> events;
+
+  /// events sent to other partitions, per destination partition
+  std::vector<std::vector<ParallelEvent>> outboxes;
+
+  /**
+   * Heap comparator, placing the earliest event at the top of the heap.
+   *
+   * @param lhs an event
+   * @param rhs another event
+   * @return true if lhs should be processed after rhs, false otherwise
+   */
+  [[nodiscard]] static bool later(
+      const ParallelEvent& lhs,
+      const ParallelEvent& rhs) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
@@ -46,9 +46,9 @@ class Ring final : public BasicTopology {
       bool bidirectional = true) noexcept;
 
   /**
-   * Implementation of route function in Topology.
+   * Implementation of construct_route function in Topology.
    */
-  [[nodiscard]] Route route(DeviceId src, DeviceId dest)
+  [[nodiscard]] Route construct_route(DeviceId src, DeviceId dest)
       const noexcept override;
 
  private:
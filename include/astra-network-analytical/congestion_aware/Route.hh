@@ -0,0 +1,166 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "common/Type.hh"
+#include "congestion_aware/Type.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Route is the sequence of devices a chunk traverses,
+ * including the src and dest devices themselves.
+ *
+ * Devices are kept as DeviceIds, resolved through the device table
+ * of the topology that constructed the route, each with the index of
+ * the link towards the next device among the links of that device.
+ * Short routes are stored inline; longer ones are stored in a buffer
+ * shared by every copy, so routes are copied into chunks without
+ * duplicating their devices.
+ * Routes handed out by a RoutingTable borrow the buffer of the cached route
+ * instead (see borrow()), so copying them doesn't touch a reference count.
+ * A route is immutable once copied: the hop cursor lives in the Chunk.
+ */
+class Route {
+ public:
+  /**
+   * Device of the route, with its link towards the next device.
+   */
+  struct Hop {
+    /// id of the device
+    DeviceId device_id;
+
+    /// index of the link to the next device among the links of the device,
+    /// -1 if not resolved (e.g., the dest device)
+    int link_index;
+  };
+
+  /// number of hops stored inline
+  static constexpr int inline_capacity = 6;
+
+  /**
+   * Constructor of an empty route.
+   */
+  Route() noexcept;
+
+  /**
+   * Constructor of an empty route over a device table.
+   *
+   * @param devices device table of the topology, indexed by DeviceId
+   */
+  explicit Route(const std::shared_ptr<Device>* devices) noexcept;
+
+  /**
+   * Append a device to the end of the route.
+   *
+   * @param device_id id of the device
+   */
+  void push_back(DeviceId device_id) noexcept;
+
+  /**
+   * Get the number of devices in the route.
+   *
+   * @return number of devices in the route
+   */
+  [[nodiscard]] int size() const noexcept;
+
+  /**
+   * Check whether the route is empty.
+   *
+   * @return true if the route is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Get the id of the device at the given hop.
+   *
+   * @param hop index of the device in the route
+   * @return id of the device
+   */
+  [[nodiscard]] DeviceId operator[](int hop) const noexcept;
+
+  /**
+   * Get the index of the link from the device at the given hop
+   * towards the next device, among the links of the device.
+   *
+   * @param hop index of the device in the route
+   * @return index of the link, -1 if not resolved
+   */
+  [[nodiscard]] int link_index(int hop) const noexcept;
+
+  /**
+   * Set the index of the link from the device at the given hop
+   * towards the next device.
+   *
+   * @param hop index of the device in the route
+   * @param link_index index of the link among the links of the device
+   */
+  void set_link_index(int hop, int link_index) noexcept;
+
+  /**
+   * Get the device at the given hop.
+   *
+   * @param hop index of the device in the route
+   * @return pointer to the device
+   */
+  [[nodiscard]] Device* device(int hop) const noexcept;
+
+  /**
+   * Get the hops of the route.
+   * Copies of a route longer than inline_capacity share this buffer.
+   *
+   * @return pointer to the first hop
+   */
+  [[nodiscard]] const Hop* data() const noexcept;
+
+  /**
+   * Get a copy of the route borrowing the buffer of a long route,
+   * rather than sharing its ownership,
+   * so the copy and its own copies never touch the reference count.
+   * The route should outlive the copies, e.g., a route cached by
+   * the RoutingTable, which outlives the chunks of its topology.
+   *
+   * @return copy of the route
+   */
+  [[nodiscard]] Route borrow() const noexcept;
+
+  /**
+   * Check whether the route borrows the buffer of another route.
+   *
+   * @return true if the route is borrowed, false otherwise
+   */
+  [[nodiscard]] bool is_borrowed() const noexcept;
+
+ private:
+  /// device table of the topology, indexed by DeviceId
+  const std::shared_ptr<Device>* devices;
+
+  /// number of devices in the route
+  int length;
+
+  /// hops of a route up to inline_capacity devices
+  Hop inline_hops[inline_capacity];
+
+  /// hops of a longer route, shared by the copies
+  std::shared_ptr<std::vector<Hop>> shared_hops;
+
+  /// hops of a longer route borrowed from another route, nullptr if owned
+  const Hop* borrowed_hops;
+
+  /**
+   * Get the hops of the route for modification,
+   * copying the buffer first if it's shared with other copies or borrowed.
+   *
+   * @return pointer to the first hop
+   */
+  [[nodiscard]] Hop* mutable_data() noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
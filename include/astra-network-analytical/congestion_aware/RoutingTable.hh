@@ -0,0 +1,118 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "common/Type.hh"
+#include "congestion_aware/Route.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * RoutingTable caches the routes of a topology, keyed by (src, dest).
+ *
+ * Routes are kept in one row per src NPU, allocated on the first route
+ * stored from that src, so a lookup is two array accesses.
+ * Cached routes are immutable: copies handed out share their storage.
+ * Rows and route buffers are accounted against a memory cap;
+ * routes that don't fit are simply not cached.
+ *
+ * Routes of distinct src NPUs can be stored concurrently.
+ */
+class RoutingTable {
+ public:
+  /// default memory cap of the routing table in bytes
+  static constexpr size_t default_capacity_bytes = size_t{256} * 1024 * 1024;
+
+  /**
+   * Constructor.
+   */
+  RoutingTable() noexcept;
+
+  /**
+   * Drop every cached route and size the table for the given NPUs.
+   *
+   * @param npus_count number of NPUs of the topology
+   */
+  void reset(int npus_count) noexcept;
+
+  /**
+   * Get the number of NPUs the table is sized for.
+   *
+   * @return number of NPUs, 0 if the table is not sized yet
+   */
+  [[nodiscard]] int get_npus_count() const noexcept;
+
+  /**
+   * Look up the cached route from src to dest.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @return pointer to the cached route, nullptr if not cached
+   */
+  [[nodiscard]] const Route* find(DeviceId src, DeviceId dest) const noexcept;
+
+  /**
+   * Cache the route from src to dest, if it fits into the memory cap.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param route route from src to dest
+   * @return true if the route is cached, false otherwise
+   */
+  bool store(DeviceId src, DeviceId dest, const Route& route) noexcept;
+
+  /**
+   * Set the memory cap of the table.
+   * Already cached routes are kept.
+   *
+   * @param capacity_bytes memory cap in bytes
+   */
+  void set_capacity_bytes(size_t capacity_bytes) noexcept;
+
+  /**
+   * Get the memory cap of the table.
+   *
+   * @return memory cap in bytes
+   */
+  [[nodiscard]] size_t get_capacity_bytes() const noexcept;
+
+  /**
+   * Get the memory used by the cached routes.
+   *
+   * @return used memory in bytes
+   */
+  [[nodiscard]] size_t get_used_bytes() const noexcept;
+
+ private:
+  /// number of NPUs the table is sized for
+  int npus_count;
+
+  /// cached routes, rows[src][dest]
+  /// an empty route marks an uncached (src, dest) pair
+  std::vector<std::unique_ptr<Route[]>> rows;
+
+  /// memory cap in bytes
+  size_t capacity_bytes;
+
+  /// memory used by the rows and the route buffers in bytes
+  std::atomic<size_t> used_bytes;
+
+  /**
+   * Account the given bytes against the memory cap.
+   *
+   * @param bytes bytes to account
+   * @return true if the bytes fit into the cap, false otherwise
+   */
+  bool reserve_bytes(size_t bytes) noexcept;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
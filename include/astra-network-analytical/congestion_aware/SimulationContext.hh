@@ -0,0 +1,86 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include "common/EventQueue.hh"
+#include "common/NetworkParser.hh"
+#include "common/Type.hh"
+#include "congestion_aware/Topology.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * SimulationContext owns everything a single simulation needs:
+ * its event queue and its topology (including devices and links).
+ *
+ * Links reach the event queue of their own context,
+ * so independent contexts can run concurrently on different threads.
+ */
+class SimulationContext {
+ public:
+  /**
+   * Constructor, building the topology from a NetworkParser.
+   *
+   * @param network_parser NetworkParser to parse the network input file
+   */
+  explicit SimulationContext(const NetworkParser& network_parser) noexcept;
+
+  /**
+   * Constructor, taking over an already constructed topology.
+   * The topology shouldn't be used by any other context.
+   *
+   * @param topology topology to simulate
+   */
+  explicit SimulationContext(std::shared_ptr<Topology> topology) noexcept;
+
+  /**
+   * Get the event queue of the simulation.
+   *
+   * @return pointer to the event queue
+   */
+  [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
+
+  /**
+   * Get the chunk pool of the simulation.
+   *
+   * @return pointer to the chunk pool
+   */
+  [[nodiscard]] std::shared_ptr<ChunkPool> get_chunk_pool() const noexcept;
+
+  /**
+   * Get the topology of the simulation.
+   *
+   * @return pointer to the topology
+   */
+  [[nodiscard]] std::shared_ptr<Topology> get_topology() const noexcept;
+
+  /**
+   * Get the current time of the simulation.
+   *
+   * @return current event time
+   */
+  [[nodiscard]] EventTime get_current_time() const noexcept;
+
+  /**
+   * Run the simulation until every event is invoked.
+   */
+  void run() noexcept;
+
+ private:
+  /// event queue of the simulation
+  std::shared_ptr<EventQueue> event_queue;
+
+  /// chunk pool of the simulation, recycling the chunks of make_chunk()
+  std::shared_ptr<ChunkPool> chunk_pool;
+
+  /// topology of the simulation, owning devices and links
+  std::shared_ptr<Topology> topology;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
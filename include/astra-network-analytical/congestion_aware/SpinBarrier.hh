@@ -0,0 +1,42 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * SpinBarrier blocks a fixed number of threads until all of them arrive.
+ * Waiting threads spin for a short while and then yield,
+ * as partitions synchronize at every lookahead window.
+ */
+class SpinBarrier {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param threads_count number of threads synchronizing on the barrier
+   */
+  explicit SpinBarrier(int threads_count) noexcept;
+
+  /**
+   * Block until all threads arrive at the barrier.
+   */
+  void wait() noexcept;
+
+ private:
+  /// number of threads synchronizing on the barrier
+  int threads_count;
+
+  /// number of threads yet to arrive in the current phase
+  std::atomic<int> waiting_count;
+
+  /// phase of the barrier, incremented when all threads arrive
+  std::atomic<int> phase;
+};
+
+} // namespace NetworkAnalyticalCongestionAware
@@ -40,9 +40,9 @@ class Switch final : public BasicTopology {
   Switch(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
   /**
-   * Implementation of route function in Topology.
+   * Implementation of construct_route function in Topology.
    */
-  [[nodiscard]] Route route(DeviceId src, DeviceId dest)
+  [[nodiscard]] Route construct_route(DeviceId src, DeviceId dest)
       const noexcept override;
 
  private:
@@ -5,11 +5,15 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "common/EventQueue.hh"
 #include "congestion_aware/Chunk.hh"
+#include "congestion_aware/ChunkPool.hh"
 #include "congestion_aware/Device.hh"
+#include "congestion_aware/Link.hh"
+#include "congestion_aware/RoutingTable.hh"
 
 using namespace NetworkAnalytical;
 
@@ -21,7 +25,10 @@ namespace NetworkAnalyticalCongestionAware {
 class Topology {
  public:
   /**
-   * Set the event queue to be used by the topology.
+   * Set the default event queue,
+   * used by the topologies constructed afterwards.
+   * Kept for compatibility: to run multiple simulations in one process,
+   * give each topology its own event queue (see SimulationContext).
    *
    * @param event_queue pointer to the event queue
    */
@@ -33,20 +40,165 @@ class Topology {
   Topology() noexcept;
 
   /**
-   * Construct the route from src to dest.
-   * Route is a list of devices (pointers) that the chunk should traverse,
+   * Use the given event queue for every link of this topology.
+   *
+   * @param event_queue pointer to the event queue
+   */
+  void bind_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
+
+  /**
+   * Get the event queue used by this topology.
+   *
+   * @return pointer to the event queue
+   */
+  [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
+
+  /**
+   * Use the given chunk pool for the chunks created by make_chunk().
+   *
+   * @param chunk_pool pointer to the chunk pool
+   */
+  void bind_chunk_pool(std::shared_ptr<ChunkPool> chunk_pool) noexcept;
+
+  /**
+   * Get the chunk pool used by this topology.
+   *
+   * @return pointer to the chunk pool
+   */
+  [[nodiscard]] std::shared_ptr<ChunkPool> get_chunk_pool() const noexcept;
+
+  /**
+   * Mark whether a ParallelSimulation partitions the links of this topology.
+   * Invoked by ParallelSimulation.
+   *
+   * @param partitioned true if the links are partitioned, false otherwise
+   */
+  void set_partitioned(bool partitioned) noexcept;
+
+  /**
+   * Check whether a ParallelSimulation partitions the links of this topology.
+   *
+   * @return true if the links are partitioned, false otherwise
+   */
+  [[nodiscard]] bool is_partitioned() const noexcept;
+
+  /**
+   * Create a chunk recycled through the chunk pool of this topology.
+   * While the topology is partitioned, chunks are created and destroyed
+   * on the worker threads, so they're allocated unpooled instead.
+   *
+   * @param chunk_size size of the chunk
+   * @param route route of the chunk from its source to destination
+   * @param callback callback to be invoked when the chunk arrives destination
+   * @param callback_arg argument of the callback
+   * @return created chunk
+   */
+  [[nodiscard]] std::unique_ptr<Chunk> make_chunk(
+      ChunkSize chunk_size,
+      Route route,
+      Callback callback,
+      CallbackArg callback_arg) const noexcept;
+
+  /**
+   * Create a chunk recycled through the chunk pool of this topology,
+   * with a callback capturing a few words inline.
+   *
+   * @param chunk_size size of the chunk
+   * @param route route of the chunk from its source to destination
+   * @param callback callback to be invoked when the chunk arrives destination
+   * @return created chunk
+   */
+  [[nodiscard]] std::unique_ptr<Chunk> make_chunk(
+      ChunkSize chunk_size,
+      Route route,
+      InlineCallback callback) const noexcept;
+
+  /**
+   * Get the route from src to dest.
+   * Route is a sequence of devices (ids) that the chunk should traverse,
    * including the src and dest devices themselves.
    *
    * e.g., route(0, 3) = [0, 5, 7, 2, 3]
    *
+   * Routes are cached in the routing table of the topology,
+   * and the returned routes borrow the cached storage (see Route::borrow()),
+   * so repeated calls and copies into chunks share it without refcounting.
+   * Not thread-safe: don't call concurrently on the same topology,
+   * except while partitioned, when the routing table is only read
+   * (routes not cached yet are constructed, but neither cached nor counted).
+   *
    * @param src src NPU id
    * @param dest dest NPU id
    *
    * @return route from src NPU to dest NPU
    */
-  [[nodiscard]] virtual Route route(DeviceId src, DeviceId dest)
+  [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept;
+
+  /**
+   * Construct the route from src to dest, bypassing the routing table.
+   * Implemented by each topology; route() caches the result.
+   * Safe to call concurrently.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   *
+   * @return route from src NPU to dest NPU
+   */
+  [[nodiscard]] virtual Route construct_route(DeviceId src, DeviceId dest)
       const noexcept = 0;
 
+  /**
+   * Eagerly fill the routing table with the routes of every NPU pair,
+   * up to its memory cap.
+   *
+   * @param threads_count number of threads constructing the routes
+   */
+  void build_routing_table(int threads_count = 1) noexcept;
+
+  /**
+   * Set the memory cap of the routing table.
+   *
+   * @param capacity_bytes memory cap in bytes
+   */
+  void set_routing_table_capacity(size_t capacity_bytes) noexcept;
+
+  /**
+   * Get the routing table of the topology.
+   *
+   * @return routing table
+   */
+  [[nodiscard]] const RoutingTable& get_routing_table() const noexcept;
+
+  /**
+   * Get the number of route() calls served by the routing table.
+   *
+   * @return number of routing table hits
+   */
+  [[nodiscard]] uint64_t get_route_hits_count() const noexcept;
+
+  /**
+   * Get the number of route() calls that constructed the route.
+   *
+   * @return number of routing table misses
+   */
+  [[nodiscard]] uint64_t get_route_misses_count() const noexcept;
+
+  /**
+   * Set how the chunks sent afterwards are congested.
+   * Only the hop-by-hop model is supported by ParallelSimulation.
+   * Chunks of different models shouldn't be in flight at once.
+   *
+   * @param congestion_model congestion model
+   */
+  void set_congestion_model(CongestionModel congestion_model) noexcept;
+
+  /**
+   * Get how the chunks sent are congested.
+   *
+   * @return congestion model
+   */
+  [[nodiscard]] CongestionModel get_congestion_model() const noexcept;
+
   /**
    * Initiate a transmission of a chunk.
    *
@@ -54,6 +206,79 @@ class Topology {
    */
   void send(std::unique_ptr<Chunk> chunk) noexcept;
 
+  /**
+   * Initiate the transmission of a batch of chunks at once,
+   * invoking the callback with the tag of each chunk when it arrives.
+   * Chunks of the same (src, dest) as the previous one share its route,
+   * and each chunk is sent as send() does,
+   * so it arrives as if the chunks were sent one by one.
+   * Not supported while a ParallelSimulation partitions the topology.
+   *
+   * @param descriptors chunks to be transmitted
+   * @param descriptors_count number of chunks
+   * @param callback callback to be invoked when each chunk arrives dest
+   * @param callback_arg argument of the callback
+   */
+  void send_batch(
+      const ChunkDescriptor* descriptors,
+      size_t descriptors_count,
+      TaggedCallback callback,
+      CallbackArg callback_arg) noexcept;
+
+  /**
+   * Initiate the transmission of a batch of chunks at once,
+   * invoking the callback once, when every chunk of the batch arrived.
+   * Tags of the chunks are ignored.
+   * Not supported while a ParallelSimulation partitions the topology.
+   *
+   * @param descriptors chunks to be transmitted
+   * @param descriptors_count number of chunks
+   * @param callback callback to be invoked when the whole batch arrived
+   */
+  void send_batch(
+      const ChunkDescriptor* descriptors,
+      size_t descriptors_count,
+      InlineCallback callback) noexcept;
+
+  /**
+   * Send a message from src to dest, split into chunks of chunk_size
+   * (the last chunk holds the remainder).
+   * The chunks are injected at once and pipelined over the route,
+   * and the callback is invoked once, when the last chunk arrived.
+   * Not supported while a ParallelSimulation partitions the topology.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param message_size size of the message
+   * @param chunk_size size of each chunk
+   * @param callback callback to be invoked when the whole message arrived
+   */
+  void send_message(
+      DeviceId src,
+      DeviceId dest,
+      ChunkSize message_size,
+      ChunkSize chunk_size,
+      InlineCallback callback) noexcept;
+
+  /**
+   * Send a message from src to dest, split into chunks_count chunks
+   * of (nearly) equal size, pipelined over the route.
+   * A message smaller than chunks_count bytes is sent in 1-byte chunks.
+   * Not supported while a ParallelSimulation partitions the topology.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param message_size size of the message
+   * @param chunks_count number of chunks
+   * @param callback callback to be invoked when the whole message arrived
+   */
+  void send_message_in_chunks(
+      DeviceId src,
+      DeviceId dest,
+      ChunkSize message_size,
+      int chunks_count,
+      InlineCallback callback) noexcept;
+
   /**
    * Get the number of NPUs in the topology.
    * NPU excludes non-NPU devices such as switches.
@@ -70,6 +295,32 @@ class Topology {
    */
   [[nodiscard]] int get_devices_count() const noexcept;
 
+  /**
+   * Get a device of the topology.
+   *
+   * @param id id of the device
+   * @return device of the given id
+   */
+  [[nodiscard]] std::shared_ptr<Device> get_device(DeviceId id) const noexcept;
+
+  /**
+   * Get the number of links in the topology.
+   *
+   * @return number of links in the topology
+   */
+  [[nodiscard]] int get_links_count() const noexcept;
+
+  /**
+   * Get the id of a link, unique within the topology.
+   * Ids are dense in [0, get_links_count()), in CSR order.
+   *
+   * @param device_id id of the src device of the link
+   * @param link_index index of the link among the links of the device
+   * @return id of the link
+   */
+  [[nodiscard]] int get_link_id(DeviceId device_id, int link_index)
+      const noexcept;
+
   /**
    * Get the number of network dimensions.
    *
@@ -92,6 +343,13 @@ class Topology {
   [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
 
  protected:
+  /// event queue used by the links of this topology
+  std::shared_ptr<EventQueue> event_queue;
+
+  /// chunk pool of the chunks created by make_chunk(),
+  /// outliving the links holding pending chunks
+  std::shared_ptr<ChunkPool> chunk_pool;
+
   /// number of total devices in the topology
   /// device includes non-NPU devices such as switches
   int devices_count;
@@ -109,6 +367,16 @@ class Topology {
   /// holds the entire device instances in the topology
   std::vector<std::shared_ptr<Device>> devices;
 
+  /// holds the entire link instances in the topology,
+  /// grouped by src device and sorted by dest device (CSR order)
+  std::vector<Link> links;
+
+  /// links of device i are [link_offsets[i], link_offsets[i + 1])
+  std::vector<int> link_offsets;
+
+  /// dest device id of each link
+  std::vector<DeviceId> link_dests;
+
   /// bandwidth per each network dimension
   std::vector<Bandwidth> bandwidth_per_dim;
 
@@ -119,7 +387,8 @@ class Topology {
 
   /**
    * Connect src -> dest with the given bandwidth and latency.
-   * (i.e., a `Link` gets constructed between the two npus)
+   * (i.e., a `Link` gets constructed between the two npus
+   * once build_adjacency() is invoked)
    *
    * if bidirectional=true, dest -> src connection is also established.
    *
@@ -135,6 +404,123 @@ class Topology {
       Bandwidth bandwidth,
       Latency latency,
       bool bidirectional = true) noexcept;
+
+  /**
+   * Construct the links of every connection into one contiguous array
+   * and index them per device (compressed sparse row).
+   * Should be invoked once, after every connect() call.
+   */
+  void build_adjacency() noexcept;
+
+ private:
+  /**
+   * Connection registered by connect(), before build_adjacency().
+   */
+  struct Connection {
+    /// src device id
+    DeviceId src;
+
+    /// dest device id
+    DeviceId dest;
+
+    /// bandwidth of the link
+    Bandwidth bandwidth;
+
+    /// latency of the link
+    Latency latency;
+  };
+
+  /// default event queue of the topologies constructed afterwards
+  static std::shared_ptr<EventQueue> default_event_queue;
+
+  /// connections to be constructed by build_adjacency()
+  std::vector<Connection> connections;
+
+  /// how the chunks sent are congested
+  CongestionModel congestion_model;
+
+  /// whether a ParallelSimulation partitions the links
+  bool partitioned;
+
+  /// cached routes, keyed by (src, dest)
+  mutable RoutingTable routing_table;
+
+  /// number of route() calls served by the routing table
+  mutable uint64_t route_hits_count;
+
+  /// number of route() calls that constructed the route
+  mutable uint64_t route_misses_count;
+
+  /// completion records of the batches in flight
+  Arena batch_arena;
+
+  /// chunks of the message being sent
+  std::vector<ChunkDescriptor> message_chunks;
+
+  /**
+   * Reserve every link on the route of a chunk, in order,
+   * and schedule its arrival at the dest.
+   *
+   * @param chunk chunk to be transmitted
+   */
+  void reserve_route(std::unique_ptr<Chunk> chunk) noexcept;
+
+  /**
+   * Check whether every link on the route of a chunk is idle
+   * when the chunk would reach it without contention (hybrid model).
+   *
+   * @param chunk chunk to be transmitted, at its src
+   * @return true if the chunk wouldn't wait at any link, false otherwise
+   */
+  [[nodiscard]] bool route_is_idle(const Chunk& chunk) const noexcept;
+
+  /**
+   * Register a chunk queued hop by hop on every link of its route
+   * (hybrid model), so idle routes don't reserve the links ahead of it.
+   *
+   * @param chunk chunk to be transmitted, at its src
+   */
+  void add_incoming_chunk(const Chunk& chunk) noexcept;
+
+  /**
+   * Reserve every link on the route of a chunk, in order,
+   * moving the chunk to the device right before its dest.
+   *
+   * @param chunk chunk to be transmitted
+   * @return time the chunk arrives at the dest
+   */
+  EventTime reserve_links(Chunk& chunk) noexcept;
+
+  /**
+   * Create the chunks of a batch from the chunk pool and send them.
+   *
+   * @tparam MakeCallback type of the callable creating chunk callbacks
+   * @param descriptors chunks to be transmitted
+   * @param descriptors_count number of chunks
+   * @param make_callback callable returning the callback of a descriptor
+   */
+  template <typename MakeCallback>
+  void send_chunks(
+      const ChunkDescriptor* descriptors,
+      size_t descriptors_count,
+      MakeCallback make_callback) noexcept;
+
+  /**
+   * Size the routing table for the NPUs of the topology, if not yet.
+   */
+  void prepare_routing_table() const noexcept;
+
+  /**
+   * Construct the route from src to dest,
+   * resolving the link of each hop.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   *
+   * @return route from src NPU to dest NPU
+   */
+  [[nodiscard]] Route construct_resolved_route(DeviceId src, DeviceId dest)
+      const noexcept;
 };
 
 } // namespace NetworkAnalyticalCongestionAware
@@ -5,8 +5,8 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
-#include <list>
-#include <memory>
+#include <cstdint>
+#include "common/Type.hh"
 
 namespace NetworkAnalyticalCongestionAware {
 
@@ -14,8 +14,39 @@ namespace NetworkAnalyticalCongestionAware {
 class Chunk;
 class Link;
 class Device;
+class Partition;
+class Route;
 
-/// Route is a list of devices
-using Route = std::list<std::shared_ptr<Device>>;
+/// How a topology models the congestion of the chunks it sends
+///   - HopByHop: chunks are queued at each link when they arrive at it,
+///     one arrival event per hop
+///   - Reservation: the slots of every link on the route are reserved
+///     when the chunk is sent, one arrival event at the dest
+///   - Hybrid: chunks whose route is idle are reserved as in Reservation,
+///     taking the contention-free delay with one arrival event;
+///     the others are queued at each link when they arrive at it,
+///     into the same reserved slots
+enum class CongestionModel { HopByHop, Reservation, Hybrid };
+
+/// Callback of a chunk sent in a batch, given the tag of the chunk:
+/// "void func(void* arg, uint64_t tag)"
+using TaggedCallback = void (*)(NetworkAnalytical::CallbackArg, uint64_t);
+
+/**
+ * Descriptor of a chunk sent by Topology::send_batch().
+ */
+struct ChunkDescriptor {
+  /// src NPU id
+  NetworkAnalytical::DeviceId src;
+
+  /// dest NPU id
+  NetworkAnalytical::DeviceId dest;
+
+  /// size of the chunk
+  NetworkAnalytical::ChunkSize chunk_size;
+
+  /// tag passed to the callback when the chunk arrives at the dest
+  uint64_t tag;
+};
 
 } // namespace NetworkAnalyticalCongestionAware
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstddef>
 #include "common/Type.hh"
 #include "congestion_unaware/Topology.hh"
 
@@ -49,6 +50,78 @@ class BasicTopology : public Topology {
    */
   [[nodiscard]] TopologyBuildingBlock get_basic_topology_type() const noexcept;
 
+  /**
+   * Get the latency of each link in the topology.
+   *
+   * @return latency of each link in ns
+   */
+  [[nodiscard]] Latency get_latency() const noexcept;
+
+  /**
+   * Estimate the time to be taken by one phase of a collective
+   * among the NPUs of this topology.
+   *
+   * @param type Reduce-Scatter, All-Gather, All-to-All, or Broadcast
+   * @param algorithm algorithm of the phase
+   * @param size size of the data of each NPU:
+   *     before the phase for Reduce-Scatter, after the phase for All-Gather
+   * @return time to run the phase
+   */
+  [[nodiscard]] EventTime compute_phase_time(
+      CollectiveType type,
+      CollectiveAlgorithm algorithm,
+      ChunkSize size) const noexcept;
+
+  /**
+   * Get the default collective algorithm of the topology:
+   * Ring for Ring, Direct for FullyConnected and Switch.
+   *
+   * @return default collective algorithm
+   */
+  [[nodiscard]] CollectiveAlgorithm get_default_collective_algorithm()
+      const noexcept;
+
+  /**
+   * Analytically compute the communication delay.
+   *
+   * @param hops_count number of hops between src and dest
+   * @param chunk_size size of the chunk
+   * @return communication delay to send a chunk between src and dest
+   */
+  [[nodiscard]] EventTime compute_communication_delay(
+      int hops_count,
+      ChunkSize chunk_size) const noexcept;
+
+  /**
+   * Analytically compute the communication delay under load:
+   * every hop also waits for the queue of its link.
+   *
+   * @param hops_count number of hops between src and dest
+   * @param chunk_size size of the chunk
+   * @param queueing_factor mean wait per hop,
+   *     in units of the serialization delay of the chunk
+   * @return communication delay to send a chunk between src and dest
+   */
+  [[nodiscard]] EventTime compute_loaded_communication_delay(
+      int hops_count,
+      ChunkSize chunk_size,
+      double queueing_factor) const noexcept;
+
+  /**
+   * Compute the number of unidirectional links of the topology.
+   *
+   * @return number of links
+   */
+  [[nodiscard]] virtual int compute_links_count() const noexcept = 0;
+
+  /**
+   * Precompute the delay table of the topology, if it fits,
+   * as it serves a dimension of a MultiDimTopology.
+   * send() itself computes the hops count, cheaper than a table load,
+   * so a standalone building block never builds its N^2 table.
+   */
+  void enable_delay_table() noexcept;
+
  protected:
   /**
    * Compute the number of hops between src and dest.
@@ -60,19 +133,80 @@ class BasicTopology : public Topology {
   [[nodiscard]] virtual int compute_hops_count(DeviceId src, DeviceId dest)
       const noexcept = 0;
 
+  /**
+   * Compute the largest number of hops between two NPUs.
+   *
+   * @return number of hops between the farthest NPUs
+   */
+  [[nodiscard]] virtual int compute_max_hops_count() const noexcept = 0;
+
+  /**
+   * Compute the communication delay of each query of a batch
+   * in one tight loop, for the send_batch() of each building block.
+   *
+   * @tparam HopsCount callable computing the hops count of (src, dest),
+   *     inlined into the loop
+   * @param hops_count hops count of the building block
+   * @param srcs src NPU ID of each query
+   * @param dests dest NPU ID of each query
+   * @param chunk_sizes size of the chunk of each query
+   * @param delays communication delay of each query, written back
+   * @param queries_count number of queries
+   */
+  template <typename HopsCount>
+  void compute_communication_delays(
+      HopsCount hops_count,
+      const DeviceId* srcs,
+      const DeviceId* dests,
+      const ChunkSize* chunk_sizes,
+      EventTime* delays,
+      size_t queries_count) const noexcept;
+
+  /**
+   * Implement the compute_hops_count_per_dim method of Topology.
+   */
+  void compute_hops_count_per_dim(
+      DeviceId src,
+      DeviceId dest,
+      int* hops_count_per_dim) const noexcept override;
+
+  /**
+   * Implement the get_basic_topology method of Topology.
+   */
+  [[nodiscard]] const BasicTopology& get_basic_topology(
+      int dim) const noexcept override;
+
+  /**
+   * Implement the build_delay_table method of Topology:
+   * one delay class per hops count.
+   * Builds nothing until enable_delay_table() is invoked.
+   */
+  void build_delay_table() noexcept override;
+
   /// type of the basic topology
   TopologyBuildingBlock basic_topology_type;
 
  private:
   /**
-   * Analytically compute the communication delay.
+   * Compute the time of a step sending a chunk to the NPU at a distance.
+   * Every NPU is alike, so NPU 0 stands for the senders of the step.
    *
-   * @param hops_count number of hops between src and dest
+   * @param distance distance between the src and dest NPU ids
    * @param chunk_size size of the chunk
-   * @return communication delay to send a chunk between src and dest
+   * @return time of the step
    */
-  [[nodiscard]] EventTime compute_communication_delay(
-      int hops_count,
+  [[nodiscard]] EventTime compute_step_time(
+      int distance,
+      ChunkSize chunk_size) const noexcept;
+
+  /**
+   * Compute the time of a step sending a chunk to every other NPU,
+   * bounded by the farthest NPU.
+   *
+   * @param chunk_size size of the chunk
+   * @return time of the step
+   */
+  [[nodiscard]] EventTime compute_direct_step_time(
       ChunkSize chunk_size) const noexcept;
 
   /// bandwidth of each link in GB/s
@@ -83,6 +217,36 @@ class BasicTopology : public Topology {
 
   /// latency of each link in ns
   Latency latency;
+
+  /// whether the delay table is built, i.e., serves a MultiDimTopology
+  bool delay_table_enabled;
 };
 
+template <typename HopsCount>
+void BasicTopology::compute_communication_delays(
+    const HopsCount hops_count,
+    const DeviceId* const srcs,
+    const DeviceId* const dests,
+    const ChunkSize* const chunk_sizes,
+    EventTime* const delays,
+    const size_t queries_count) const noexcept {
+  // load-aware: same arithmetic as compute_loaded_communication_delay()
+  if (!queueing_factor_per_dim.empty()) {
+    const auto queueing_factor = queueing_factor_per_dim[0];
+    for (auto i = size_t{0}; i < queries_count; i++) {
+      delays[i] = compute_loaded_communication_delay(
+          hops_count(srcs[i], dests[i]), chunk_sizes[i], queueing_factor);
+    }
+    return;
+  }
+
+  // same arithmetic as compute_communication_delay(), branch-free
+  for (auto i = size_t{0}; i < queries_count; i++) {
+    const auto link_delay = hops_count(srcs[i], dests[i]) * latency;
+    const auto serialization_delay =
+        static_cast<double>(chunk_sizes[i]) / bandwidth_Bpns;
+    delays[i] = static_cast<EventTime>(link_delay + serialization_delay);
+  }
+}
+
 } // namespace NetworkAnalyticalCongestionUnaware
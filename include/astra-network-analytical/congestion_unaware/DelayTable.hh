@@ -0,0 +1,162 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/Type.hh"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * DelayTable precomputes the communication delay model of every NPU pair
+ * of a congestion-unaware topology.
+ *
+ * The delay of a pair only depends on its (dimension, hops count),
+ * so pairs are mapped to a few delay classes,
+ * each folding hops count * latency into one constant:
+ * a lookup is one 2-byte table load, then latency + size / bandwidth.
+ * The N^2 class ids are accounted against a memory cap;
+ * a table that doesn't fit is left empty.
+ */
+class DelayTable {
+ public:
+  /**
+   * Delay model shared by the NPU pairs of the same (dim, hops count).
+   */
+  struct DelayClass {
+    /// hops count * latency of the dim
+    Latency link_delay;
+
+    /// bandwidth of the dim in B/ns
+    Bandwidth bandwidth_Bpns;
+  };
+
+  /// default memory cap of the delay table in bytes
+  static constexpr size_t default_capacity_bytes = size_t{64} * 1024 * 1024;
+
+  /**
+   * Constructor.
+   */
+  DelayTable() noexcept;
+
+  /**
+   * Drop the table and size it for the given NPUs and delay classes,
+   * if it fits into the memory cap.
+   * Every pair is mapped to class 0 until stored.
+   *
+   * @param npus_count number of NPUs of the topology
+   * @param delay_classes delay model of each class id
+   * @return true if the table is sized, false if it's left empty
+   */
+  bool reset(int npus_count, std::vector<DelayClass> delay_classes) noexcept;
+
+  /**
+   * Drop the table.
+   */
+  void clear() noexcept;
+
+  /**
+   * Check whether the table is empty, i.e., not sized.
+   *
+   * @return true if the table is empty, false otherwise
+   */
+  [[nodiscard]] bool empty() const noexcept;
+
+  /**
+   * Map the pair (src, dest) to a delay class.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param class_id id of the delay class
+   */
+  void store(DeviceId src, DeviceId dest, int class_id) noexcept;
+
+  /**
+   * Get the delay class id of the pair (src, dest).
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @return id of the delay class
+   */
+  [[nodiscard]] int get_class_id(DeviceId src, DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    return class_ids[(static_cast<size_t>(src) * npus_count) + dest];
+  }
+
+  /**
+   * Get the delay classes of the table.
+   *
+   * @return delay model of each class id
+   */
+  [[nodiscard]] const std::vector<DelayClass>& get_delay_classes()
+      const noexcept;
+
+  /**
+   * Look up the time to send a chunk from src to dest.
+   * Same arithmetic as BasicTopology::send().
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param chunk_size size of the chunk
+   * @return communication delay
+   */
+  [[nodiscard]] EventTime lookup(
+      const DeviceId src,
+      const DeviceId dest,
+      const ChunkSize chunk_size) const noexcept {
+    assert(!empty());
+
+    const auto& delay_class = delay_classes[get_class_id(src, dest)];
+    const auto serialization_delay =
+        static_cast<double>(chunk_size) / delay_class.bandwidth_Bpns;
+    return static_cast<EventTime>(
+        delay_class.link_delay + serialization_delay);
+  }
+
+  /**
+   * Set the memory cap of the table.
+   * Takes effect on the next reset().
+   *
+   * @param capacity_bytes memory cap in bytes
+   */
+  void set_capacity_bytes(size_t capacity_bytes) noexcept;
+
+  /**
+   * Get the memory cap of the table.
+   *
+   * @return memory cap in bytes
+   */
+  [[nodiscard]] size_t get_capacity_bytes() const noexcept;
+
+  /**
+   * Get the memory used by the class ids of the table.
+   *
+   * @return used memory in bytes
+   */
+  [[nodiscard]] size_t get_used_bytes() const noexcept;
+
+ private:
+  /// number of NPUs the table is sized for, 0 if empty
+  int npus_count;
+
+  /// delay class id of each pair, class_ids[src * npus_count + dest]
+  std::vector<uint16_t> class_ids;
+
+  /// delay model of each class id
+  std::vector<DelayClass> delay_classes;
+
+  /// memory cap in bytes
+  size_t capacity_bytes;
+};
+
+} // namespace NetworkAnalyticalCongestionUnaware
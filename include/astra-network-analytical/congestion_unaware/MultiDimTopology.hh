@@ -5,7 +5,9 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <vector>
 #include "common/Type.hh"
 #include "congestion_unaware/BasicTopology.hh"
 #include "congestion_unaware/Topology.hh"
@@ -14,6 +16,15 @@ using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionUnaware {
 
+/// How a chunk crossing several dimensions is charged,
+/// routed in dimension order (0, 1, ...) through each differing dimension
+///   - FirstDim: only the first dimension where src and dest differ
+///   - StoreAndForward: each hop receives the whole chunk before forwarding,
+///     sum of hops * (latency + size / bandwidth) over the dimensions
+///   - Pipelined: the chunk streams through the hops,
+///     sum of hops * latency, plus size / the slowest bandwidth
+enum class PathCostModel { FirstDim, StoreAndForward, Pipelined };
+
 /**
  * MultiDimTopology implements multi-dimensional network topologies
  * which can be constructed by stacking up multiple BasicTopology instances.
@@ -33,6 +44,47 @@ class MultiDimTopology : public Topology {
       DeviceId dest,
       ChunkSize chunk_size) const noexcept override;
 
+  /**
+   * Implement the send_batch method of Topology.
+   * Queries are processed in blocks: the dimension of each query is found
+   * in one pass, then the queries of each dimension are gathered
+   * and sent as one batch to the BasicTopology of the dimension.
+   */
+  void send_batch(
+      const DeviceId* srcs,
+      const DeviceId* dests,
+      const ChunkSize* chunk_sizes,
+      EventTime* delays,
+      size_t queries_count) const noexcept override;
+
+  /**
+   * Estimate the time to send the chunks of a whole traffic matrix,
+   * translating each src NPU once per row.
+   *
+   * @param chunk_sizes size of the chunk of each (src, dest),
+   *     row-major npus_count x npus_count, 0 for no traffic
+   * @param delays time to send the chunk of each (src, dest),
+   *     0 for no traffic, written back
+   */
+  void send_traffic_matrix(const ChunkSize* chunk_sizes, EventTime* delays)
+      const noexcept;
+
+  /**
+   * Set how the chunks crossing several dimensions are charged.
+   * The delay tables only cover the first dimension,
+   * so the other models compute each send() in O(dims).
+   *
+   * @param path_cost_model path cost model
+   */
+  void set_path_cost_model(PathCostModel path_cost_model) noexcept;
+
+  /**
+   * Get how the chunks crossing several dimensions are charged.
+   *
+   * @return path cost model
+   */
+  [[nodiscard]] PathCostModel get_path_cost_model() const noexcept;
+
   /**
    * Add a dimension to the multi-dimensional topology.
    *
@@ -40,15 +92,91 @@ class MultiDimTopology : public Topology {
    */
   void append_dimension(std::unique_ptr<BasicTopology> basic_topology) noexcept;
 
+ protected:
+  /**
+   * Implement the get_basic_topology method of Topology.
+   */
+  [[nodiscard]] const BasicTopology& get_basic_topology(
+      int dim) const noexcept override;
+
+  /**
+   * Implement the build_delay_table method of Topology:
+   * the delay classes of every dimension, concatenated.
+   * If the N^2 table doesn't fit, send() falls back to
+   * the per-dimension tables of the BasicTopology instances.
+   */
+  void build_delay_table() noexcept override;
+
+  /**
+   * Implement the compute_hops_count_per_dim method of Topology,
+   * routed as the path cost model charges it.
+   */
+  void compute_hops_count_per_dim(
+      DeviceId src,
+      DeviceId dest,
+      int* hops_count_per_dim) const noexcept override;
+
  private:
+  /// maximum number of dimensions, bounding the size of an address
+  static constexpr int max_dims_count = 8;
+
   /// Each NPU ID can be broken down into multiple dimensions.
   /// for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
   /// then the NPU ID can be broken down into [1, 7, 1].
-  using MultiDimAddress = std::vector<DeviceId>;
+  /// Fixed-capacity, so addresses live on the stack.
+  using MultiDimAddress = std::array<DeviceId, max_dims_count>;
 
   /// BasicTopology instances per dimension.
   std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
 
+  /// mixed-radix stride of each dimension,
+  /// i.e., the number of NPUs of the dimensions below it
+  std::vector<int> stride_per_dim;
+
+  /// latency of each dimension in ns
+  std::vector<Latency> latency_per_dim;
+
+  /// bandwidth of each dimension in B/ns
+  std::vector<Bandwidth> bandwidth_Bpns_per_dim;
+
+  /// how the chunks crossing several dimensions are charged
+  PathCostModel path_cost_model;
+
+  /**
+   * Check whether send() can be served by the all-pairs delay table.
+   *
+   * @return true if the table is built and holds the delay send() charges
+   */
+  [[nodiscard]] bool uses_delay_table() const noexcept;
+
+  /**
+   * Send a chunk between two translated addresses,
+   * charged by the path cost model.
+   *
+   * @param src_address src NPU in multi-dimensional form
+   * @param dest_address dest NPU in multi-dimensional form
+   * @param chunk_size size of the chunk
+   * @return time to send the chunk
+   */
+  [[nodiscard]] EventTime send_addresses(
+      const MultiDimAddress& src_address,
+      const MultiDimAddress& dest_address,
+      ChunkSize chunk_size) const noexcept;
+
+  /**
+   * Compute the hops count within a dimension, dispatching on its
+   * building block instead of a virtual call.
+   *
+   * @param dim dimension of the transfer
+   * @param src_local_id src NPU ID within the dimension
+   * @param dest_local_id dest NPU ID within the dimension
+   * @return number of hops between src and dest within the dimension
+   */
+  [[nodiscard]] int compute_hops_count_on_dim(
+      int dim,
+      DeviceId src_local_id,
+      DeviceId dest_local_id) const noexcept;
+
   /**
    * Translate the NPU ID into a multi-dimensional address.
    *
@@ -38,12 +38,34 @@ class Switch final : public BasicTopology {
       Bandwidth bandwidth,
       Latency latency) noexcept;
 
- private:
+  /**
+   * Implements the send_batch method of Topology.
+   */
+  void send_batch(
+      const DeviceId* srcs,
+      const DeviceId* dests,
+      const ChunkSize* chunk_sizes,
+      EventTime* delays,
+      size_t queries_count) const noexcept override;
+
   /**
    * Implements the compute_hops_count method of BasicTopology.
+   * Public, so MultiDimTopology calls it on the final class,
+   * without virtual dispatch.
    */
   [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest)
       const noexcept override;
+
+ private:
+  /**
+   * Implements the compute_max_hops_count method of BasicTopology.
+   */
+  [[nodiscard]] int compute_max_hops_count() const noexcept override;
+
+  /**
+   * Implements the compute_links_count method of BasicTopology.
+   */
+  [[nodiscard]] int compute_links_count() const noexcept override;
 };
 
 } // namespace NetworkAnalyticalCongestionUnaware
@@ -5,13 +5,17 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include "common/Type.hh"
+#include "congestion_unaware/DelayTable.hh"
 
 using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionUnaware {
 
+class BasicTopology;
+
 /**
  * Abstracts a network topology.
  */
@@ -36,6 +40,127 @@ class Topology {
       DeviceId dest,
       ChunkSize chunk_size) const noexcept = 0;
 
+  /**
+   * Estimate the time to send each chunk of a batch of queries,
+   * as send() would, without allocation or virtual dispatch per query.
+   *
+   * @param srcs src NPU ID of each query
+   * @param dests dest NPU ID of each query
+   * @param chunk_sizes size of the chunk of each query
+   * @param delays time to send the chunk of each query, written back
+   * @param queries_count number of queries
+   */
+  virtual void send_batch(
+      const DeviceId* srcs,
+      const DeviceId* dests,
+      const ChunkSize* chunk_sizes,
+      EventTime* delays,
+      size_t queries_count) const noexcept = 0;
+
+  /**
+   * Estimate the time to be taken by a collective in closed form,
+   * in O(dims) instead of one send() per chunk.
+   *
+   * The collective is hierarchical, one phase per dimension,
+   * each running the algorithm of the dimension within its NPUs:
+   *   - Reduce-Scatter: dimensions 0, 1, ..., each on the scattered data
+   *   - All-Gather: dimensions ..., 1, 0, mirroring Reduce-Scatter
+   *   - All-Reduce: Reduce-Scatter, then All-Gather
+   *   - All-to-All and Broadcast: dimensions 0, 1, ... on the whole data
+   * The estimate equals the sum, over the steps of every phase,
+   * of the longest send() of the step.
+   *
+   * @param type collective communication pattern
+   * @param collective_size size of the data of each NPU in bytes:
+   *     the input for All-Reduce, Reduce-Scatter, All-to-All, and Broadcast,
+   *     the output for All-Gather
+   * @param algorithm_per_dim algorithm of the collective in each dimension
+   * @return time to run the collective
+   */
+  [[nodiscard]] EventTime collective_time(
+      CollectiveType type,
+      ChunkSize collective_size,
+      const std::vector<CollectiveAlgorithm>& algorithm_per_dim)
+      const noexcept;
+
+  /**
+   * Estimate the time to be taken by a collective in closed form,
+   * using the default algorithm of each dimension:
+   * Ring for Ring, Direct for FullyConnected and Switch.
+   *
+   * @param type collective communication pattern
+   * @param collective_size size of the data of each NPU in bytes
+   * @return time to run the collective
+   */
+  [[nodiscard]] EventTime collective_time(
+      CollectiveType type,
+      ChunkSize collective_size) const noexcept;
+
+  /**
+   * Register the link utilization of each dimension,
+   * switching send() and send_batch() to the load-aware mode.
+   *
+   * Each link class (dimension) is modeled as an M/D/1 queue:
+   * every hop of a chunk waits rho / (2 * (1 - rho)) times
+   * its serialization delay on the dimension, on average.
+   * Utilization is capped at max_utilization to keep the wait finite.
+   *
+   * @param utilization_per_dim offered load / capacity of the links
+   *     of each dimension, in [0, 1)
+   */
+  void set_utilization_per_dim(
+      const std::vector<double>& utilization_per_dim) noexcept;
+
+  /**
+   * Register an offered traffic matrix, switching send() and send_batch()
+   * to the load-aware mode.
+   * The bytes of each pair are routed as send() would
+   * and spread over the links of each dimension,
+   * giving the utilization of each dimension over the duration.
+   *
+   * @param chunk_sizes bytes offered by each (src, dest),
+   *     row-major npus_count x npus_count, 0 for no traffic
+   * @param duration time window the traffic is offered over, in ns
+   */
+  void set_traffic_matrix(
+      const ChunkSize* chunk_sizes,
+      EventTime duration) noexcept;
+
+  /**
+   * Drop the registered load, back to the congestion-unaware mode.
+   */
+  void clear_utilization() noexcept;
+
+  /**
+   * Check whether a load is registered.
+   *
+   * @return true if send() accounts for contention, false otherwise
+   */
+  [[nodiscard]] bool is_load_aware() const noexcept;
+
+  /**
+   * Get the registered link utilization of each dimension.
+   *
+   * @return capped utilization of each dimension, empty if not load-aware
+   */
+  [[nodiscard]] std::vector<double> get_utilization_per_dim() const noexcept;
+
+  /**
+   * Set the memory cap of the delay table and rebuild it
+   * (a BasicTopology builds its table only to serve a MultiDimTopology).
+   * A topology whose table doesn't fit computes the delay of each send().
+   *
+   * @param capacity_bytes memory cap in bytes
+   */
+  void set_delay_table_capacity(size_t capacity_bytes) noexcept;
+
+  /**
+   * Get the delay table of the topology.
+   *
+   * @return delay table, empty if it doesn't fit into its memory cap
+   */
+  [[nodiscard]] const DelayTable& get_delay_table() const noexcept;
+
   /**
    * Get the number of NPUs in the topology.
    *
@@ -64,6 +189,9 @@ class Topology {
    */
   [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
 
+  /// utilization the M/D/1 model is capped at
+  static constexpr double max_utilization = 0.99;
+
  protected:
   /// number of NPUs in the topology
   int npus_count;
@@ -76,6 +204,45 @@ class Topology {
 
   /// network bandwidth (GB/s) per each network dimension
   std::vector<Bandwidth> bandwidth_per_dim;
+
+  /// precomputed delay model of every NPU pair
+  DelayTable delay_table;
+
+  /// link utilization of each dimension, empty if not load-aware
+  std::vector<double> utilization_per_dim;
+
+  /// M/D/1 mean wait per hop of each dimension,
+  /// in units of the serialization delay on the dimension
+  std::vector<double> queueing_factor_per_dim;
+
+  /**
+   * Precompute the delay table of the topology, if it fits.
+   * Invoked once the shape of the topology is set.
+   */
+  virtual void build_delay_table() noexcept = 0;
+
+  /**
+   * Compute the number of hops the route from src to dest
+   * takes on each dimension.
+   *
+   * @param src src NPU ID
+   * @param dest dest NPU ID
+   * @param hops_count_per_dim number of hops on each dimension,
+   *     0 if the route doesn't use it, written back
+   */
+  virtual void compute_hops_count_per_dim(
+      DeviceId src,
+      DeviceId dest,
+      int* hops_count_per_dim) const noexcept = 0;
+
+  /**
+   * Get the BasicTopology of a network dimension.
+   *
+   * @param dim network dimension
+   * @return BasicTopology of the dimension
+   */
+  [[nodiscard]] virtual const BasicTopology& get_basic_topology(
+      int dim) const noexcept = 0;
 };
 
 } // namespace NetworkAnalyticalCongestionUnaware
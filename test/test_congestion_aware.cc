@@ -4,15 +4,47 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <thread>
 #include "common/EventQueue.hh"
 #include "common/NetworkParser.hh"
+#include "common/RingBuffer.hh"
 #include "common/Type.hh"
 #include "congestion_aware/Chunk.hh"
+#include "congestion_aware/Collective.hh"
+#include "congestion_aware/FlowSimulation.hh"
 #include "congestion_aware/Helper.hh"
+#include "congestion_aware/Link.hh"
+#include "congestion_aware/ParallelSimulation.hh"
+#include "congestion_aware/SimulationContext.hh"
+#include "congestion_aware/Switch.hh"
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
+/// number of calls to the global operator new, to test allocation-free paths
+std::atomic<size_t> global_allocations_count{0};
+
+void* operator new(const size_t size) {
+  global_allocations_count++;
+  if (auto* const ptr = std::malloc(std::max(size, size_t{1}))) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* const ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* const ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
 class TestNetworkAnalyticalCongestionAware : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -95,6 +127,331 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Switch) {
   EXPECT_EQ(simulation_time, 40'062);
 }
 
+TEST_F(TestNetworkAnalyticalCongestionAware, Ring_FullyConnected_Switch) {
+  /// setup: 2 x 8 x 4 NPUs, with a switch per each line of dim 3
+  const auto network_parser =
+      NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  EXPECT_EQ(topology->get_npus_count(), 64);
+  EXPECT_EQ(topology->get_devices_count(), 64 + 16);
+
+  /// send a chunk and measure its communication delay
+  const auto send = [&](const DeviceId src, const DeviceId dest) {
+    const auto start_time = event_queue->get_current_time();
+    auto chunk = std::make_unique<Chunk>(
+        chunk_size, topology->route(src, dest), callback, nullptr);
+    topology->send(std::move(chunk));
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+    return event_queue->get_current_time() - start_time;
+  };
+
+  /// run on each dim
+  EXPECT_EQ(send(0, 1), 4'932);
+  EXPECT_EQ(send(37, 41), 10'265);
+  EXPECT_EQ(send(26, 42), 43'062);
+
+  /// dimension-order routing: [0, 1, 15, switch, 63]
+  const auto route = topology->route(0, 63);
+  ASSERT_EQ(route.size(), 5);
+  EXPECT_EQ(route[1], 1);
+  EXPECT_EQ(route[2], 15);
+  EXPECT_GE(route[3], 64);
+  EXPECT_EQ(send(0, 63), 4'932 + 10'265 + 43'062);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SharedRoute) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  const auto topology = construct_topology(network_parser);
+
+  /// route longer than the inline storage: [1, 2, ..., 9]
+  const auto route = topology->route(1, 9);
+  ASSERT_EQ(route.size(), 9);
+  ASSERT_GT(route.size(), Route::inline_capacity);
+  for (auto hop = 0; hop < route.size(); hop++) {
+    EXPECT_EQ(route[hop], 1 + hop);
+  }
+
+  // chunks share the devices of the route
+  const auto route_copy = route;
+  EXPECT_EQ(route_copy.data(), route.data());
+
+  // send a chunk along the shared route
+  auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+  topology->send(std::move(chunk));
+
+  /// Run simulation
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+
+  /// test: the original route is left untouched
+  const auto simulation_time = event_queue->get_current_time();
+  EXPECT_EQ(simulation_time, 160'248);
+  EXPECT_EQ(route[0], 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RoutingTable) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  const auto topology = construct_topology(network_parser);
+  const auto npus_count = topology->get_npus_count();
+
+  /// lazily filled: the second lookup reuses the cached route
+  const auto route = topology->route(1, 9);
+  const auto cached_route = topology->route(1, 9);
+  EXPECT_EQ(topology->get_route_misses_count(), 1);
+  EXPECT_EQ(topology->get_route_hits_count(), 1);
+  EXPECT_EQ(cached_route.data(), route.data());
+
+  /// long routes are borrowed from the table, even when copied into chunks
+  EXPECT_TRUE(route.is_borrowed());
+  const auto chunk = Chunk(chunk_size, route, callback, nullptr);
+  EXPECT_TRUE(chunk.get_route().is_borrowed());
+  EXPECT_EQ(chunk.get_route().data(), route.data());
+
+  // modifying a borrowed route copies it, leaving the table untouched
+  auto modified_route = route;
+  modified_route.set_link_index(0, 0);
+  EXPECT_FALSE(modified_route.is_borrowed());
+  EXPECT_NE(modified_route.data(), route.data());
+  EXPECT_EQ(topology->route(1, 9).data(), route.data());
+
+  /// eagerly filled: every lookup hits
+  const auto eager_topology = construct_topology(network_parser);
+  eager_topology->build_routing_table(4);
+  for (auto src = 0; src < npus_count; src++) {
+    for (auto dest = 0; dest < npus_count; dest++) {
+      const auto eager_route = eager_topology->route(src, dest);
+      const auto lazy_route = topology->route(src, dest);
+      ASSERT_EQ(eager_route.size(), lazy_route.size());
+      for (auto hop = 0; hop < eager_route.size(); hop++) {
+        EXPECT_EQ(eager_route[hop], lazy_route[hop]);
+      }
+    }
+  }
+  EXPECT_EQ(eager_topology->get_route_misses_count(), 0);
+
+  /// memory cap: nothing is cached
+  const auto capped_topology = construct_topology(network_parser);
+  capped_topology->set_routing_table_capacity(0);
+  const auto capped_route = capped_topology->route(1, 9);
+  EXPECT_FALSE(capped_route.is_borrowed());
+  EXPECT_EQ(capped_topology->route(1, 9).size(), capped_route.size());
+  EXPECT_EQ(capped_topology->get_route_misses_count(), 2);
+  EXPECT_EQ(capped_topology->get_routing_table().get_used_bytes(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkAdjacency) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  const auto npus_count = topology->get_npus_count();
+  const auto switch_id = npus_count;
+
+  /// each NPU has a single link to the switch,
+  /// the switch has a link to every NPU, sorted by dest
+  for (auto i = 0; i < npus_count; i++) {
+    const auto npu = topology->get_device(i);
+    ASSERT_EQ(npu->get_links_count(), 1);
+    EXPECT_EQ(npu->get_link_dest(0), switch_id);
+  }
+  const auto switch_device = topology->get_device(switch_id);
+  ASSERT_EQ(switch_device->get_links_count(), npus_count);
+  for (auto i = 0; i < npus_count; i++) {
+    EXPECT_EQ(switch_device->get_link_dest(i), i);
+    EXPECT_EQ(switch_device->get_link_index(i), i);
+  }
+
+  /// every hop of a route resolves to its link
+  const auto route = topology->route(1, 4);
+  ASSERT_EQ(route.size(), 3);
+  EXPECT_EQ(route.link_index(0), 0);
+  EXPECT_EQ(route.link_index(1), 4);
+  EXPECT_EQ(route.link_index(2), -1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkQueueDepth) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  const auto npus_count = topology->get_npus_count();
+  const auto switch_id = npus_count;
+
+  /// incast: every other NPU sends a chunk to NPU 0
+  for (auto i = 1; i < npus_count; i++) {
+    auto chunk = std::make_unique<Chunk>(
+        chunk_size, topology->route(i, 0), callback, nullptr);
+    topology->send(std::move(chunk));
+  }
+
+  /// Run simulation
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+
+  /// test: chunks arrive at the switch at once,
+  /// so all but one wait for the link to NPU 0
+  const auto* const link = topology->get_device(switch_id)->get_link(0);
+  EXPECT_EQ(link->get_max_pending_chunks_count(), npus_count - 2);
+  EXPECT_EQ(link->get_pending_chunks_count(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkBacklog) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  const auto topology = construct_topology(network_parser);
+
+  /// send a backlog of chunks through the link 0 -> 1
+  const auto chunks_count = 8;
+  for (auto i = 0; i < chunks_count; i++) {
+    auto chunk = std::make_unique<Chunk>(
+        chunk_size, topology->route(0, 1), callback, nullptr);
+    topology->send(std::move(chunk));
+  }
+
+  /// test: the whole backlog is scheduled at once
+  const auto* const link = topology->get_device(0)->get_link(1);
+  EXPECT_EQ(link->get_pending_chunks_count(), chunks_count - 1);
+  EXPECT_EQ(link->get_free_time(), chunks_count * 19'531);
+
+  /// Run simulation
+  auto proceeds_count = 0;
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+    proceeds_count++;
+  }
+
+  /// test: one event per chunk arrival, no link-free events
+  EXPECT_EQ(proceeds_count, chunks_count);
+  EXPECT_EQ(link->get_pending_chunks_count(), 0);
+  EXPECT_EQ(event_queue->get_current_time(), 156'748);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkArrivalOrder) {
+  /// setup: 3 NPUs at 1 GB/s and 10 ns
+  const auto topology = std::make_shared<Switch>(3, 1, 10);
+  auto arrival_times = std::vector<EventTime>(3, 0);
+  const auto send = [&](const int index, const DeviceId src,
+                        const ChunkSize size) {
+    auto chunk = std::make_unique<Chunk>(
+        size, topology->route(src, 2), [&arrival_times, index, this]() {
+          arrival_times[index] = event_queue->get_current_time();
+        });
+    topology->send(std::move(chunk));
+  };
+
+  /// A and B queue on the link 0 -> switch, C on the link 1 -> switch:
+  /// B and C reach the switch at the same time
+  send(0, 0, 100);
+  send(1, 0, 50);
+  send(2, 1, 150);
+
+  /// Run simulation
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+
+  /// test: B departed after C was sent, so C is forwarded first
+  const auto expected = std::vector<EventTime>{206, 391, 345};
+  EXPECT_EQ(arrival_times, expected);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ReservationModel) {
+  for (const auto congestion_model :
+       {CongestionModel::HopByHop, CongestionModel::Reservation}) {
+    /// setup
+    event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(event_queue);
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_congestion_model(congestion_model);
+
+    /// two chunks pipelined over 3 hops
+    auto arrival_times = std::vector<EventTime>();
+    for (auto i = 0; i < 2; i++) {
+      auto chunk = std::make_unique<Chunk>(
+          chunk_size, topology->route(1, 4), [&arrival_times, this]() {
+            arrival_times.push_back(event_queue->get_current_time());
+          });
+      topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+
+    /// test: same arrivals, but only the arrivals at the dest are events
+    const auto expected = std::vector<EventTime>{60'093, 79'624};
+    EXPECT_EQ(arrival_times, expected);
+    const auto events_count =
+        (congestion_model == CongestionModel::Reservation) ? 2 : 6;
+    EXPECT_EQ(event_queue->get_scheduled_events_count(), events_count);
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HybridModel) {
+  for (const auto congestion_model :
+       {CongestionModel::HopByHop, CongestionModel::Hybrid}) {
+    /// setup
+    event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(event_queue);
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_congestion_model(congestion_model);
+
+    /// two chunks sharing a route: only the first one finds it idle
+    auto arrival_times = std::vector<EventTime>();
+    const auto send = [&](const DeviceId src, const DeviceId dest) {
+      auto chunk = std::make_unique<Chunk>(
+          chunk_size, topology->route(src, dest), [&arrival_times, this]() {
+            arrival_times.push_back(event_queue->get_current_time());
+          });
+      topology->send(std::move(chunk));
+    };
+    send(1, 4);
+    send(1, 4);
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+
+    /// the network is idle again
+    send(5, 7);
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+
+    /// test: same arrivals, but idle routes take a single event
+    const auto expected = std::vector<EventTime>{60'093, 79'624, 119'686};
+    EXPECT_EQ(arrival_times, expected);
+    const auto events_count =
+        (congestion_model == CongestionModel::Hybrid) ? 5 : 8;
+    EXPECT_EQ(event_queue->get_scheduled_events_count(), events_count);
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HybridLinkOrder) {
+  /// setup: a link at 1 GB/s and 10 ns
+  auto link = Link(1, 10);
+  link.set_event_queue(event_queue.get());
+  link.set_congestion_model(CongestionModel::Hybrid);
+
+  /// a slot reserved at [100, 193), then two chunks queued hop by hop
+  link.add_incoming_chunk();
+  link.add_incoming_chunk();
+  EXPECT_EQ(link.reserve(100, 100), 203);
+  const auto first_arrival_time = link.transmit(150);
+  const auto second_arrival_time = link.transmit(50);
+
+  /// test: the first chunk doesn't fit before the reserved slot,
+  /// and the second one still departs after it (at 193 + 139)
+  EXPECT_EQ(first_arrival_time, 193 + 149);
+  EXPECT_EQ(second_arrival_time, 332 + 56);
+}
+
 TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
   /// setup
   const auto network_parser = NetworkParser("../../input/Ring.yml");
@@ -131,3 +488,1069 @@ TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
   const auto simulation_time = event_queue->get_current_time();
   EXPECT_EQ(simulation_time, 704'116);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InlineCallback) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  const auto topology = construct_topology(network_parser);
+
+  /// message settings: callbacks capture their context inline
+  auto arrival_times = std::vector<EventTime>(2, 0);
+  auto* const arrival_times_ptr = &arrival_times;
+  auto* const event_queue_ptr = event_queue.get();
+  for (int i = 0; i < 2; i++) {
+    auto route = topology->route(1, 4);
+    auto chunk = std::make_unique<Chunk>(
+        chunk_size, route, [arrival_times_ptr, event_queue_ptr, i]() {
+          (*arrival_times_ptr)[i] = event_queue_ptr->get_current_time();
+        });
+
+    // send a chunk
+    topology->send(std::move(chunk));
+  }
+
+  /// Run simulation
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+
+  /// test: the second chunk waits for the first one on the first link
+  EXPECT_EQ(arrival_times[0], 60'093);
+  EXPECT_GT(arrival_times[1], arrival_times[0]);
+  EXPECT_EQ(arrival_times[1], event_queue->get_current_time());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InlineCallbackMoveOnly) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  const auto topology = construct_topology(network_parser);
+
+  /// a closure owning a non-trivial capture
+  auto arrival_time = std::make_shared<EventTime>(0);
+  auto* const event_queue_ptr = event_queue.get();
+  event_queue->schedule_event(
+      1'000, InlineCallback([arrival_time, event_queue_ptr]() {
+        *arrival_time = event_queue_ptr->get_current_time();
+      }));
+
+  /// a chunk callback owning a move-only capture
+  auto owned_id = std::make_unique<int>(4);
+  auto arrived_id = 0;
+  auto* const arrived_id_ptr = &arrived_id;
+  auto chunk = std::make_unique<Chunk>(
+      chunk_size,
+      topology->route(1, 4),
+      [owned_id = std::move(owned_id), arrived_id_ptr]() {
+        *arrived_id_ptr = *owned_id;
+      });
+  topology->send(std::move(chunk));
+
+  /// Run simulation
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+
+  /// test: captures are moved into place, invoked, then released
+  EXPECT_EQ(*arrival_time, 1'000);
+  EXPECT_EQ(arrival_time.use_count(), 1);
+  EXPECT_EQ(arrived_id, 4);
+
+  /// test: events dropped with their queue release their captures
+  auto pending_queue = std::make_unique<EventQueue>();
+  pending_queue->schedule_event(
+      1'000, InlineCallback([arrival_time]() { *arrival_time = 0; }));
+  EXPECT_EQ(arrival_time.use_count(), 2);
+  pending_queue.reset();
+  EXPECT_EQ(arrival_time.use_count(), 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SendBatch) {
+  for (const auto congestion_model :
+       {CongestionModel::HopByHop, CongestionModel::Reservation}) {
+    /// setup
+    event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(event_queue);
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_congestion_model(congestion_model);
+
+    /// two chunks pipelined over 3 hops, and one crossing their route
+    const auto descriptors = std::vector<ChunkDescriptor>{
+        {2, 3, chunk_size, 2}, {1, 4, chunk_size, 0}, {1, 4, chunk_size, 1}};
+    auto arrival_times = std::vector<EventTime>(3, 0);
+    auto record = std::make_pair(event_queue.get(), arrival_times.data());
+    topology->send_batch(
+        descriptors.data(),
+        descriptors.size(),
+        [](void* const arg, const uint64_t tag) {
+          auto* const record =
+              static_cast<std::pair<EventQueue*, EventTime*>*>(arg);
+          record->second[tag] = record->first->get_current_time();
+        },
+        &record);
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+
+    /// test: each chunk arrives as if sent one by one
+    EXPECT_EQ(arrival_times[0], 60'093);
+    EXPECT_EQ(arrival_times[1], 79'624);
+    EXPECT_EQ(arrival_times[2], 20'031);
+
+    /// the same batch again, once the links are idle
+    const auto start_time = event_queue->get_current_time();
+    auto batch_arrival_time = EventTime{0};
+    auto* const batch_arrival_time_ptr = &batch_arrival_time;
+    auto* const event_queue_ptr = event_queue.get();
+    topology->send_batch(
+        descriptors.data(),
+        descriptors.size(),
+        [batch_arrival_time_ptr, event_queue_ptr]() {
+          *batch_arrival_time_ptr = event_queue_ptr->get_current_time();
+        });
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+
+    /// test: the batch callback fires once the last chunk arrived
+    EXPECT_EQ(batch_arrival_time - start_time, arrival_times[1]);
+
+    /// test: one route lookup per (src, dest) run of a batch
+    EXPECT_EQ(
+        topology->get_route_hits_count() + topology->get_route_misses_count(),
+        4);
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SendBatchMatchesSend) {
+  for (const auto congestion_model :
+       {CongestionModel::HopByHop,
+        CongestionModel::Reservation,
+        CongestionModel::Hybrid}) {
+    /// All-to-All of mixed sizes, so that many arrivals are simultaneous
+    const auto all_to_all = [&](const bool batched) {
+      event_queue = std::make_shared<EventQueue>();
+      Topology::set_event_queue(event_queue);
+      const auto network_parser = NetworkParser("../../input/Switch.yml");
+      const auto topology = construct_topology(network_parser);
+      topology->set_congestion_model(congestion_model);
+      const auto npus_count = topology->get_npus_count();
+
+      auto descriptors = std::vector<ChunkDescriptor>();
+      for (auto i = 0; i < npus_count; i++) {
+        for (auto j = 0; j < npus_count; j++) {
+          if (i != j) {
+            const auto size = chunk_size * (1 + (i + 2 * j) % 3);
+            descriptors.push_back({i, j, size, descriptors.size()});
+          }
+        }
+      }
+
+      auto arrival_times = std::vector<EventTime>(descriptors.size(), 0);
+      auto record = std::make_pair(event_queue.get(), arrival_times.data());
+      const auto record_arrival = [](void* const arg, const uint64_t tag) {
+        auto* const record =
+            static_cast<std::pair<EventQueue*, EventTime*>*>(arg);
+        record->second[tag] = record->first->get_current_time();
+      };
+      if (batched) {
+        topology->send_batch(
+            descriptors.data(), descriptors.size(), record_arrival, &record);
+      } else {
+        for (const auto& descriptor : descriptors) {
+          auto* const record_ptr = &record;
+          const auto tag = descriptor.tag;
+          topology->send(std::make_unique<Chunk>(
+              descriptor.chunk_size,
+              topology->route(descriptor.src, descriptor.dest),
+              [record_arrival, record_ptr, tag]() {
+                record_arrival(record_ptr, tag);
+              }));
+        }
+      }
+
+      while (!event_queue->finished()) {
+        event_queue->proceed();
+      }
+      return arrival_times;
+    };
+
+    /// test: a batch arrives as the chunks sent one by one
+    EXPECT_EQ(all_to_all(true), all_to_all(false))
+        << static_cast<int>(congestion_model);
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Message) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  const auto topology = construct_topology(network_parser);
+
+  /// send a message, returning when its last chunk arrived
+  const auto message_time = [&](auto send) {
+    const auto start_time = event_queue->get_current_time();
+    auto finish_time = EventTime{0};
+    auto callbacks_count = 0;
+    auto* const finish_time_ptr = &finish_time;
+    auto* const callbacks_count_ptr = &callbacks_count;
+    auto* const event_queue_ptr = event_queue.get();
+    send(InlineCallback(
+        [finish_time_ptr, callbacks_count_ptr, event_queue_ptr]() {
+          *finish_time_ptr = event_queue_ptr->get_current_time();
+          (*callbacks_count_ptr)++;
+        }));
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+    EXPECT_EQ(callbacks_count, 1);
+    return finish_time - start_time;
+  };
+
+  /// test: 2 chunks of 1 MB arrive as two chunks sent by hand
+  const auto two_chunks = message_time([&](InlineCallback callback) {
+    topology->send_message(
+        1, 4, 2 * chunk_size, chunk_size, std::move(callback));
+  });
+  EXPECT_EQ(two_chunks, 79'624);
+
+  /// test: splitting into a count of chunks is the same
+  EXPECT_EQ(
+      message_time([&](InlineCallback callback) {
+        topology->send_message_in_chunks(
+            1, 4, 2 * chunk_size, 2, std::move(callback));
+      }),
+      two_chunks);
+
+  /// test: finer pipelining hides the hops, coarser one doesn't
+  const auto one_chunk = message_time([&](InlineCallback callback) {
+    topology->send_message(
+        1, 4, 2 * chunk_size, 2 * chunk_size, std::move(callback));
+  });
+  const auto eight_chunks = message_time([&](InlineCallback callback) {
+    topology->send_message_in_chunks(
+        1, 4, 2 * chunk_size, 8, std::move(callback));
+  });
+  EXPECT_LT(eight_chunks, two_chunks);
+  EXPECT_LT(two_chunks, one_chunk);
+
+  /// test: the last chunk holds the remainder
+  EXPECT_LT(
+      message_time([&](InlineCallback callback) {
+        topology->send_message(
+            1, 4, chunk_size + 1, chunk_size, std::move(callback));
+      }),
+      two_chunks);
+
+  /// test: an empty message is delivered at once
+  EXPECT_EQ(
+      message_time([&](InlineCallback callback) {
+        topology->send_message(1, 4, 0, chunk_size, std::move(callback));
+      }),
+      0);
+}
+
+/// run an All-Gather on its own simulation context
+EventTime context_all_gather(const std::string& network_config) {
+  auto context = SimulationContext(NetworkParser(network_config));
+  const auto topology = context.get_topology();
+  const auto npus_count = topology->get_npus_count();
+
+  for (int i = 0; i < npus_count; i++) {
+    for (int j = 0; j < npus_count; j++) {
+      if (i == j) {
+        continue;
+      }
+      auto chunk = topology->make_chunk(
+          1'048'576, topology->route(i, j), [](void* const) {}, nullptr);
+      topology->send(std::move(chunk));
+    }
+  }
+
+  context.run();
+  return context.get_current_time();
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SimulationContext) {
+  /// setup
+  auto context_a = SimulationContext(NetworkParser("../../input/Ring.yml"));
+  auto context_b = SimulationContext(NetworkParser("../../input/Ring.yml"));
+
+  /// send a chunk through context a only
+  const auto topology_a = context_a.get_topology();
+  auto chunk = std::make_unique<Chunk>(
+      chunk_size, topology_a->route(1, 4), callback, nullptr);
+  topology_a->send(std::move(chunk));
+  context_a.run();
+
+  /// test: contexts don't share a clock
+  EXPECT_EQ(context_a.get_current_time(), 60'093);
+  EXPECT_EQ(context_b.get_current_time(), 0);
+  EXPECT_TRUE(context_b.get_event_queue()->finished());
+  EXPECT_TRUE(event_queue->finished());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ConcurrentSimulationContexts) {
+  /// setup: run each simulation alone
+  const auto network_configs = std::vector<std::string>{
+      "../../input/Ring.yml",
+      "../../input/Switch.yml",
+      "../../input/FullyConnected.yml",
+      "../../input/Ring.yml"};
+  auto expected = std::vector<EventTime>();
+  for (const auto& network_config : network_configs) {
+    expected.push_back(context_all_gather(network_config));
+  }
+
+  /// run every simulation concurrently
+  auto finish_times = std::vector<EventTime>(network_configs.size(), 0);
+  auto threads = std::vector<std::thread>();
+  for (size_t i = 0; i < network_configs.size(); i++) {
+    threads.emplace_back([&network_configs, &finish_times, i]() {
+      finish_times[i] = context_all_gather(network_configs[i]);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  /// test
+  EXPECT_EQ(expected[0], 704'116);
+  EXPECT_EQ(finish_times, expected);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkPool) {
+  /// setup
+  auto context = SimulationContext(NetworkParser("../../input/Ring.yml"));
+  const auto topology = context.get_topology();
+  const auto chunk_pool = context.get_chunk_pool();
+  const auto npus_count = topology->get_npus_count();
+  const auto chunks_count = static_cast<size_t>(npus_count * (npus_count - 1));
+
+  /// run an all-to-all twice
+  auto system_allocations_count = std::vector<size_t>();
+  for (auto round = 0; round < 2; round++) {
+    for (auto i = 0; i < npus_count; i++) {
+      for (auto j = 0; j < npus_count; j++) {
+        if (i != j) {
+          topology->send(topology->make_chunk(
+              chunk_size, topology->route(i, j), callback, nullptr));
+        }
+      }
+    }
+    context.run();
+
+    /// every chunk is returned to the pool at its destination
+    EXPECT_EQ(chunk_pool->get_chunks_count(), 0);
+    EXPECT_EQ(chunk_pool->get_peak_chunks_count(), chunks_count);
+    system_allocations_count.push_back(
+        chunk_pool->get_arena().get_system_allocations_count());
+  }
+
+  /// test: the second round only recycles chunks
+  EXPECT_EQ(system_allocations_count[1], system_allocations_count[0]);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkPoolOutlivedByChunks) {
+  /// setup: a simulation stopped while its chunks are in flight
+  const auto network_parser = NetworkParser("../../input/Ring.yml");
+  auto context = std::make_unique<SimulationContext>(network_parser);
+  auto topology = context->get_topology();
+  auto held_chunk = topology->make_chunk(
+      chunk_size, topology->route(1, 4), callback, nullptr);
+  for (auto i = 1; i < topology->get_npus_count(); i++) {
+    topology->send(topology->make_chunk(
+        chunk_size, topology->route(i, 0), callback, nullptr));
+  }
+  context->get_event_queue()->proceed();
+
+  /// destroy the simulation, including its chunk pool
+  topology.reset();
+  context.reset();
+
+  /// test: a chunk deleted afterwards returns to the storage of its pool
+  held_chunk.reset();
+  EXPECT_EQ(held_chunk, nullptr);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkSteadyStateAllocations) {
+  /// setup: a link fed much faster than it serializes
+  auto link = Link(50, 500);
+  link.set_event_queue(event_queue.get());
+  const auto send_burst = [this, &link]() {
+    for (auto i = 0; i < 1'000; i++) {
+      [[maybe_unused]] const auto arrival_time = link.transmit(chunk_size);
+    }
+    EXPECT_EQ(link.get_pending_chunks_count(), 999);
+
+    // let every chunk depart
+    event_queue->schedule_event(link.get_free_time(), callback, nullptr);
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+    EXPECT_EQ(link.get_pending_chunks_count(), 0);
+  };
+
+  /// reservations filling the gaps between earlier ones,
+  /// inserted in the middle of the timeline of the link
+  const auto reserve_burst = [this, &link]() {
+    const auto start_time = event_queue->get_current_time();
+    const auto slot_length = link.communication_delay(chunk_size);
+    for (const auto first : {0, 1}) {
+      for (auto i = first; i < 1'000; i += 2) {
+        const auto ready_time = start_time + 2 * i * slot_length;
+        EXPECT_EQ(
+            link.reserve(chunk_size, ready_time), ready_time + slot_length);
+      }
+    }
+
+    // let every slot pass
+    event_queue->schedule_event(link.get_free_time(), callback, nullptr);
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+  };
+
+  /// warm up the queues of the link and the arena of the event queue
+  send_burst();
+  reserve_burst();
+
+  /// test: once warmed up, queueing chunks never allocates
+  const auto allocations_count = global_allocations_count.load();
+  for (auto burst = 0; burst < 4; burst++) {
+    send_burst();
+    reserve_burst();
+  }
+  EXPECT_EQ(global_allocations_count.load(), allocations_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RingBuffer) {
+  /// setup: std::deque as the reference
+  auto ring_buffer = RingBuffer<int>();
+  auto reference = std::deque<int>();
+
+  /// apply pseudo-random pushes, pops, insertions and erasures
+  auto seed = 1u;
+  for (auto i = 0; i < 10'000; i++) {
+    seed = seed * 1'103'515'245u + 12'345u;
+    const auto operation = (seed >> 16) % 4;
+    const auto position = static_cast<std::ptrdiff_t>(
+        reference.empty() ? 0 : (seed >> 8) % reference.size());
+    if (operation == 0 || reference.size() < 8) {
+      ring_buffer.push_back(i);
+      reference.push_back(i);
+    } else if (operation == 1) {
+      ring_buffer.pop_front();
+      reference.pop_front();
+    } else if (operation == 2) {
+      const auto it = ring_buffer.insert(ring_buffer.begin() + position, i);
+      reference.insert(reference.begin() + position, i);
+      EXPECT_EQ(*it, i);
+    } else {
+      const auto it = ring_buffer.erase(ring_buffer.begin() + position);
+      const auto reference_it = reference.erase(reference.begin() + position);
+      EXPECT_EQ(it - ring_buffer.begin(), reference_it - reference.begin());
+    }
+
+    /// test: same elements in the same order
+    ASSERT_EQ(ring_buffer.size(), reference.size());
+    EXPECT_TRUE(
+        std::equal(ring_buffer.begin(), ring_buffer.end(), reference.begin()));
+  }
+
+  /// test: capacity stays a power of 2
+  EXPECT_EQ(ring_buffer.capacity() & (ring_buffer.capacity() - 1), 0);
+}
+
+/// chunk size of the i -> j chunk of the All-to-All tests,
+/// equal for many pairs so that simultaneous events occur
+ChunkSize all_to_all_chunk_size(const int i, const int j) {
+  return 262'144 * (1 + (i + 2 * j) % 3);
+}
+
+/// run an All-to-All with the sequential EventQueue
+std::vector<EventTime> sequential_all_to_all(
+    const std::string& network_config) {
+  const auto event_queue = std::make_shared<EventQueue>();
+  Topology::set_event_queue(event_queue);
+  auto* const event_queue_ptr = event_queue.get();
+  const auto topology = construct_topology(NetworkParser(network_config));
+  const auto npus_count = topology->get_npus_count();
+  auto arrival_times = std::vector<EventTime>(npus_count * npus_count, 0);
+  auto* const arrival_times_ptr = &arrival_times;
+
+  // order simultaneous arrivals by their keys, as the parallel simulation
+  event_queue->set_keyed_order(true);
+
+  // sources send in the reverse order of their link ids,
+  // so that the FIFO order of simultaneous events differs from their keys
+  for (int i = npus_count - 1; i >= 0; i--) {
+    for (int j = 0; j < npus_count; j++) {
+      if (i == j) {
+        continue;
+      }
+      const auto index = i * npus_count + j;
+      auto chunk = std::make_unique<Chunk>(
+          all_to_all_chunk_size(i, j),
+          topology->route(i, j),
+          [arrival_times_ptr, event_queue_ptr, index]() {
+            (*arrival_times_ptr)[index] = event_queue_ptr->get_current_time();
+          });
+      topology->send(std::move(chunk));
+    }
+  }
+
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+  return arrival_times;
+}
+
+/// run an All-to-All with the parallel simulation
+std::vector<EventTime> parallel_all_to_all(
+    const std::string& network_config,
+    const int threads_count) {
+  const auto topology = construct_topology(NetworkParser(network_config));
+  const auto npus_count = topology->get_npus_count();
+  auto simulation = ParallelSimulation(topology, threads_count);
+  auto arrival_times = std::vector<EventTime>(npus_count * npus_count, 0);
+  auto* const arrival_times_ptr = &arrival_times;
+  const auto* const simulation_ptr = &simulation;
+
+  // sources send in the reverse order of their link ids,
+  // so that the FIFO order of simultaneous events differs from their keys
+  for (int i = npus_count - 1; i >= 0; i--) {
+    for (int j = 0; j < npus_count; j++) {
+      if (i == j) {
+        continue;
+      }
+      const auto index = i * npus_count + j;
+      auto chunk = std::make_unique<Chunk>(
+          all_to_all_chunk_size(i, j),
+          topology->route(i, j),
+          [arrival_times_ptr, simulation_ptr, index]() {
+            (*arrival_times_ptr)[index] = simulation_ptr->get_current_time();
+          });
+      topology->send(std::move(chunk));
+    }
+  }
+
+  simulation.run();
+  return arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelSimulation) {
+  for (const auto* const network_config :
+       {"../../input/Ring.yml",
+        "../../input/Switch.yml",
+        "../../input/FullyConnected.yml"}) {
+    /// setup: single-thread run as the reference
+    const auto reference = parallel_all_to_all(network_config, 1);
+
+    /// test: bit-identical arrival times for any number of threads
+    for (const auto threads_count : {2, 3, 4}) {
+      const auto parallel = parallel_all_to_all(network_config, threads_count);
+      EXPECT_EQ(parallel, reference)
+          << network_config << ", threads: " << threads_count;
+    }
+  }
+}
+
+TEST_F(
+    TestNetworkAnalyticalCongestionAware,
+    ParallelSimulationMatchesEventQueue) {
+  for (const auto* const network_config :
+       {"../../input/Ring.yml",
+        "../../input/Switch.yml",
+        "../../input/FullyConnected.yml"}) {
+    /// setup
+    const auto sequential = sequential_all_to_all(network_config);
+
+    /// test
+    const auto parallel = parallel_all_to_all(network_config, 4);
+    EXPECT_EQ(parallel, sequential) << network_config;
+  }
+}
+
+/// state shared by the chunks of parallel_request_reply()
+struct RequestReplyState {
+  /// topology the chunks are sent through
+  Topology* topology;
+
+  /// parallel simulation of the topology
+  const ParallelSimulation* simulation;
+
+  /// arrival time of the reply to the i -> j chunk,
+  /// at index i * npus_count + j
+  std::vector<EventTime> arrival_times;
+};
+
+/// run an All-to-All with the parallel simulation,
+/// each chunk replied to by its destination on its worker thread,
+/// every chunk created and routed by the topology
+std::vector<EventTime> parallel_request_reply(
+    const std::string& network_config,
+    const int threads_count) {
+  const auto topology = construct_topology(NetworkParser(network_config));
+  const auto npus_count = topology->get_npus_count();
+  auto simulation = ParallelSimulation(topology, threads_count);
+  auto state = RequestReplyState{
+      topology.get(),
+      &simulation,
+      std::vector<EventTime>(npus_count * npus_count, 0)};
+  auto* const state_ptr = &state;
+
+  for (int i = 0; i < npus_count; i++) {
+    for (int j = 0; j < npus_count; j++) {
+      if (i == j) {
+        continue;
+      }
+      const auto index = i * npus_count + j;
+      topology->send(topology->make_chunk(
+          all_to_all_chunk_size(i, j),
+          topology->route(i, j),
+          [state_ptr, index, j]() {
+            // reply from the destination, on its worker thread
+            auto* const topology = state_ptr->topology;
+            const auto i = index / topology->get_npus_count();
+            topology->send(topology->make_chunk(
+                all_to_all_chunk_size(j, i),
+                topology->route(j, i),
+                [state_ptr, index]() {
+                  state_ptr->arrival_times[index] =
+                      state_ptr->simulation->get_current_time();
+                }));
+          }));
+    }
+  }
+  simulation.run();
+
+  // every reply arrived, and no chunk went through the chunk pool
+  const auto pending_replies_count =
+      std::count(state.arrival_times.begin(), state.arrival_times.end(), 0);
+  EXPECT_EQ(pending_replies_count, npus_count);
+  EXPECT_EQ(topology->get_chunk_pool()->get_peak_chunks_count(), 0);
+  return state.arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelSimulationMakeChunk) {
+  for (const auto* const network_config :
+       {"../../input/Ring.yml",
+        "../../input/Switch.yml",
+        "../../input/FullyConnected.yml"}) {
+    /// setup: single-thread run as the reference
+    const auto reference = parallel_request_reply(network_config, 1);
+
+    /// test: chunks created and destroyed on the workers
+    const auto parallel = parallel_request_reply(network_config, 4);
+    EXPECT_EQ(parallel, reference) << network_config;
+  }
+}
+
+TEST_F(
+    TestNetworkAnalyticalCongestionAware,
+    ParallelSimulationRejectsSendBatch) {
+  /// setup
+  const auto topology =
+      construct_topology(NetworkParser("../../input/Ring.yml"));
+  auto simulation = ParallelSimulation(topology, 2);
+  const auto descriptors = std::vector<ChunkDescriptor>{{1, 4, chunk_size, 0}};
+  const auto tagged_callback = [](void* const, const uint64_t) {};
+
+  /// test: batches share staging state across the worker threads
+  EXPECT_EXIT(
+      topology->send_batch(
+          descriptors.data(), descriptors.size(), tagged_callback, nullptr),
+      ::testing::ExitedWithCode(255),
+      "batched sends are not supported");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FlowSimulation) {
+  /// setup
+  const auto network_parser = NetworkParser("../../input/Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  auto simulation = FlowSimulation(topology);
+
+  /// message settings: NPUs 1, 2, 3 send to NPU 0 (incast),
+  /// while NPU 1 also sends to NPU 5 through its shared uplink
+  auto arrival_times = std::vector<EventTime>(4, 0);
+  const auto flows = std::vector<std::pair<DeviceId, DeviceId>>{
+      {1, 0}, {2, 0}, {3, 0}, {1, 5}};
+  for (auto i = size_t{0}; i < flows.size(); i++) {
+    auto* const arrival_time = &arrival_times[i];
+    auto* const queue = event_queue.get();
+    simulation.send(
+        chunk_size,
+        topology->route(flows[i].first, flows[i].second),
+        [arrival_time, queue]() {
+          *arrival_time = queue->get_current_time();
+        });
+  }
+
+  /// test: max-min fair rates once the flows started
+  event_queue->proceed();
+  EXPECT_EQ(simulation.get_active_flows_count(), 4);
+  for (const auto flow_id : {0, 1, 2}) {
+    EXPECT_NEAR(simulation.get_flow_rate(flow_id), 50.0 / 3, 1e-9);
+  }
+  EXPECT_NEAR(simulation.get_flow_rate(3), 100.0 / 3, 1e-9);
+
+  /// Run simulation
+  while (!event_queue->finished()) {
+    event_queue->proceed();
+  }
+
+  /// test: the incast drains at 1/3 of the bandwidth each,
+  /// and 1 -> 5 isn't slowed down further by the incast
+  EXPECT_EQ(simulation.get_active_flows_count(), 0);
+  EXPECT_EQ(arrival_times[0], 59'594);
+  EXPECT_EQ(arrival_times[1], 59'594);
+  EXPECT_EQ(arrival_times[2], 59'594);
+  EXPECT_EQ(arrival_times[3], 30'297);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Collective) {
+  /// setup
+  const auto ring = construct_topology(NetworkParser("../../input/Ring.yml"));
+  const auto fully_connected =
+      construct_topology(NetworkParser("../../input/FullyConnected.yml"));
+  const auto collective_size = 16 * chunk_size;
+
+  /// collectives: (topology, algorithm) of a 16 MB All-Reduce
+  auto ring_all_reduce = Collective(
+      ring,
+      CollectiveType::AllReduce,
+      collective_size,
+      CollectiveAlgorithm::Ring);
+  auto direct_all_reduce = Collective(
+      fully_connected,
+      CollectiveType::AllReduce,
+      collective_size,
+      CollectiveAlgorithm::Direct);
+  auto halving_doubling_all_reduce = Collective(
+      fully_connected,
+      CollectiveType::AllReduce,
+      collective_size,
+      CollectiveAlgorithm::HalvingDoubling);
+
+  /// test: steps of each algorithm on 16 NPUs
+  EXPECT_EQ(ring_all_reduce.get_steps_count(), 30);
+  EXPECT_EQ(ring_all_reduce.get_transfers_count(), 30 * 16);
+  EXPECT_EQ(direct_all_reduce.get_steps_count(), 2);
+  EXPECT_EQ(direct_all_reduce.get_transfers_count(), 2 * 16 * 15);
+  EXPECT_EQ(halving_doubling_all_reduce.get_steps_count(), 8);
+
+  /// Run simulation, one collective after another
+  auto finished_count = 0;
+  auto* const finished_count_ptr = &finished_count;
+  for (auto* const collective :
+       {&ring_all_reduce, &direct_all_reduce, &halving_doubling_all_reduce}) {
+    collective->start([finished_count_ptr]() { (*finished_count_ptr)++; });
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+    EXPECT_TRUE(collective->finished());
+  }
+  EXPECT_EQ(finished_count, 3);
+
+  /// test: Ring sends 1 MB to its neighbor in each of the 30 steps,
+  /// Direct sends 1 MB to every other NPU over distinct links in 2 steps,
+  /// and HalvingDoubling sends 8, 4, 2, 1, 1, 2, 4, 8 MB in 8 steps
+  EXPECT_EQ(ring_all_reduce.get_duration(), 30 * 20'031);
+  EXPECT_EQ(direct_all_reduce.get_duration(), 2 * 20'031);
+  EXPECT_EQ(
+      halving_doubling_all_reduce.get_duration(),
+      2 * (156'750 + 78'625 + 39'562 + 20'031));
+  EXPECT_EQ(
+      direct_all_reduce.get_start_time(), ring_all_reduce.get_finish_time());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HierarchicalCollective) {
+  /// setup: 2 x 8 x 4 NPUs
+  const auto network_parser =
+      NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  const auto collective_size = 64 * chunk_size;
+
+  /// Ring, Direct, and Direct within each dimension
+  const auto algorithm_per_dim = std::vector<CollectiveAlgorithm>{
+      CollectiveAlgorithm::Ring,
+      CollectiveAlgorithm::Direct,
+      CollectiveAlgorithm::Direct};
+  auto reduce_scatter = Collective(
+      topology,
+      CollectiveType::ReduceScatter,
+      collective_size,
+      algorithm_per_dim);
+  auto all_gather = Collective(
+      topology, CollectiveType::AllGather, collective_size, algorithm_per_dim);
+  auto all_reduce = Collective(
+      topology, CollectiveType::AllReduce, collective_size, algorithm_per_dim);
+  auto broadcast = Collective(
+      topology,
+      CollectiveType::Broadcast,
+      chunk_size,
+      CollectiveAlgorithm::HalvingDoubling,
+      5);
+
+  /// test: one phase per dimension, mirrored for All-Gather
+  EXPECT_EQ(reduce_scatter.get_steps_count(), 1 + 1 + 1);
+  EXPECT_EQ(reduce_scatter.get_transfers_count(), 64 * (1 + 7 + 3));
+  EXPECT_EQ(all_reduce.get_steps_count(), 2 * (1 + 1 + 1));
+
+  /// test: every NPU but the root receives the broadcast once
+  EXPECT_EQ(broadcast.get_steps_count(), 1 + 3 + 2);
+  EXPECT_EQ(broadcast.get_transfers_count(), 63);
+
+  /// Run simulation, one collective after another
+  for (auto* const collective :
+       {&reduce_scatter, &all_gather, &all_reduce, &broadcast}) {
+    collective->start();
+    while (!event_queue->finished()) {
+      event_queue->proceed();
+    }
+    EXPECT_TRUE(collective->finished());
+  }
+
+  /// test: the lines of a dimension are symmetric,
+  /// so All-Reduce takes as long as Reduce-Scatter and All-Gather
+  EXPECT_EQ(
+      all_reduce.get_duration(),
+      reduce_scatter.get_duration() + all_gather.get_duration());
+
+  /// test: Reduce-Scatter sends 32 MB over the ring, 4 MB to each of 7 NPUs,
+  /// then 1 MB to each of 3 NPUs through the switch, one after another
+  EXPECT_EQ(reduce_scatter.get_duration(), 277'986);
+
+  /// test: Broadcast forwards 1 MB over 1 + 3 + 2 (two-hop) steps
+  EXPECT_EQ(broadcast.get_duration(), 121'851);
+}
+
+template <typename Scheduler>
+class TestEventQueuePolicy : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // set event queue
+    event_queue = std::make_shared<GenericEventQueue<Scheduler>>();
+  }
+
+  std::shared_ptr<GenericEventQueue<Scheduler>> event_queue;
+};
+
+using EventQueuePolicies = ::testing::Types<
+    CalendarQueue,
+    RadixHeapQueue,
+    BinaryHeapQueue,
+    PairingHeapQueue,
+    SortedListQueue>;
+TYPED_TEST_SUITE(TestEventQueuePolicy, EventQueuePolicies);
+
+TYPED_TEST(TestEventQueuePolicy, Ordering) {
+  /// setup
+  using Queue = GenericEventQueue<TypeParam>;
+  struct Record {
+    Queue* event_queue;
+    int id;
+    std::vector<std::pair<EventTime, int>>* log;
+  };
+  auto log = std::vector<std::pair<EventTime, int>>();
+  auto records = std::vector<Record>();
+  const auto events_count = 10'000;
+  for (int i = 0; i < events_count; i++) {
+    records.push_back({this->event_queue.get(), i, &log});
+  }
+  const auto record_callback = [](void* const arg) {
+    auto* const record = static_cast<Record*>(arg);
+    const auto current_time = record->event_queue->get_current_time();
+    record->log->emplace_back(current_time, record->id);
+  };
+
+  /// schedule events at pseudo-random times, many sharing the same time
+  auto seed = 1u;
+  for (int i = 0; i < events_count; i++) {
+    seed = seed * 1'103'515'245u + 12'345u;
+    const auto event_time = 1 + (seed >> 16) % 1'000 * (i % 3 + 1);
+    this->event_queue->schedule_event(
+        event_time, record_callback, &records[i]);
+  }
+
+  /// Run simulation
+  while (!this->event_queue->finished()) {
+    this->event_queue->proceed();
+  }
+
+  /// test: times are non-decreasing, equal times keep FIFO order
+  ASSERT_EQ(log.size(), events_count);
+  for (int i = 1; i < events_count; i++) {
+    EXPECT_LE(log[i - 1].first, log[i].first);
+    if (log[i - 1].first == log[i].first) {
+      EXPECT_LT(log[i - 1].second, log[i].second);
+    }
+  }
+}
+
+TYPED_TEST(TestEventQueuePolicy, ScheduleAtCurrentTime) {
+  /// setup
+  using Queue = GenericEventQueue<TypeParam>;
+  struct Context {
+    Queue* event_queue;
+    int invoked_count;
+  };
+  auto context = Context{this->event_queue.get(), 0};
+  const auto count_callback = [](void* const arg) {
+    static_cast<Context*>(arg)->invoked_count++;
+  };
+  const auto reschedule_callback = [](void* const arg) {
+    auto* const context = static_cast<Context*>(arg);
+    context->invoked_count++;
+
+    // events scheduled at the current time run within the same proceed
+    const auto current_time = context->event_queue->get_current_time();
+    context->event_queue->schedule_event(
+        current_time,
+        [](void* const arg) { static_cast<Context*>(arg)->invoked_count++; },
+        arg);
+  };
+  this->event_queue->schedule_event(10, reschedule_callback, &context);
+  this->event_queue->schedule_event(20, count_callback, &context);
+
+  /// test
+  this->event_queue->proceed();
+  EXPECT_EQ(this->event_queue->get_current_time(), 10);
+  EXPECT_EQ(context.invoked_count, 2);
+
+  // events can still be scheduled before the next pending event
+  this->event_queue->schedule_event(15, count_callback, &context);
+  this->event_queue->proceed();
+  EXPECT_EQ(this->event_queue->get_current_time(), 15);
+  EXPECT_EQ(context.invoked_count, 3);
+
+  this->event_queue->proceed();
+  EXPECT_EQ(this->event_queue->get_current_time(), 20);
+  EXPECT_EQ(context.invoked_count, 4);
+  EXPECT_TRUE(this->event_queue->finished());
+}
+
+TYPED_TEST(TestEventQueuePolicy, SteadyStateAllocation) {
+  /// setup: hold model, every event schedules the next one
+  using Queue = GenericEventQueue<TypeParam>;
+  struct Context {
+    Queue* event_queue;
+    uint32_t seed;
+    int invoked_count;
+
+    static void hold(void* const arg) {
+      auto* const context = static_cast<Context*>(arg);
+      context->invoked_count++;
+
+      // reschedule at a pseudo-random time
+      context->seed = context->seed * 1'103'515'245u + 12'345u;
+      const auto increment = 1 + (context->seed >> 16) % 2'000;
+      const auto current_time = context->event_queue->get_current_time();
+      context->event_queue->schedule_event(
+          current_time + increment, hold, arg);
+    }
+  };
+  auto context = Context{this->event_queue.get(), 1u, 0};
+  for (int i = 0; i < 1'000; i++) {
+    this->event_queue->schedule_event(1 + i, Context::hold, &context);
+  }
+
+  /// warm up
+  while (context.invoked_count < 50'000) {
+    this->event_queue->proceed();
+  }
+  const auto& arena = this->event_queue->get_arena();
+  const auto system_allocations_count = arena.get_system_allocations_count();
+  EXPECT_GT(arena.get_peak_used_bytes(), 0);
+
+  /// test: steady state doesn't reach the system allocator
+  while (context.invoked_count < 100'000) {
+    this->event_queue->proceed();
+  }
+  EXPECT_EQ(arena.get_system_allocations_count(), system_allocations_count);
+  EXPECT_LE(arena.get_used_bytes(), arena.get_peak_used_bytes());
+}
+
+TYPED_TEST(TestEventQueuePolicy, TypedEvents) {
+  /// setup: log (kind, id) of every invoked event
+  static auto log = std::vector<std::pair<EventKind, int>>();
+  log.clear();
+  auto ids = std::vector<int>{0, 1, 2, 3};
+  const auto callback = [](void* const arg) {
+    log.emplace_back(EventKind::Callback, *static_cast<int*>(arg));
+  };
+  const auto dispatcher = [](const EventKind kind, void* const target) {
+    log.emplace_back(kind, *static_cast<int*>(target));
+  };
+  this->event_queue->set_event_dispatcher(dispatcher);
+
+  /// schedule every kind of event at the same time, then a later closure
+  this->event_queue->schedule_event(10, callback, &ids[0]);
+  this->event_queue->schedule_event(10, [id = ids[1]]() {
+    log.emplace_back(EventKind::Closure, id);
+  });
+  this->event_queue->schedule_event(10, EventKind::LinkBecomeFree, &ids[2]);
+  this->event_queue->schedule_event(10, EventKind::ChunkArrived, &ids[3]);
+  this->event_queue->schedule_event(20, [a = 5, b = 6, c = 7]() {
+    log.emplace_back(EventKind::Closure, a + b + c);
+  });
+
+  /// Run simulation
+  while (!this->event_queue->finished()) {
+    this->event_queue->proceed();
+  }
+
+  /// test: each kind is dispatched, in FIFO order
+  const auto expected = std::vector<std::pair<EventKind, int>>{
+      {EventKind::Callback, 0},
+      {EventKind::Closure, 1},
+      {EventKind::LinkBecomeFree, 2},
+      {EventKind::ChunkArrived, 3},
+      {EventKind::Closure, 18}};
+  EXPECT_EQ(log, expected);
+  EXPECT_EQ(this->event_queue->get_current_time(), 20);
+}
+
+TYPED_TEST(TestEventQueuePolicy, KeyedEvents) {
+  /// setup: log the id of every invoked event
+  using Queue = GenericEventQueue<TypeParam>;
+  static auto log = std::vector<int>();
+  auto ids = std::vector<int>{0, 3, 4};
+  const auto run = [&ids](Queue& event_queue) {
+    log.clear();
+    event_queue.set_event_dispatcher([](const EventKind, void* const target) {
+      log.push_back(*static_cast<int*>(target));
+    });
+
+    // keyed events at time 10, keyed as of now and as of time 5,
+    // and unkeyed ones scheduled at times 0, 5, and 6
+    auto* const queue = &event_queue;
+    queue->schedule_event(10, EventKind::ChunkArrived, &ids[0], {0, 2, 0});
+    queue->schedule_event(10, []() { log.push_back(1); });
+    queue->schedule_event(10, EventKind::ChunkArrived, &ids[2], {5, 1, 0});
+    queue->schedule_event(10, EventKind::ChunkArrived, &ids[1], {5, 0, 0});
+    queue->schedule_event(5, [queue]() {
+      queue->schedule_event(10, []() { log.push_back(2); });
+    });
+    queue->schedule_event(6, [queue]() {
+      queue->schedule_event(10, []() { log.push_back(5); });
+    });
+
+    while (!event_queue.finished()) {
+      event_queue.proceed();
+    }
+    return log;
+  };
+
+  /// test: keyed events count as scheduled at the time of their keys
+  EXPECT_EQ(run(*this->event_queue), (std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+  /// test: keyed order also orders the events keyed as of now
+  auto keyed_event_queue = Queue();
+  keyed_event_queue.set_keyed_order(true);
+  EXPECT_EQ(run(keyed_event_queue), (std::vector<int>{1, 0, 2, 3, 4, 5}));
+}
@@ -4,9 +4,16 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include "common/NetworkParser.hh"
 #include "common/Type.hh"
+#include "congestion_unaware/FullyConnected.hh"
 #include "congestion_unaware/Helper.hh"
+#include "congestion_unaware/MultiDimTopology.hh"
+#include "congestion_unaware/Ring.hh"
+#include "congestion_unaware/Switch.hh"
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
@@ -69,3 +76,336 @@ TEST_F(TestNetworkAnalyticalCongestionUnaware, Ring_FullyConnected_Switch) {
   const auto comm_delay_dim3 = topology->send(26, 42, chunk_size);
   EXPECT_EQ(comm_delay_dim3, 23'531);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SendBatch) {
+  for (const auto* const network_config :
+       {"../../input/Ring.yml",
+        "../../input/FullyConnected.yml",
+        "../../input/Switch.yml",
+        "../../input/Ring_FullyConnected_Switch.yml"}) {
+    // create network
+    const auto topology = construct_topology(NetworkParser(network_config));
+    const auto npus_count = topology->get_npus_count();
+
+    // queries of every (src, dest) pair, with varying chunk sizes
+    auto srcs = std::vector<DeviceId>();
+    auto dests = std::vector<DeviceId>();
+    auto chunk_sizes = std::vector<ChunkSize>();
+    for (auto src = 0; src < npus_count; src++) {
+      for (auto dest = 0; dest < npus_count; dest++) {
+        if (src != dest) {
+          srcs.push_back(src);
+          dests.push_back(dest);
+          chunk_sizes.push_back(chunk_size * (1 + (src + dest) % 4));
+        }
+      }
+    }
+
+    // run communication in one batch
+    auto delays = std::vector<EventTime>(srcs.size(), 0);
+    topology->send_batch(
+        srcs.data(),
+        dests.data(),
+        chunk_sizes.data(),
+        delays.data(),
+        srcs.size());
+
+    // test: each query matches send()
+    for (auto i = size_t{0}; i < srcs.size(); i++) {
+      EXPECT_EQ(delays[i], topology->send(srcs[i], dests[i], chunk_sizes[i]));
+    }
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, DelayTable) {
+  for (const auto* const network_config :
+       {"../../input/Ring.yml",
+        "../../input/FullyConnected.yml",
+        "../../input/Switch.yml",
+        "../../input/Ring_FullyConnected_Switch.yml"}) {
+    // create network
+    const auto topology = construct_topology(NetworkParser(network_config));
+    const auto npus_count = topology->get_npus_count();
+
+    // test: a MultiDimTopology precomputes the table of every pair,
+    // while a standalone building block builds none
+    const auto& delay_table = topology->get_delay_table();
+    const auto multi_dim = topology->get_dims_count() > 1;
+    EXPECT_EQ(delay_table.empty(), !multi_dim);
+    EXPECT_EQ(
+        delay_table.get_used_bytes(),
+        multi_dim ? npus_count * npus_count * sizeof(uint16_t) : 0);
+
+    // run communication on the table
+    auto delays = std::vector<EventTime>();
+    for (auto src = 0; src < npus_count; src++) {
+      for (auto dest = 0; dest < npus_count; dest++) {
+        if (src != dest) {
+          delays.push_back(topology->send(src, dest, chunk_size));
+        }
+      }
+    }
+
+    // a table not fitting into the cap is dropped
+    topology->set_delay_table_capacity(0);
+    EXPECT_TRUE(delay_table.empty());
+
+    // test: the computed delays match the table
+    auto i = size_t{0};
+    for (auto src = 0; src < npus_count; src++) {
+      for (auto dest = 0; dest < npus_count; dest++) {
+        if (src != dest) {
+          EXPECT_EQ(topology->send(src, dest, chunk_size), delays[i]);
+          i++;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, MultiDimWithoutDelayTable) {
+  // create network without any delay table,
+  // so each send() translates the addresses
+  auto ring = std::make_unique<Ring>(2, 200.0, 50.0);
+  auto fully_connected = std::make_unique<FullyConnected>(8, 100.0, 500.0);
+  auto switch_topology = std::make_unique<Switch>(4, 50.0, 2000.0);
+  ring->set_delay_table_capacity(0);
+  fully_connected->set_delay_table_capacity(0);
+  switch_topology->set_delay_table_capacity(0);
+  auto topology = MultiDimTopology();
+  topology.append_dimension(std::move(ring));
+  topology.append_dimension(std::move(fully_connected));
+  topology.append_dimension(std::move(switch_topology));
+  EXPECT_TRUE(topology.get_delay_table().empty());
+
+  // test: same as Ring_FullyConnected_Switch on each dim
+  EXPECT_EQ(topology.send(0, 1, chunk_size), 4'932);
+  EXPECT_EQ(topology.send(37, 41, chunk_size), 10'265);
+  EXPECT_EQ(topology.send(26, 42, chunk_size), 23'531);
+
+  // test: same as the all-pairs delay table
+  const auto reference = construct_topology(
+      NetworkParser("../../input/Ring_FullyConnected_Switch.yml"));
+  for (auto src = 0; src < 64; src++) {
+    for (auto dest = 0; dest < 64; dest++) {
+      if (src != dest) {
+        EXPECT_EQ(
+            topology.send(src, dest, chunk_size),
+            reference->send(src, dest, chunk_size));
+      }
+    }
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, PathCostModel) {
+  // create network: 2 x 8 x 4 NPUs
+  const auto network_parser =
+      NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  auto* const multi_dim = dynamic_cast<MultiDimTopology*>(topology.get());
+  ASSERT_NE(multi_dim, nullptr);
+  EXPECT_EQ(multi_dim->get_path_cost_model(), PathCostModel::FirstDim);
+
+  // test: 0 -> 63 crosses 1 Ring hop, 1 FC hop, and 2 Switch hops
+  EXPECT_EQ(topology->send(0, 63, chunk_size), 4'932);
+
+  // hops: 50 + 500 + 2 * 2000, each hop serializes 1 MB again
+  multi_dim->set_path_cost_model(PathCostModel::StoreAndForward);
+  EXPECT_EQ(topology->send(0, 63, chunk_size), 58'260);
+
+  // hops: 50 + 500 + 2 * 2000, then 1 MB at 50 GB/s
+  multi_dim->set_path_cost_model(PathCostModel::Pipelined);
+  EXPECT_EQ(topology->send(0, 63, chunk_size), 24'081);
+
+  // test: pairs within a single dim are charged as before
+  EXPECT_EQ(topology->send(0, 1, chunk_size), 4'932);
+  EXPECT_EQ(topology->send(37, 41, chunk_size), 10'265);
+  EXPECT_EQ(topology->send(26, 42, chunk_size), 23'531);
+
+  // test: traffic matrix matches send() of each pair
+  constexpr auto npus_count = 64;
+  for (const auto path_cost_model :
+       {PathCostModel::FirstDim,
+        PathCostModel::StoreAndForward,
+        PathCostModel::Pipelined}) {
+    multi_dim->set_path_cost_model(path_cost_model);
+    auto chunk_sizes = std::vector<ChunkSize>(npus_count * npus_count);
+    auto delays = std::vector<EventTime>(npus_count * npus_count, 1);
+    for (auto i = 0; i < npus_count * npus_count; i++) {
+      chunk_sizes[i] = (i % 7 == 0) ? 0 : chunk_size + i;
+    }
+    multi_dim->send_traffic_matrix(chunk_sizes.data(), delays.data());
+
+    for (auto src = 0; src < npus_count; src++) {
+      for (auto dest = 0; dest < npus_count; dest++) {
+        const auto i = (src * npus_count) + dest;
+        if (src == dest || chunk_sizes[i] == 0) {
+          EXPECT_EQ(delays[i], 0);
+        } else {
+          EXPECT_EQ(delays[i], topology->send(src, dest, chunk_sizes[i]));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, LoadAware) {
+  // create network: 8 NPUs, 50 GB/s, 500 ns
+  auto ring = Ring(8, 50.0, 500.0);
+  EXPECT_FALSE(ring.is_load_aware());
+  EXPECT_EQ(ring.send(0, 2, chunk_size), 20'531);
+
+  // test: idle links add no wait
+  ring.set_utilization_per_dim({0.0});
+  EXPECT_TRUE(ring.is_load_aware());
+  EXPECT_EQ(ring.send(0, 2, chunk_size), 20'531);
+
+  // test: M/D/1 at 50%, each of the 2 hops waits half of 19'531.25 ns
+  ring.set_utilization_per_dim({0.5});
+  EXPECT_EQ(ring.send(0, 2, chunk_size), 40'062);
+
+  // test: saturated links are capped at 99%
+  ring.set_utilization_per_dim({1.5});
+  EXPECT_DOUBLE_EQ(ring.get_utilization_per_dim()[0], 0.99);
+  EXPECT_NEAR(ring.send(0, 2, chunk_size), 1'954'125, 1);
+
+  // test: send_batch() matches send() under load
+  const auto srcs = std::vector<DeviceId>{0, 3, 7};
+  const auto dests = std::vector<DeviceId>{2, 4, 1};
+  const auto chunk_sizes = std::vector<ChunkSize>{chunk_size, 1, 12'345};
+  auto delays = std::vector<EventTime>(3);
+  ring.send_batch(
+      srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), 3);
+  for (auto i = 0; i < 3; i++) {
+    EXPECT_EQ(delays[i], ring.send(srcs[i], dests[i], chunk_sizes[i]));
+  }
+
+  // test: every NPU sends 1 MB to its neighbor over 78'125 ns:
+  // 8 MB over 16 links of 50 GB/s
+  auto traffic_matrix = std::vector<ChunkSize>(8 * 8, 0);
+  for (auto src = 0; src < 8; src++) {
+    traffic_matrix[(src * 8) + ((src + 1) % 8)] = chunk_size;
+  }
+  ring.set_traffic_matrix(traffic_matrix.data(), 78'125);
+  EXPECT_DOUBLE_EQ(ring.get_utilization_per_dim()[0], 0.125);
+
+  // test: back to the congestion-unaware delay
+  ring.clear_utilization();
+  EXPECT_FALSE(ring.is_load_aware());
+  EXPECT_EQ(ring.send(0, 2, chunk_size), 20'531);
+
+  // create network: 2 x 8 x 4 NPUs, Ring and Switch loaded at 50%
+  const auto network_parser =
+      NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  auto* const multi_dim = dynamic_cast<MultiDimTopology*>(topology.get());
+  ASSERT_NE(multi_dim, nullptr);
+  topology->set_utilization_per_dim({0.5, 0.0, 0.5});
+
+  // test: each dim waits by its own utilization
+  EXPECT_EQ(topology->send(0, 1, chunk_size), 7'374);
+  EXPECT_EQ(topology->send(37, 41, chunk_size), 10'265);
+  EXPECT_EQ(topology->send(26, 42, chunk_size), 43'062);
+
+  // test: every hop of the path waits
+  multi_dim->set_path_cost_model(PathCostModel::StoreAndForward);
+  EXPECT_EQ(topology->send(0, 63, chunk_size), 80'233);
+
+  // test: send_batch() matches send() under load
+  for (const auto path_cost_model :
+       {PathCostModel::FirstDim, PathCostModel::StoreAndForward}) {
+    multi_dim->set_path_cost_model(path_cost_model);
+    auto multi_dim_srcs = std::vector<DeviceId>();
+    auto multi_dim_dests = std::vector<DeviceId>();
+    auto multi_dim_chunk_sizes = std::vector<ChunkSize>();
+    for (auto src = 0; src < 64; src++) {
+      multi_dim_srcs.push_back(src);
+      multi_dim_dests.push_back((src * 7 + 5) % 64);
+      multi_dim_chunk_sizes.push_back(chunk_size + src);
+    }
+    auto multi_dim_delays = std::vector<EventTime>(64);
+    topology->send_batch(
+        multi_dim_srcs.data(),
+        multi_dim_dests.data(),
+        multi_dim_chunk_sizes.data(),
+        multi_dim_delays.data(),
+        64);
+    for (auto i = 0; i < 64; i++) {
+      if (multi_dim_srcs[i] != multi_dim_dests[i]) {
+        EXPECT_EQ(
+            multi_dim_delays[i],
+            topology->send(
+                multi_dim_srcs[i],
+                multi_dim_dests[i],
+                multi_dim_chunk_sizes[i]));
+      }
+    }
+  }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, CollectiveTime) {
+  // create network
+  const auto ring = construct_topology(NetworkParser("../../input/Ring.yml"));
+  const auto fully_connected =
+      construct_topology(NetworkParser("../../input/FullyConnected.yml"));
+  const auto collective_size = 16 * chunk_size;
+
+  // Ring sends 1 MB to its neighbor in each of the 30 steps
+  const auto ring_all_reduce =
+      ring->collective_time(CollectiveType::AllReduce, collective_size);
+  EXPECT_EQ(ring_all_reduce, 30 * 20'031);
+
+  // Direct sends 1 MB to every other NPU in 2 steps
+  const auto direct_all_reduce = fully_connected->collective_time(
+      CollectiveType::AllReduce, collective_size);
+  EXPECT_EQ(direct_all_reduce, 2 * 20'031);
+
+  // HalvingDoubling sends 8, 4, 2, 1, 1, 2, 4, 8 MB in 8 steps
+  const auto halving_doubling_all_reduce = fully_connected->collective_time(
+      CollectiveType::AllReduce,
+      collective_size,
+      {CollectiveAlgorithm::HalvingDoubling});
+  EXPECT_EQ(
+      halving_doubling_all_reduce, 2 * (156'750 + 78'625 + 39'562 + 20'031));
+
+  // equals the longest send of each step: pairwise All-to-All on Ring
+  auto all_to_all = EventTime{0};
+  for (auto distance = 1; distance < 16; distance++) {
+    all_to_all += ring->send(0, distance, chunk_size);
+  }
+  const auto ring_all_to_all = ring->collective_time(
+      CollectiveType::AllToAll, collective_size, {CollectiveAlgorithm::Ring});
+  EXPECT_EQ(ring_all_to_all, all_to_all);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, HierarchicalCollectiveTime) {
+  // create network: 2 x 8 x 4 NPUs
+  const auto network_parser =
+      NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+  const auto topology = construct_topology(network_parser);
+  const auto collective_size = 64 * chunk_size;
+
+  // Ring, Direct, and Direct within each dimension:
+  // 32 MB over the ring, 4 MB to each of 7 NPUs,
+  // then 1 MB to each of 3 NPUs through the switch
+  const auto reduce_scatter =
+      topology->collective_time(CollectiveType::ReduceScatter, collective_size);
+  EXPECT_EQ(reduce_scatter, 156'300 + 39'562 + 23'531);
+
+  // All-Gather mirrors Reduce-Scatter
+  const auto all_gather =
+      topology->collective_time(CollectiveType::AllGather, collective_size);
+  const auto all_reduce =
+      topology->collective_time(CollectiveType::AllReduce, collective_size);
+  EXPECT_EQ(all_gather, reduce_scatter);
+  EXPECT_EQ(all_reduce, reduce_scatter + all_gather);
+
+  // Broadcast forwards 1 MB over 1 + 3 + 2 steps
+  const auto broadcast = topology->collective_time(
+      CollectiveType::Broadcast,
+      chunk_size,
+      {CollectiveAlgorithm::HalvingDoubling,
+       CollectiveAlgorithm::HalvingDoubling,
+       CollectiveAlgorithm::HalvingDoubling});
+  EXPECT_EQ(broadcast, 4'932 + (3 * 10'265) + (2 * 23'531));
+}